@@ -0,0 +1,57 @@
+/*
+Example 10 - Static Configuration
+
+This example shows how to fix the OPT4048 configuration at compile time.
+The register images are computed by the compiler and written with a single
+burst in begin(), so setBasicSetup() and the other runtime setters are not
+needed and are left out of the binary.
+
+Written by SparkFun Electronics, October 2026
+
+Products:
+    Qwiic 1x1: https://www.sparkfun.com/products/22638
+    Qwiic Mini: https://www.sparkfun.com/products/22639
+
+Repository:
+    https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+SparkFun code, firmware, and software is released under the MIT 
+License	(http://opensource.org/licenses/MIT).
+*/
+
+#include "SparkFun_OPT4048.h"
+#include <Wire.h>
+
+// Auto range, 100ms per channel, continuous conversions.
+typedef SparkFun_OPT4048Static<RANGE_AUTO, CONVERSION_TIME_100MS, OPERATION_MODE_CONTINUOUS> ColorSensor;
+
+ColorSensor myColor;
+
+void setup()
+{
+    Serial.begin(115200);
+    Serial.println("OPT4048 Example 10 Static Configuration.");
+
+    Wire.begin();
+
+    if (!myColor.begin()) {
+        Serial.println("OPT4048 not detected- check wiring or that your I2C address is correct!");
+        while (1) ;
+    }
+
+    Serial.print("CONTROL: 0x");
+    Serial.println(ColorSensor::kControl, HEX);
+    Serial.print("INT_CONTROL: 0x");
+    Serial.println(ColorSensor::kIntControl, HEX);
+
+    Serial.println("Ready to go!");
+}
+
+
+void loop()
+{
+    Serial.print("Lux:");
+    Serial.println(myColor.getLux());
+    // A full set of channels takes four conversion times, known at compile time.
+    myColor.waitForSample(ColorSensor::kSamplePeriodUs / 1000 * 2);
+}
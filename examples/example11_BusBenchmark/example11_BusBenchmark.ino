@@ -0,0 +1,99 @@
+/*
+Example 11 - Bus Benchmark
+
+This example compares the time to read all four channels through the
+default driver, which reaches the I2C bus through the virtual QwDeviceBus
+interface, with SparkFun_OPT4048Direct, the same driver with the bus bound
+at compile time.
+
+The sketch reports the average time per read for each path. Most of a read
+is the I2C transfer of 16 bytes, which is the same for both. To compare flash
+use, build once with BENCH_MODE set to 1 and once with it set to 2 and
+compare the "Sketch uses" line reported by the IDE, or run
+extras/opt4048_size/size_report.sh. Both builds make the same calls.
+
+Written by SparkFun Electronics, October 2026
+
+Products:
+    Qwiic 1x1: https://www.sparkfun.com/products/22638
+    Qwiic Mini: https://www.sparkfun.com/products/22639
+
+Repository:
+    https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+SparkFun code, firmware, and software is released under the MIT 
+License	(http://opensource.org/licenses/MIT).
+*/
+
+#include "SparkFun_OPT4048.h"
+#include <Wire.h>
+
+// 0 = time both paths, 1 = virtual bus only, 2 = direct bus only.
+#ifndef BENCH_MODE
+#define BENCH_MODE 0
+#endif
+
+#define NUM_READS 200
+
+typedef QwOpt4048Static<RANGE_36LUX, CONVERSION_TIME_200MS, OPERATION_MODE_CONTINUOUS> BenchConfig;
+
+#if BENCH_MODE != 2
+SparkFun_OPT4048 myColor;
+#endif
+#if BENCH_MODE != 1
+SparkFun_OPT4048Direct myColorDirect;
+#endif
+
+template <class T> void benchmark(T &sensor, const char *name)
+{
+    sfe_color_t color;
+    uint32_t start;
+    uint32_t elapsed;
+
+    start = micros();
+    for (int i = 0; i < NUM_READS; i++)
+        sensor.getAllChannelData(&color);
+    elapsed = micros() - start;
+
+    Serial.print(name);
+    Serial.print(": ");
+    Serial.print((float)elapsed / NUM_READS);
+    Serial.println(" us per read");
+}
+
+void setup()
+{
+    Serial.begin(115200);
+    Serial.println("OPT4048 Example 11 Bus Benchmark.");
+
+    Wire.begin();
+    Wire.setClock(400000);
+
+#if BENCH_MODE != 2
+    if (!myColor.begin() || !myColor.fastStart(BenchConfig::kControl, BenchConfig::kIntControl)) {
+        Serial.println("OPT4048 not detected- check wiring or that your I2C address is correct!");
+        while (1) ;
+    }
+#endif
+#if BENCH_MODE != 1
+    if (!myColorDirect.begin() || !myColorDirect.fastStart(BenchConfig::kControl, BenchConfig::kIntControl)) {
+        Serial.println("OPT4048 not detected- check wiring or that your I2C address is correct!");
+        while (1) ;
+    }
+#endif
+
+    Serial.println("Ready to go!");
+}
+
+
+void loop()
+{
+#if BENCH_MODE != 2
+    benchmark(myColor, "Virtual bus");
+#endif
+#if BENCH_MODE != 1
+    benchmark(myColorDirect, "Direct bus ");
+#endif
+
+    delay(2000);
+}
@@ -0,0 +1,106 @@
+/*
+Example 12 - Event Callbacks
+
+This example registers handlers for new samples and for the light level
+leaving a window. The INT pin only marks the event as pending; loop() then
+services it with a single read that returns both the flags and the sample,
+so the handlers don't need to touch the bus.
+
+Connect the INT pin of the OPT4048 to an interrupt capable pin.
+
+Written by SparkFun Electronics, October 2026
+
+Products:
+    Qwiic 1x1: https://www.sparkfun.com/products/22638
+    Qwiic Mini: https://www.sparkfun.com/products/22639
+
+Repository:
+    https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+SparkFun code, firmware, and software is released under the MIT 
+License	(http://opensource.org/licenses/MIT).
+*/
+
+#include "SparkFun_OPT4048.h"
+#include <Wire.h>
+
+SparkFun_OPT4048 myColor;
+QwOpt4048Events myEvents;
+
+int interruptPin = 3;
+
+void onINT()
+{
+    // No I2C from the ISR; just mark the event.
+    myEvents.notify();
+}
+
+void newSample(const sfe_color_t *color)
+{
+    sfe_cie_t cie;
+
+    myColor.calculateCIE(color, &cie);
+
+    Serial.print("CIEx: ");
+    Serial.print(cie.CIEx);
+    Serial.print(" CIEy: ");
+    Serial.print(cie.CIEy);
+    Serial.print(" Lux: ");
+    Serial.println(cie.lux);
+}
+
+void tooBright(const sfe_color_t *color)
+{
+    Serial.println("Too bright!");
+}
+
+void tooDim(const sfe_color_t *color)
+{
+    Serial.println("Too dim!");
+}
+
+void overload(const sfe_color_t *color)
+{
+    Serial.println("Overload!");
+}
+
+void setup()
+{
+    Serial.begin(115200);
+    Serial.println("OPT4048 Example 12 - Event Callbacks.");
+
+    pinMode(interruptPin, INPUT_PULLUP);
+
+    Wire.begin();
+
+    if (!myColor.begin()) {
+        Serial.println("OPT4048 not detected- check wiring or that your I2C address is correct!");
+        while (1) ;
+    }
+
+    myColor.setBasicSetup();
+
+    // Latched, active low interrupt after every full sample. The window flags are
+    // compared on Channel One, which carries the lux reading.
+    myColor.setIntLatch();
+    myColor.setIntMechanism(INT_DR_ALL_CHANNELS);
+    myColor.setThresholdChannel(THRESH_CHANNEL_CH1);
+    myColor.setThresholdLow(50);
+    myColor.setThresholdHigh(2000);
+
+    myEvents.begin(myColor);
+    myEvents.onSample(newSample);
+    myEvents.onTooBright(tooBright);
+    myEvents.onTooDim(tooDim);
+    myEvents.onOverload(overload);
+
+    attachInterrupt(digitalPinToInterrupt(interruptPin), onINT, FALLING);
+
+    Serial.println("Ready to go!");
+}
+
+
+void loop()
+{
+    myEvents.service();
+}
@@ -0,0 +1,95 @@
+/*
+Example 13 - Synchronized Capture
+
+This example takes simultaneous samples from two OPT4048 sensors, e.g. to
+measure a light source from two angles. The INT pins of both sensors are
+wired together to one GPIO; a single edge on that line starts a one-shot
+conversion on both sensors at the same instant. Each result carries the
+shared trigger timestamp.
+
+Wiring: sensor A at the default address 0x44, sensor B with its ADDR pin
+tied to VDD (0x45). Both INT pins to triggerPin.
+
+Written by SparkFun Electronics, October 2026
+
+Products:
+    Qwiic 1x1: https://www.sparkfun.com/products/22638
+    Qwiic Mini: https://www.sparkfun.com/products/22639
+
+Repository:
+    https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+SparkFun code, firmware, and software is released under the MIT 
+License	(http://opensource.org/licenses/MIT).
+*/
+
+#include "SparkFun_OPT4048.h"
+#include <Wire.h>
+
+SparkFun_OPT4048 sensorA;
+SparkFun_OPT4048 sensorB;
+QwOpt4048SyncGroup group;
+
+sfe_opt4048_sync_sample_t samples[2];
+
+int triggerPin = 3;
+
+void setup()
+{
+    Serial.begin(115200);
+    Serial.println("OPT4048 Example 13 - Synchronized Capture.");
+
+    Wire.begin();
+
+    if (!sensorA.begin(OPT4048_ADDR_LOW) || !sensorB.begin(OPT4048_ADDR_HIGH)) {
+        Serial.println("OPT4048 not detected- check wiring or that your I2C address is correct!");
+        while (1) ;
+    }
+
+    sensorA.setRange(RANGE_AUTO);
+    sensorA.setConversionTime(CONVERSION_TIME_25MS);
+    sensorB.setRange(RANGE_AUTO);
+    sensorB.setConversionTime(CONVERSION_TIME_25MS);
+
+    group.addSensor(sensorA);
+    group.addSensor(sensorB);
+
+    if (!group.begin(triggerPin)) {
+        Serial.println("Could not configure the INT pins as trigger inputs.");
+        while (1) ;
+    }
+
+    Serial.println("Ready to go!");
+}
+
+
+void loop()
+{
+    sfe_cie_t cie;
+
+    group.capture(samples);
+
+    Serial.print("Trigger at ");
+    Serial.print(group.getTriggerMicros());
+    Serial.println("us");
+
+    for (int i = 0; i < 2; i++)
+    {
+        Serial.print(i == 0 ? " A: " : " B: ");
+
+        if (!samples[i].valid) {
+            Serial.println("no sample");
+            continue;
+        }
+
+        sensorA.calculateCIE(&samples[i].color, &cie);
+        Serial.print("CIEx: ");
+        Serial.print(cie.CIEx, 4);
+        Serial.print(" CIEy: ");
+        Serial.print(cie.CIEy, 4);
+        Serial.print(" Lux: ");
+        Serial.println(cie.lux);
+    }
+
+    delay(500);
+}
@@ -0,0 +1,88 @@
+/*
+Example 14 - Channel Streaming
+
+This example streams the OPT4048 one channel at a time. The INT pin asserts
+each time a channel finishes converting, and each interrupt reads only the
+4 bytes of that channel instead of all 16. The library assembles complete
+Red, Green, Blue, and White sets and uses the sample counters to check
+that no channel was skipped.
+
+Connect the INT pin of the OPT4048 to an interrupt capable pin.
+
+Written by SparkFun Electronics, October 2026
+
+Products:
+    Qwiic 1x1: https://www.sparkfun.com/products/22638
+    Qwiic Mini: https://www.sparkfun.com/products/22639
+
+Repository:
+    https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+SparkFun code, firmware, and software is released under the MIT 
+License	(http://opensource.org/licenses/MIT).
+*/
+
+#include "SparkFun_OPT4048.h"
+#include <Wire.h>
+
+SparkFun_OPT4048 myColor;
+QwOpt4048Stream myStream;
+
+int interruptPin = 3;
+
+void onINT()
+{
+    // No I2C from the ISR; just mark the channel as done.
+    myStream.notify();
+}
+
+void setup()
+{
+    Serial.begin(115200);
+    Serial.println("OPT4048 Example 14 - Channel Streaming.");
+
+    pinMode(interruptPin, INPUT_PULLUP);
+
+    Wire.begin();
+
+    if (!myColor.begin()) {
+        Serial.println("OPT4048 not detected- check wiring or that your I2C address is correct!");
+        while (1) ;
+    }
+
+    myColor.setRange(RANGE_AUTO);
+    myColor.setConversionTime(CONVERSION_TIME_25MS);
+
+    if (!myStream.begin(myColor)) {
+        Serial.println("Could not start streaming.");
+        while (1) ;
+    }
+
+    attachInterrupt(digitalPinToInterrupt(interruptPin), onINT, FALLING);
+
+    Serial.println("Ready to go!");
+}
+
+
+void loop()
+{
+    sfe_color_t color;
+
+    if (!myStream.service())
+        return;
+
+    myStream.getSample(&color);
+
+    Serial.print("R: ");
+    Serial.print(color.red);
+    Serial.print(" G: ");
+    Serial.print(color.green);
+    Serial.print(" B: ");
+    Serial.print(color.blue);
+    Serial.print(" W: ");
+    Serial.print(color.white);
+    Serial.print(" Missed sets: ");
+    Serial.print(myStream.getMissedSets());
+    Serial.print(" Sync errors: ");
+    Serial.println(myStream.getSyncErrors());
+}
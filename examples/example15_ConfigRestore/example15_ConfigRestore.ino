@@ -0,0 +1,78 @@
+/*
+Example 15 - Configuration Restore
+
+This example captures the sensor configuration (thresholds, CONTROL, and
+INT_CONTROL) into a 12 byte image, stores it in EEPROM, and restores it with
+a single burst write whenever the sensor comes back from a power glitch with
+its default registers. On the next boot the image is loaded from EEPROM, so
+none of the setters need to run again.
+
+Written by SparkFun Electronics, October 2026
+
+Products:
+    Qwiic 1x1: https://www.sparkfun.com/products/22638
+    Qwiic Mini: https://www.sparkfun.com/products/22639
+
+Repository:
+    https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+SparkFun code, firmware, and software is released under the MIT 
+License	(http://opensource.org/licenses/MIT).
+*/
+
+#include "SparkFun_OPT4048.h"
+#include <EEPROM.h>
+#include <Wire.h>
+
+SparkFun_OPT4048 myColor;
+sfe_opt4048_config_t myConfig;
+
+// Where the image lives in EEPROM.
+int configAddress = 0;
+
+void setup()
+{
+    Serial.begin(115200);
+    Serial.println("OPT4048 Example 15 - Configuration Restore.");
+
+    Wire.begin();
+
+    if (!myColor.begin()) {
+        Serial.println("OPT4048 not detected- check wiring or that your I2C address is correct!");
+        while (1) ;
+    }
+
+    // ESP32 and ESP8266 emulate EEPROM in flash and also need EEPROM.begin() and EEPROM.commit().
+    EEPROM.get(configAddress, myConfig);
+
+    if (myColor.restoreConfiguration(&myConfig)) {
+        Serial.println("Configuration restored from EEPROM.");
+    }
+    else {
+        // Nothing valid stored yet: configure with the setters once and save the result.
+        myColor.setBasicSetup();
+        myColor.setThresholdLow(50);
+        myColor.setThresholdHigh(2000);
+
+        myColor.saveConfiguration(&myConfig);
+        EEPROM.put(configAddress, myConfig);
+        Serial.println("Configuration saved to EEPROM.");
+    }
+
+    Serial.println("Ready to go!");
+}
+
+
+void loop()
+{
+    // One 4 byte read detects a sensor that lost its settings; one 8 byte write restores them.
+    if (myColor.wasReset(&myConfig)) {
+        Serial.println("Sensor was reset, restoring configuration.");
+        myColor.restoreConfiguration(&myConfig);
+    }
+
+    if (myColor.waitForSample()) {
+        Serial.print("Lux:");
+        Serial.println(myColor.getLux());
+    }
+}
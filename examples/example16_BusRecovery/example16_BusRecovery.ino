@@ -0,0 +1,78 @@
+/*
+Example 16 - Bus Recovery
+
+This example protects the OPT4048 against a hung I2C bus. When transfers
+keep failing or a glitch leaves SDA held low, the bus is cleared with nine
+SCL clocks and a STOP, the device ID is probed again, and the saved
+configuration is restored - all within a time budget. Recovery counts and
+times are printed so they can be monitored.
+
+The recovery layer forwards to the sensor's own bus, so bus settings such as
+the 400kHz clock set here are kept through a recovery.
+
+Written by SparkFun Electronics, October 2026
+
+Products:
+    Qwiic 1x1: https://www.sparkfun.com/products/22638
+    Qwiic Mini: https://www.sparkfun.com/products/22639
+
+Repository:
+    https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+SparkFun code, firmware, and software is released under the MIT 
+License	(http://opensource.org/licenses/MIT).
+*/
+
+#include "SparkFun_OPT4048.h"
+#include <Wire.h>
+
+SparkFun_OPT4048 myColor;
+QwOpt4048Recovery myRecovery;
+
+void setup()
+{
+    Serial.begin(115200);
+    Serial.println("OPT4048 Example 16 - Bus Recovery.");
+
+    Wire.begin();
+
+    if (!myColor.begin()) {
+        Serial.println("OPT4048 not detected- check wiring or that your I2C address is correct!");
+        while (1) ;
+    }
+
+    myColor.setBasicSetup();
+    myColor.setBusClock(400000);
+
+    // SDA and SCL are the pins of the default Wire port on most boards.
+    myRecovery.begin(myColor, *myColor.getCommunicationBus(), Wire, SDA, SCL);
+    myRecovery.setTimeBudget(5000);
+    myRecovery.setErrorThreshold(3);
+    myRecovery.saveConfiguration();
+
+    Serial.println("Ready to go!");
+}
+
+
+void loop()
+{
+    if (!myRecovery.service()) {
+        Serial.println("Recovery failed, retrying.");
+        delay(100);
+        return;
+    }
+
+    if (myColor.waitForSample()) {
+        Serial.print("Lux: ");
+        Serial.print(myColor.getLux());
+        Serial.print(" Bus errors: ");
+        Serial.print(myRecovery.getBusErrors());
+        Serial.print(" Recoveries: ");
+        Serial.print(myRecovery.getRecoverySuccesses());
+        Serial.print("/");
+        Serial.print(myRecovery.getRecoveryAttempts());
+        Serial.print(" Max recovery: ");
+        Serial.print(myRecovery.getMaxRecoveryUs());
+        Serial.println("us");
+    }
+}
@@ -0,0 +1,108 @@
+/*
+Example 17 - Fast Start
+
+This example measures the time from start-up to the first valid sample. The
+standard path (begin(), the setters, and a wait for the sample) is compared
+with beginFast(), which writes the whole configuration in one burst and
+returns the time the first sample will be ready. Nodes that wake from deep
+sleep pay this cost on every cycle.
+
+The sensor is powered down between runs so each run starts from idle.
+
+Written by SparkFun Electronics, October 2026
+
+Products:
+    Qwiic 1x1: https://www.sparkfun.com/products/22638
+    Qwiic Mini: https://www.sparkfun.com/products/22639
+
+Repository:
+    https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+SparkFun code, firmware, and software is released under the MIT 
+License	(http://opensource.org/licenses/MIT).
+*/
+
+#include "SparkFun_OPT4048.h"
+#include <Wire.h>
+
+// Auto range, 1ms per channel, a single set of conversions per start.
+typedef QwOpt4048Static<RANGE_AUTO, CONVERSION_TIME_1MS, OPERATION_MODE_AUTO_ONE_SHOT> FastConfig;
+
+SparkFun_OPT4048 myColor;
+
+uint32_t standardStart()
+{
+    uint32_t start = micros();
+
+    if (!myColor.begin())
+        return 0;
+
+    myColor.setRange(RANGE_AUTO);
+    myColor.setConversionTime(CONVERSION_TIME_1MS);
+    myColor.setOperationMode(OPERATION_MODE_AUTO_ONE_SHOT);
+
+    if (!myColor.waitForSample(100))
+        return 0;
+
+    myColor.getLux();
+
+    return micros() - start;
+}
+
+uint32_t fastStart(bool verify)
+{
+    uint32_t start = micros();
+    uint32_t readyAt;
+
+    if (!myColor.beginFast(FastConfig::kControl, FastConfig::kIntControl, &readyAt, verify))
+        return 0;
+
+    // Free to do other work until readyAt; here we just wait for it.
+    if (!myColor.waitForSample(100))
+        return 0;
+
+    myColor.getLux();
+
+    return micros() - start;
+}
+
+void printResult(const char *name, uint32_t us)
+{
+    Serial.print(name);
+
+    if (us == 0)
+        Serial.println("failed");
+    else {
+        Serial.print(us);
+        Serial.println("us");
+    }
+}
+
+void setup()
+{
+    Serial.begin(115200);
+    Serial.println("OPT4048 Example 17 - Fast Start.");
+
+    Wire.begin();
+    Wire.setClock(400000);
+
+    Serial.println("Ready to go!");
+}
+
+
+void loop()
+{
+    printResult("Standard start to first sample:   ", standardStart());
+    myColor.setOperationMode(OPERATION_MODE_POWER_DOWN);
+    delay(10);
+
+    printResult("Fast start (verified) to sample:  ", fastStart(true));
+    myColor.setOperationMode(OPERATION_MODE_POWER_DOWN);
+    delay(10);
+
+    printResult("Fast start (unverified) to sample:", fastStart(false));
+    myColor.setOperationMode(OPERATION_MODE_POWER_DOWN);
+
+    Serial.println();
+    delay(2000);
+}
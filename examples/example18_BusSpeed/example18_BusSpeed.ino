@@ -0,0 +1,100 @@
+/*
+Example 18 - Bus Speed
+
+This example finds the fastest I2C speed each sensor on a shared bus answers
+at. Hs-mode (3.4MHz) is tried first, then Fast-mode Plus (1MHz), Fast-mode
+(400kHz), and Standard-mode (100kHz). Each sensor keeps its own speed, so a
+slow device elsewhere on the bus doesn't hold the others back. After each
+transfer the port returns to its default clock, 100kHz unless set with
+sfe_OPT4048::QwI2CDirect::setDefaultClock(), so other devices are never
+clocked faster than they expect. The time taken by a full channel read is
+printed for each sensor.
+
+Hs-mode only works on controllers that can clock at Hs rates and keep the
+bus after the master code; on others the negotiation falls back to a slower
+speed.
+
+Written by SparkFun Electronics, October 2026
+
+Products:
+    Qwiic 1x1: https://www.sparkfun.com/products/22638
+    Qwiic Mini: https://www.sparkfun.com/products/22639
+
+Repository:
+    https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+SparkFun code, firmware, and software is released under the MIT 
+License	(http://opensource.org/licenses/MIT).
+*/
+
+#include "SparkFun_OPT4048.h"
+#include <Wire.h>
+
+#define HS_CLOCK_HZ 3400000
+
+SparkFun_OPT4048 sensorA;
+SparkFun_OPT4048 sensorB;
+
+void setupSensor(SparkFun_OPT4048 &sensor, uint8_t address)
+{
+    Serial.print("Sensor 0x");
+    Serial.print(address, HEX);
+
+    if (!sensor.begin(address))
+    {
+        Serial.println(" not found.");
+        return;
+    }
+
+    uint32_t clockHz = sensor.negotiateBusSpeed(HS_CLOCK_HZ);
+
+    Serial.print(" runs at ");
+    Serial.print(clockHz);
+    Serial.println("Hz");
+
+    sensor.setBasicSetup();
+}
+
+void timeRead(SparkFun_OPT4048 &sensor, const char *name)
+{
+    sfe_color_t color;
+
+    uint32_t start = micros();
+    bool success = sensor.getAllChannelData(&color);
+    uint32_t elapsed = micros() - start;
+
+    if (!success)
+    {
+        Serial.print(name);
+        Serial.println(" read failed.");
+        return;
+    }
+
+    Serial.print(name);
+    Serial.print(" read in ");
+    Serial.print(elapsed);
+    Serial.print("us, white: ");
+    Serial.println(color.white);
+}
+
+void setup()
+{
+    Serial.begin(115200);
+    Serial.println("OPT4048 Example 18 - Bus Speed.");
+
+    Wire.begin();
+
+    setupSensor(sensorA, OPT4048_ADDR_LOW);
+    setupSensor(sensorB, OPT4048_ADDR_HIGH);
+
+    Serial.println("Ready to go!");
+}
+
+
+void loop()
+{
+    timeRead(sensorA, "Sensor A");
+    timeRead(sensorB, "Sensor B");
+
+    delay(1000);
+}
@@ -0,0 +1,122 @@
+/*
+Example 19 - Alert Response
+
+This example watches two OPT4048 sensors that share one I2C bus and one
+ALERT line: wire both INT pins together to the interrupt pin. The sensors
+run in SMBus alert mode and assert ALERT when the light leaves a window. On
+an alert, one query of the SMBus Alert Response Address tells which sensor
+it was, and only that sensor is read, instead of reading the flags of every
+sensor on the line.
+
+Written by SparkFun Electronics, October 2026
+
+Products:
+    Qwiic 1x1: https://www.sparkfun.com/products/22638
+    Qwiic Mini: https://www.sparkfun.com/products/22639
+
+Repository:
+    https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+SparkFun code, firmware, and software is released under the MIT 
+License	(http://opensource.org/licenses/MIT).
+*/
+
+#include "SparkFun_OPT4048.h"
+#include <Wire.h>
+
+SparkFun_OPT4048 sensorA;
+SparkFun_OPT4048 sensorB;
+QwOpt4048Events eventsA;
+QwOpt4048Events eventsB;
+QwOpt4048AlertGroup alertGroup;
+
+int alertPin = 3;
+
+void onALERT()
+{
+    // No I2C from the ISR; just mark the alert.
+    alertGroup.notify();
+}
+
+void printLux(const char *message, const sfe_color_t *color)
+{
+    sfe_cie_t cie;
+
+    sensorA.calculateCIE(color, &cie);
+
+    Serial.print(message);
+    Serial.print(" Lux: ");
+    Serial.println(cie.lux);
+}
+
+void brightA(const sfe_color_t *color)
+{
+    printLux("Sensor A too bright!", color);
+}
+
+void dimA(const sfe_color_t *color)
+{
+    printLux("Sensor A too dim!", color);
+}
+
+void brightB(const sfe_color_t *color)
+{
+    printLux("Sensor B too bright!", color);
+}
+
+void dimB(const sfe_color_t *color)
+{
+    printLux("Sensor B too dim!", color);
+}
+
+void setupSensor(SparkFun_OPT4048 &sensor, uint8_t address)
+{
+    if (!sensor.begin(address)) {
+        Serial.println("OPT4048 not detected- check wiring or that your I2C address is correct!");
+        while (1) ;
+    }
+
+    sensor.setBasicSetup();
+
+    // The window is compared on Channel One, which carries the lux reading.
+    sensor.setThresholdChannel(THRESH_CHANNEL_CH1);
+    sensor.setThresholdLow(50);
+    sensor.setThresholdHigh(2000);
+}
+
+void setup()
+{
+    Serial.begin(115200);
+    Serial.println("OPT4048 Example 19 - Alert Response.");
+
+    pinMode(alertPin, INPUT_PULLUP);
+
+    Wire.begin();
+
+    setupSensor(sensorA, OPT4048_ADDR_LOW);
+    setupSensor(sensorB, OPT4048_ADDR_HIGH);
+
+    eventsA.begin(sensorA);
+    eventsA.onTooBright(brightA);
+    eventsA.onTooDim(dimA);
+
+    eventsB.begin(sensorB);
+    eventsB.onTooBright(brightB);
+    eventsB.onTooDim(dimB);
+
+    alertGroup.addSensor(eventsA);
+    alertGroup.addSensor(eventsB);
+
+    // Passing the pin lets the group stop as soon as ALERT is released.
+    alertGroup.begin(alertPin);
+
+    attachInterrupt(digitalPinToInterrupt(alertPin), onALERT, FALLING);
+
+    Serial.println("Ready to go!");
+}
+
+
+void loop()
+{
+    alertGroup.service();
+}
@@ -43,11 +43,13 @@ void setup()
 
 void loop()
 {
+    // Sleeps until the next full sample of all channels is predicted to be ready, then confirms it
+    // with a single read of the conversion ready flag.
+    if (!myColor.waitForSample())
+        return;
+
     Serial.print("CIEx: ");
     Serial.print(myColor.getCIEx());
     Serial.print(" CIEy: ");
     Serial.println(myColor.getCIEy());
-    // Delay time is set to the conversion time * number of channels
-    // You need three channels for color sensing @ 200ms conversion time = 600ms.
-    delay(200);
 }
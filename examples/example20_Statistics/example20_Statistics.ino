@@ -0,0 +1,100 @@
+/*
+Example 20 - Statistics
+
+This example measures the mean and noise of every channel of a steady light,
+as done when testing light fixtures. Each sample is added to a statistics
+accumulator, which keeps count, mean, standard deviation, minimum, and
+maximum in constant memory however many samples are taken. Every window is
+also merged into a running total for the whole session.
+
+Written by SparkFun Electronics, October 2026
+
+Products:
+    Qwiic 1x1: https://www.sparkfun.com/products/22638
+    Qwiic Mini: https://www.sparkfun.com/products/22639
+
+Repository:
+    https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+SparkFun code, firmware, and software is released under the MIT 
+License	(http://opensource.org/licenses/MIT).
+*/
+
+#include "SparkFun_OPT4048.h"
+#include <Wire.h>
+
+// Samples per printed window.
+#define WINDOW_SAMPLES 1000
+
+SparkFun_OPT4048 myColor;
+QwOpt4048Stats window;
+QwOpt4048Stats session;
+
+void printStat(const char *name, QwOpt4048Stats &stats, opt4048_stat_t stat)
+{
+    Serial.print(name);
+    Serial.print(" mean: ");
+    Serial.print(stats.getMean(stat), 4);
+    Serial.print(" sd: ");
+    Serial.print(stats.getStdDev(stat), 4);
+    Serial.print(" min: ");
+    Serial.print(stats.getMin(stat), 4);
+    Serial.print(" max: ");
+    Serial.println(stats.getMax(stat), 4);
+}
+
+void printStats(QwOpt4048Stats &stats)
+{
+    Serial.print("Samples: ");
+    Serial.println(stats.getCount());
+
+    printStat("Red  ", stats, STAT_RED);
+    printStat("Green", stats, STAT_GREEN);
+    printStat("Blue ", stats, STAT_BLUE);
+    printStat("White", stats, STAT_WHITE);
+    printStat("Lux  ", stats, STAT_LUX);
+    printStat("CIEx ", stats, STAT_CIEX);
+    printStat("CIEy ", stats, STAT_CIEY);
+}
+
+void setup()
+{
+    Serial.begin(115200);
+    Serial.println("OPT4048 Example 20 - Statistics.");
+
+    Wire.begin();
+
+    if (!myColor.begin()) {
+        Serial.println("OPT4048 not detected- check wiring or that your I2C address is correct!");
+        while (1) ;
+    }
+
+    myColor.setBasicSetup();
+    myColor.setConversionTime(CONVERSION_TIME_1MS);
+
+    Serial.println("Ready to go!");
+}
+
+
+void loop()
+{
+    sfe_color_t color;
+
+    if (!myColor.waitForSample() || !myColor.getAllChannelData(&color))
+        return;
+
+    window.add(&color);
+
+    if (window.getCount() < WINDOW_SAMPLES)
+        return;
+
+    Serial.println("Window:");
+    printStats(window);
+
+    session.merge(window);
+    window.reset();
+
+    Serial.println("Session:");
+    printStats(session);
+    Serial.println();
+}
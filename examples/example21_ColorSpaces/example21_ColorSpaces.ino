@@ -0,0 +1,250 @@
+/*
+Example 21 - Color Spaces
+
+This example converts each sample to sRGB, CIELAB, and CIELUV and prints the
+color difference to a reference taken at start-up. Point the sensor at the
+reference light or surface when the sketch starts; that sample is used as the
+white for the conversions and as the color that later samples are compared
+with.
+
+With BENCH_MODE set to 1 the sketch instead times the fixed-point conversion
+against the same conversion in double precision, XYZ, sRGB, CIELAB, and CIELUV
+on both sides, and reports the largest differences. On AVR, double is a 32 bit
+float, so there the reference is itself only single precision. The error
+bounds documented in sfe_opt4048_color.h are measured on a PC by
+extras/opt4048_checks/color_check.
+
+Written by SparkFun Electronics, October 2026
+
+Products:
+    Qwiic 1x1: https://www.sparkfun.com/products/22638
+    Qwiic Mini: https://www.sparkfun.com/products/22639
+
+Repository:
+    https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+SparkFun code, firmware, and software is released under the MIT 
+License	(http://opensource.org/licenses/MIT).
+*/
+
+#include "SparkFun_OPT4048.h"
+#include <Wire.h>
+
+// 0 = print colors, 1 = benchmark against double precision.
+#define BENCH_MODE 0
+
+#define NUM_CONVERSIONS 100
+
+SparkFun_OPT4048 myColor;
+
+sfe_color_t white;
+sfe_opt4048_lab_t reference;
+
+#if BENCH_MODE == 1
+// The CIE matrix of 9.2.4 of the datasheet, one row per channel.
+const double cieMatrix[3][3] = {{.000234892992, -.0000189652390, .0000120811684},
+                                {.0000407467441, .000198958202, -.0000158848115},
+                                {.0000928619404, -.0000169739553, .000674021520}};
+
+// Linear sRGB from XYZ (IEC 61966-2-1).
+const double rgbMatrix[3][3] = {{3.2406, -1.5372, -0.4986}, {-0.9689, 1.8758, 0.0415}, {0.0557, -0.2040, 1.0570}};
+
+const double whiteX = 0.95047;
+const double whiteZ = 1.08883;
+
+// The same work as opt4048CalculateColorSpaces() in double precision: XYZ, 8 bit sRGB, CIELAB, and CIELUV.
+struct DoubleSpaces
+{
+    double xyz[3];
+    uint8_t rgb[3];
+    double lab[3];
+    double luv[3];
+};
+
+double labF(double t)
+{
+    return t > 0.008856 ? pow(t, 1.0 / 3) : 7.787 * t + 16.0 / 116;
+}
+
+uint8_t gamma8Bit(double linear)
+{
+    if (linear <= 0)
+        return 0;
+
+    if (linear >= 1)
+        return 255;
+
+    double encoded = linear <= 0.0031308 ? 12.92 * linear : 1.055 * pow(linear, 1 / 2.4) - 0.055;
+
+    return encoded * 255 + 0.5;
+}
+
+void doubleColorSpaces(const sfe_color_t *color, DoubleSpaces *spaces)
+{
+    double whiteY = white.red * cieMatrix[0][1] + white.green * cieMatrix[1][1] + white.blue * cieMatrix[2][1];
+
+    for (int i = 0; i < 3; i++)
+        spaces->xyz[i] =
+            (color->red * cieMatrix[0][i] + color->green * cieMatrix[1][i] + color->blue * cieMatrix[2][i]) /
+            whiteY;
+
+    const double *xyz = spaces->xyz;
+
+    for (int i = 0; i < 3; i++)
+        spaces->rgb[i] = gamma8Bit(rgbMatrix[i][0] * xyz[0] + rgbMatrix[i][1] * xyz[1] + rgbMatrix[i][2] * xyz[2]);
+
+    double fx = labF(xyz[0] / whiteX);
+    double fy = labF(xyz[1]);
+    double fz = labF(xyz[2] / whiteZ);
+
+    spaces->lab[0] = 116 * fy - 16;
+    spaces->lab[1] = 500 * (fx - fy);
+    spaces->lab[2] = 200 * (fy - fz);
+
+    double denominator = xyz[0] + 15 * xyz[1] + 3 * xyz[2];
+    double whiteDenominator = whiteX + 15 + 3 * whiteZ;
+
+    spaces->luv[0] = spaces->lab[0];
+    spaces->luv[1] = 0;
+    spaces->luv[2] = 0;
+
+    if (denominator > 0)
+    {
+        spaces->luv[1] = 13 * spaces->luv[0] * (4 * xyz[0] / denominator - 4 * whiteX / whiteDenominator);
+        spaces->luv[2] = 13 * spaces->luv[0] * (9 * xyz[1] / denominator - 9 / whiteDenominator);
+    }
+}
+
+double maxError(const int32_t *fixed, const double *exact)
+{
+    double error = 0;
+
+    for (int i = 0; i < 3; i++)
+        error = max(error, fabs(fixed[i] / (double)OPT4048_LAB_ONE - exact[i]));
+
+    return error;
+}
+#endif
+
+void setup()
+{
+    Serial.begin(115200);
+    Serial.println("OPT4048 Example 21 - Color Spaces.");
+
+    Wire.begin();
+
+    if (!myColor.begin()) {
+        Serial.println("OPT4048 not detected- check wiring or that your I2C address is correct!");
+        while (1) ;
+    }
+
+    myColor.setBasicSetup();
+
+    // The reference sample is the white for all conversions.
+    while (!myColor.waitForSample() || !myColor.getAllChannelData(&white))
+        ;
+
+    sfe_opt4048_xyz_t xyz;
+    opt4048CalculateXYZ(&white, &white, &xyz);
+    opt4048XYZToLab(&xyz, &reference);
+
+    Serial.println("Reference taken. Ready to go!");
+}
+
+#if BENCH_MODE == 1
+void loop()
+{
+    sfe_color_t samples[8];
+    sfe_opt4048_color_spaces_t spaces;
+    DoubleSpaces exact;
+    double rgbError = 0;
+    double labError = 0;
+    double luvError = 0;
+    uint32_t start;
+    uint32_t fixedUs;
+    uint32_t doubleUs;
+
+    for (int i = 0; i < 8; i++)
+    {
+        while (!myColor.waitForSample() || !myColor.getAllChannelData(&samples[i]))
+            ;
+    }
+
+    // Both loops do the same work: XYZ, sRGB, CIELAB, and CIELUV of each sample.
+    start = micros();
+    for (int i = 0; i < NUM_CONVERSIONS; i++)
+        opt4048CalculateColorSpaces(&samples[i % 8], &white, &spaces);
+    fixedUs = micros() - start;
+
+    start = micros();
+    for (int i = 0; i < NUM_CONVERSIONS; i++)
+        doubleColorSpaces(&samples[i % 8], &exact);
+    doubleUs = micros() - start;
+
+    for (int i = 0; i < 8; i++)
+    {
+        opt4048CalculateColorSpaces(&samples[i], &white, &spaces);
+        doubleColorSpaces(&samples[i], &exact);
+
+        int32_t lab[3] = {spaces.lab.L, spaces.lab.a, spaces.lab.b};
+        int32_t luv[3] = {spaces.luv.L, spaces.luv.u, spaces.luv.v};
+        uint8_t rgb[3] = {spaces.rgb.red, spaces.rgb.green, spaces.rgb.blue};
+
+        for (int k = 0; k < 3; k++)
+            rgbError = max(rgbError, fabs((double)rgb[k] - exact.rgb[k]));
+
+        labError = max(labError, maxError(lab, exact.lab));
+        luvError = max(luvError, maxError(luv, exact.luv));
+    }
+
+    Serial.print("Fixed-point: ");
+    Serial.print((float)fixedUs / NUM_CONVERSIONS);
+    Serial.print(" us  Double: ");
+    Serial.print((float)doubleUs / NUM_CONVERSIONS);
+    Serial.print(" us  Max error sRGB: ");
+    Serial.print(rgbError, 0);
+    Serial.print(" Lab: ");
+    Serial.print(labError, 4);
+    Serial.print(" Luv: ");
+    Serial.println(luvError, 4);
+
+    delay(1000);
+}
+#else
+void loop()
+{
+    sfe_color_t color;
+    sfe_opt4048_color_spaces_t spaces;
+
+    if (!myColor.waitForSample() || !myColor.getAllChannelData(&color))
+        return;
+
+    opt4048CalculateColorSpaces(&color, &white, &spaces);
+
+    Serial.print("sRGB: ");
+    Serial.print(spaces.rgb.red);
+    Serial.print(",");
+    Serial.print(spaces.rgb.green);
+    Serial.print(",");
+    Serial.print(spaces.rgb.blue);
+
+    Serial.print(" Lab: ");
+    Serial.print(spaces.lab.L / (float)OPT4048_LAB_ONE);
+    Serial.print(",");
+    Serial.print(spaces.lab.a / (float)OPT4048_LAB_ONE);
+    Serial.print(",");
+    Serial.print(spaces.lab.b / (float)OPT4048_LAB_ONE);
+
+    Serial.print(" Luv: ");
+    Serial.print(spaces.luv.L / (float)OPT4048_LAB_ONE);
+    Serial.print(",");
+    Serial.print(spaces.luv.u / (float)OPT4048_LAB_ONE);
+    Serial.print(",");
+    Serial.print(spaces.luv.v / (float)OPT4048_LAB_ONE);
+
+    Serial.print(" dE76: ");
+    Serial.print(opt4048DeltaE76(&reference, &spaces.lab) / (float)OPT4048_LAB_ONE);
+    Serial.print(" dE2000: ");
+    Serial.println(opt4048DeltaE2000(&reference, &spaces.lab) / (float)OPT4048_LAB_ONE);
+}
+#endif
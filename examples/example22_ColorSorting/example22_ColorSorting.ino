@@ -0,0 +1,105 @@
+/*
+Example 22 - Color Sorting
+
+This example names the color of each sample by finding the nearest entry in a
+palette, e.g. to sort parts on a conveyor. The palette is converted to CIELAB
+once in setup() and indexed as a k-d tree, so a sample is compared with only a
+few entries even when the palette holds hundreds of colors.
+
+Place a white reference (e.g. a sheet of paper) under the sensor and the light
+when the sketch starts; the palette colors are relative to that white.
+
+Written by SparkFun Electronics, October 2026
+
+Products:
+    Qwiic 1x1: https://www.sparkfun.com/products/22638
+    Qwiic Mini: https://www.sparkfun.com/products/22639
+
+Repository:
+    https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+SparkFun code, firmware, and software is released under the MIT
+License	(http://opensource.org/licenses/MIT).
+*/
+
+#include "SparkFun_OPT4048.h"
+#include <Wire.h>
+
+// Matches farther than this Delta E are reported as unknown.
+#define MAX_DELTA_E 20
+
+// Entries compared per sample at most, or 0 for an exact search.
+#define MAX_VISITS 0
+
+typedef struct
+{
+    const char *name;
+    uint8_t red;
+    uint8_t green;
+    uint8_t blue;
+} named_color_t;
+
+const named_color_t colors[] = {
+    {"White", 255, 255, 255},  {"Silver", 192, 192, 192}, {"Gray", 128, 128, 128},  {"Black", 0, 0, 0},
+    {"Red", 255, 0, 0},        {"Maroon", 128, 0, 0},     {"Orange", 255, 165, 0}, {"Yellow", 255, 255, 0},
+    {"Olive", 128, 128, 0},    {"Lime", 0, 255, 0},       {"Green", 0, 128, 0},    {"Cyan", 0, 255, 255},
+    {"Teal", 0, 128, 128},     {"Blue", 0, 0, 255},       {"Navy", 0, 0, 128},     {"Magenta", 255, 0, 255},
+    {"Purple", 128, 0, 128},   {"Pink", 255, 192, 203},   {"Brown", 165, 42, 42},  {"Tan", 210, 180, 140},
+};
+
+#define NUM_COLORS (sizeof(colors) / sizeof(colors[0]))
+
+SparkFun_OPT4048 myColor;
+
+sfe_opt4048_palette_entry_t entries[NUM_COLORS];
+QwOpt4048Palette palette(entries, NUM_COLORS);
+
+sfe_color_t white;
+
+void setup()
+{
+    Serial.begin(115200);
+    Serial.println("OPT4048 Example 22 - Color Sorting.");
+
+    Wire.begin();
+
+    if (!myColor.begin()) {
+        Serial.println("OPT4048 not detected- check wiring or that your I2C address is correct!");
+        while (1) ;
+    }
+
+    myColor.setBasicSetup();
+
+    for (uint16_t i = 0; i < NUM_COLORS; i++)
+        palette.addEntry(colors[i].red, colors[i].green, colors[i].blue, i);
+
+    palette.build();
+    palette.setMaxVisits(MAX_VISITS);
+
+    while (!myColor.waitForSample() || !myColor.getAllChannelData(&white))
+        ;
+
+    Serial.println("White reference taken. Ready to go!");
+}
+
+void loop()
+{
+    sfe_color_t color;
+    sfe_opt4048_palette_match_t match;
+
+    if (!myColor.waitForSample() || !myColor.getAllChannelData(&color))
+        return;
+
+    if (!palette.classify(&color, &white, &match))
+        return;
+
+    if (match.distance > MAX_DELTA_E * OPT4048_LAB_ONE)
+        Serial.print("Unknown");
+    else
+        Serial.print(colors[match.id].name);
+
+    Serial.print(" dE76: ");
+    Serial.print(match.distance / (float)OPT4048_LAB_ONE);
+    Serial.print(" Compared: ");
+    Serial.println(match.visited);
+}
@@ -0,0 +1,82 @@
+/*
+Example 23 - HDR Merge
+
+This example takes each sample as a bracket of three readings in a low, a
+middle, and the highest range, and merges them into one value per channel. Dim
+scenes keep the resolution of the low range, while bright spots that saturate
+it are covered by the higher ranges. Unlike RANGE_AUTO, every merged sample is
+built from the same ranges, so consecutive samples are comparable.
+
+The bracket takes three conversions, so with a 1 ms conversion time a merged
+sample is produced about every 12 ms.
+
+Written by SparkFun Electronics, October 2026
+
+Products:
+    Qwiic 1x1: https://www.sparkfun.com/products/22638
+    Qwiic Mini: https://www.sparkfun.com/products/22639
+
+Repository:
+    https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+SparkFun code, firmware, and software is released under the MIT
+License	(http://opensource.org/licenses/MIT).
+*/
+
+#include "SparkFun_OPT4048.h"
+#include <Wire.h>
+
+SparkFun_OPT4048 myColor;
+
+QwOpt4048Hdr hdr;
+
+const opt4048_range_t bracket[] = {RANGE_2KLUX2, RANGE_18LUX, RANGE_144LUX};
+
+void setup()
+{
+    Serial.begin(115200);
+    Serial.println("OPT4048 Example 23 - HDR Merge.");
+
+    Wire.begin();
+
+    if (!myColor.begin()) {
+        Serial.println("OPT4048 not detected- check wiring or that your I2C address is correct!");
+        while (1) ;
+    }
+
+    myColor.setConversionTime(CONVERSION_TIME_1MS);
+
+    if (!hdr.begin(myColor, bracket, sizeof(bracket) / sizeof(bracket[0]))) {
+        Serial.println("HDR setup failed.");
+        while (1) ;
+    }
+
+    Serial.print("Bracket period (us): ");
+    Serial.println(hdr.getBracketPeriodUs());
+    Serial.println("Ready to go!");
+}
+
+void loop()
+{
+    sfe_opt4048_hdr_sample_t sample;
+    sfe_cie_t cie;
+
+    if (!hdr.capture(&sample))
+        return;
+
+    myColor.calculateCIE(&sample.color, &cie);
+
+    Serial.print("Lux: ");
+    Serial.print(cie.lux);
+    Serial.print(" CIEx: ");
+    Serial.print(cie.CIEx, 4);
+    Serial.print(" CIEy: ");
+    Serial.print(cie.CIEy, 4);
+    Serial.print(" Readings: ");
+    Serial.print(sample.readings);
+
+    if (sample.saturated)
+        Serial.print(" Saturated!");
+
+    Serial.println();
+}
@@ -0,0 +1,99 @@
+/*
+Example 24 - Dark Calibration
+
+This example measures the dark offsets of the sensor in every range, so that
+light leaking into an enclosure or the dark current of the sensor is
+subtracted from each sample. Cover the sensor when asked and send any
+character over the serial monitor. After the calibration, every sample read
+with getAllChannelData() is already corrected.
+
+The table holds one 10 byte entry per range and conversion time. It is plain
+data, so it can be saved to EEPROM and loaded again with setOffsets() or by
+copying the entries back.
+
+Written by SparkFun Electronics, October 2026
+
+Products:
+    Qwiic 1x1: https://www.sparkfun.com/products/22638
+    Qwiic Mini: https://www.sparkfun.com/products/22639
+
+Repository:
+    https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+SparkFun code, firmware, and software is released under the MIT
+License	(http://opensource.org/licenses/MIT).
+*/
+
+#include "SparkFun_OPT4048.h"
+#include <Wire.h>
+
+// Dark samples averaged per range.
+#define DARK_SAMPLES 16
+
+SparkFun_OPT4048 myColor;
+
+// One entry per range, for the conversion time used below.
+sfe_opt4048_dark_entry_t darkEntries[7];
+QwOpt4048DarkTable darkTable(darkEntries, 7);
+
+void setup()
+{
+    Serial.begin(115200);
+    Serial.println("OPT4048 Example 24 - Dark Calibration.");
+
+    Wire.begin();
+
+    if (!myColor.begin()) {
+        Serial.println("OPT4048 not detected- check wiring or that your I2C address is correct!");
+        while (1) ;
+    }
+
+    // Auto range can pick any range, so all of them are calibrated.
+    myColor.setRange(RANGE_AUTO);
+    myColor.setConversionTime(CONVERSION_TIME_25MS);
+    myColor.setOperationMode(OPERATION_MODE_CONTINUOUS);
+
+    Serial.println("Cover the sensor, then send any character.");
+
+    while (Serial.available() == 0)
+        ;
+
+    for (uint8_t range = RANGE_2KLUX2; range <= RANGE_144LUX; range++)
+    {
+        if (!darkTable.calibrate(myColor, (opt4048_range_t)range, CONVERSION_TIME_25MS, DARK_SAMPLES)) {
+            Serial.println("Calibration failed.");
+            while (1) ;
+        }
+
+        Serial.print("Range ");
+        Serial.print(range);
+        Serial.print(" dark offsets: ");
+        for (uint8_t channel = 0; channel < 4; channel++)
+        {
+            Serial.print(darkTable.getOffset(channel, range, CONVERSION_TIME_25MS));
+            Serial.print(" ");
+        }
+        Serial.println();
+    }
+
+    myColor.setDarkTable(&darkTable);
+
+    Serial.println("Uncover the sensor. Ready to go!");
+}
+
+void loop()
+{
+    sfe_color_t color;
+
+    if (!myColor.waitForSample() || !myColor.getAllChannelData(&color))
+        return;
+
+    Serial.print("Red: ");
+    Serial.print(color.red);
+    Serial.print(" Green: ");
+    Serial.print(color.green);
+    Serial.print(" Blue: ");
+    Serial.print(color.blue);
+    Serial.print(" White: ");
+    Serial.println(color.white);
+}
@@ -0,0 +1,99 @@
+/*
+Example 25 - Trace Recording
+
+This example records every I2C transaction between the driver and the sensor
+to an SD card: address, register, bytes, result, timestamp, and duration, in
+the binary format described in sfe_opt4048_trace_format.h. The trace can be
+replayed into the driver on a PC with the tool in extras/opt4048_replay, to
+reproduce a field issue or to compare outputs and transaction counts between
+library versions. The replay tool's scenario matches this sketch.
+
+Send any character in the Serial Monitor to stop recording and close the file.
+
+Written by SparkFun Electronics, October 2026
+
+Products:
+    Qwiic 1x1: https://www.sparkfun.com/products/22638
+    Qwiic Mini: https://www.sparkfun.com/products/22639
+
+Repository:
+    https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+SparkFun code, firmware, and software is released under the MIT
+License	(http://opensource.org/licenses/MIT).
+*/
+
+#include <SD.h>
+#include <SPI.h>
+#include "SparkFun_OPT4048.h"
+#include <Wire.h>
+
+const int chipSelect = 5;
+
+SparkFun_OPT4048 myColor;
+sfe_OPT4048::QwI2C i2cBus;
+QwOpt4048TraceRecorder recorder;
+File traceFile;
+
+void setup()
+{
+    Serial.begin(115200);
+    Serial.println("OPT4048 Example 25 - Trace Recording.");
+
+    Wire.begin();
+    SPI.begin();
+
+    if (!myColor.begin()) {
+        Serial.println("OPT4048 not detected- check wiring or that your I2C address is correct!");
+        while (1) ;
+    }
+
+    if (!SD.begin(chipSelect)) {
+        Serial.println("Card failed, or not present. Freezing...");
+        while (1) ;
+    }
+
+    SD.remove("trace.bin");
+    traceFile = SD.open("trace.bin", FILE_WRITE);
+
+    // The recorder forwards to its own bus on the same Wire port.
+    i2cBus.init(Wire);
+
+    if (!traceFile || !recorder.begin(myColor, i2cBus, traceFile)) {
+        Serial.println("Could not start the trace. Freezing...");
+        while (1) ;
+    }
+
+    // Recorded from here on.
+    myColor.setBasicSetup();
+
+    Serial.println("Recording...");
+}
+
+void loop()
+{
+    sfe_color_t color;
+    sfe_cie_t cie;
+
+    // Calculated from the sample, so the bus traffic is one flag read and one data read per sample.
+    if (myColor.waitForSample() && myColor.getAllChannelData(&color))
+    {
+        myColor.calculateCIE(&color, &cie);
+
+        Serial.print("Lux: ");
+        Serial.println(cie.lux);
+    }
+
+    if (Serial.available() > 0)
+    {
+        recorder.end();
+        traceFile.close();
+
+        Serial.print("Transactions recorded: ");
+        Serial.println(recorder.getTransactions());
+        Serial.print("Bytes: ");
+        Serial.println(recorder.getBytesWritten());
+
+        while (1) ;
+    }
+}
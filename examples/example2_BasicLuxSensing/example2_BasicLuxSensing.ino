@@ -42,9 +42,10 @@ void setup()
 
 void loop()
 {
+    // Sleeps until the next sample is predicted to be ready instead of guessing with a delay.
+    if (!myColor.waitForSample())
+        return;
+
     Serial.print("Lux:");
-    Serial.print(myColor.getLux());
-    // Delay time is set to the conversion time * number of channels
-    // You only need one channel for sensing light intensity @ 200ms conversion time = 200ms. 
-    delay(200);
+    Serial.println(myColor.getLux());
 }
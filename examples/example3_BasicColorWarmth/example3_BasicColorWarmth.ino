@@ -43,10 +43,11 @@ void setup()
 
 void loop()
 {
+    // Sleeps until the next sample is predicted to be ready instead of guessing with a delay.
+    if (!myColor.waitForSample())
+        return;
+
     Serial.print("Color Warmth: ");
     Serial.print(myColor.getCCT());
     Serial.println("K");
-    // Delay time is set to the conversion time * number of channels
-    // You need three channels for color sensing @ 200ms conversion time = 600ms.
-    delay(600);
 }
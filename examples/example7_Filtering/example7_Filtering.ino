@@ -0,0 +1,78 @@
+/*
+Example 7 - Filtering
+
+This example shows how to smooth the raw channel data with the integer filter
+stages before the CIE values are calculated. A median stage removes single
+sample spikes and an exponential moving average smooths what is left. The
+CIE x, CIE y, lux, and CCT values are then calculated once from the filtered
+sample.
+
+Written by SparkFun Electronics, October 2026
+
+Products:
+    Qwiic 1x1: https://www.sparkfun.com/products/22638
+    Qwiic Mini: https://www.sparkfun.com/products/22639
+
+Repository:
+    https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+SparkFun code, firmware, and software is released under the MIT 
+License	(http://opensource.org/licenses/MIT).
+*/
+
+#include "SparkFun_OPT4048.h"
+#include <Wire.h>
+
+SparkFun_OPT4048 myColor;
+
+// Median of the last three samples, followed by an EMA with alpha = 1/8.
+QwOpt4048MedianFilter<3> medianStage;
+QwOpt4048EmaFilter emaStage(3);
+QwOpt4048FilterPipeline pipeline;
+
+void setup()
+{
+    Serial.begin(115200);
+    Serial.println("OPT4048 Example 7 Filtering.");
+
+    Wire.begin();
+
+    if (!myColor.begin()) {
+        Serial.println("OPT4048 not detected- check wiring or that your I2C address is correct!");
+        while (1) ;
+    }
+
+    myColor.setRange(RANGE_AUTO);
+    myColor.setConversionTime(CONVERSION_TIME_25MS);
+    myColor.setOperationMode(OPERATION_MODE_CONTINUOUS);
+
+    pipeline.addStage(medianStage);
+    pipeline.addStage(emaStage);
+
+    Serial.println("Ready to go!");
+}
+
+
+void loop()
+{
+    sfe_color_t color;
+    sfe_cie_t cie;
+
+    if (myColor.getAllChannelData(&color))
+    {
+        pipeline.update(&color);
+        myColor.calculateCIE(&color, &cie);
+
+        Serial.print("CIEx: ");
+        Serial.print(cie.CIEx, 4);
+        Serial.print(" CIEy: ");
+        Serial.print(cie.CIEy, 4);
+        Serial.print(" Lux: ");
+        Serial.print(cie.lux);
+        Serial.print(" CCT: ");
+        Serial.println(cie.CCT);
+    }
+
+    // 25ms conversion time * four channels.
+    delay(100);
+}
@@ -0,0 +1,76 @@
+/*
+Example 8 - Flicker
+
+This example streams Channel One at the fastest conversion time and reports the
+percent flicker, flicker index, and dominant frequency of the light source. 
+Mains powered lighting flickers at twice the line frequency: 100Hz or 120Hz. 
+LED lighting with PWM dimming often flickers at a few hundred Hz; only
+frequencies below half the sample rate (about 208Hz) can be detected.
+
+Call update() as often as possible; don't add delays to the loop. 
+
+Written by SparkFun Electronics, October 2026
+
+Products:
+    Qwiic 1x1: https://www.sparkfun.com/products/22638
+    Qwiic Mini: https://www.sparkfun.com/products/22639
+
+Repository:
+    https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+SparkFun code, firmware, and software is released under the MIT 
+License	(http://opensource.org/licenses/MIT).
+*/
+
+#include "SparkFun_OPT4048.h"
+#include <Wire.h>
+
+SparkFun_OPT4048 myColor;
+QwOpt4048Flicker flicker;
+
+void setup()
+{
+    Serial.begin(115200);
+    Serial.println("OPT4048 Example 8 Flicker.");
+
+    Wire.begin();
+    // A fast bus keeps the polling well below the 2.4ms sample period.
+    Wire.setClock(400000);
+
+    if (!myColor.begin()) {
+        Serial.println("OPT4048 not detected- check wiring or that your I2C address is correct!");
+        while (1) ;
+    }
+
+    myColor.setRange(RANGE_AUTO);
+
+    flicker.addFrequency(50);
+    flicker.addFrequency(60);
+    flicker.addFrequency(100);
+    flicker.addFrequency(120);
+
+    if (!flicker.begin(myColor)) {
+        Serial.println("Could not configure the sensor for flicker measurements. Freezing...");
+        while (1) ;
+    }
+
+    Serial.println("Ready to go!");
+}
+
+
+void loop()
+{
+    if (flicker.update())
+    {
+        Serial.print("Percent flicker: ");
+        Serial.print(flicker.getPercentFlicker());
+        Serial.print(" Flicker index: ");
+        Serial.print(flicker.getFlickerIndex(), 3);
+        Serial.print(" Dominant frequency: ");
+        Serial.print(flicker.getDominantFrequency());
+        Serial.print("Hz Sample rate: ");
+        Serial.print(flicker.getSampleRate());
+        Serial.print("Hz Missed: ");
+        Serial.println(flicker.getMissedSamples());
+    }
+}
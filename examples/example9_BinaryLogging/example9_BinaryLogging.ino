@@ -0,0 +1,102 @@
+/*
+Example 9 - Binary Logging
+
+This example logs samples to an SD card in the compact binary format described
+in sfe_opt4048_log_format.h. Each sample is a 32 byte record holding a timestamp,
+the raw channel registers, and the CONTROL and FLAGS registers. Records are 
+collected in two 512 byte sectors: while one sector is being filled, the other
+is written to the card in a single, sector aligned write. The file stays open
+for the whole run instead of being reopened for every write.
+
+Send any character in the Serial Monitor to stop logging and close the file.
+
+Written by SparkFun Electronics, October 2026
+
+Products:
+    Qwiic 1x1: https://www.sparkfun.com/products/22638
+    Qwiic Mini: https://www.sparkfun.com/products/22639
+
+Repository:
+    https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+SparkFun code, firmware, and software is released under the MIT 
+License	(http://opensource.org/licenses/MIT).
+*/
+
+#include <SD.h>
+#include <SPI.h>
+#include "SparkFun_OPT4048.h"
+#include <Wire.h>
+
+const int chipSelect = 5;
+
+SparkFun_OPT4048 myColor;
+QwOpt4048Logger logger;
+File logFile;
+
+void setup()
+{
+    Serial.begin(115200);
+    Serial.println("OPT4048 Example 9 Binary Logging.");
+
+    Wire.begin();
+    Wire.setClock(400000);
+    SPI.begin();
+
+    if (!myColor.begin()) {
+        Serial.println("OPT4048 not detected- check wiring or that your I2C address is correct!");
+        while (1) ;
+    }
+
+    if (!SD.begin(chipSelect)) {
+        Serial.println("Card failed, or not present. Freezing...");
+        while (1) ;
+    }
+
+    // 1ms per channel gives a new sample every 4ms.
+    myColor.setRange(RANGE_AUTO);
+    myColor.setConversionTime(CONVERSION_TIME_1MS);
+    myColor.setOperationMode(OPERATION_MODE_CONTINUOUS);
+
+    // Start from a fresh file so the header begins on a sector boundary.
+    SD.remove("color.bin");
+    logFile = SD.open("color.bin", FILE_WRITE);
+
+    if (!logFile || !logger.begin(myColor, logFile)) {
+        Serial.println("Could not start the log. Freezing...");
+        while (1) ;
+    }
+
+    Serial.println("Logging...");
+}
+
+
+void loop()
+{
+    static uint8_t lastCounter = 0xFF;
+    uint32_t code;
+    uint8_t counter;
+
+    // Log each new conversion once, using the Channel Zero counter to spot it.
+    if (myColor.getChannelData(0, &code, &counter) && counter != lastCounter)
+    {
+        lastCounter = counter;
+        logger.logSample();
+    }
+
+    // Whole sectors only.
+    logger.service();
+
+    if (Serial.available() > 0)
+    {
+        logger.flush();
+        logFile.close();
+
+        Serial.print("Samples logged: ");
+        Serial.println(logger.getRecordsLogged());
+        Serial.print("Samples dropped: ");
+        Serial.println(logger.getOverruns());
+        Serial.println("Log closed. Freezing...");
+        while (1) ;
+    }
+}
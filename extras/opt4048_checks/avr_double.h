@@ -0,0 +1,53 @@
+/*
+avr_double.h
+
+SparkFun Tristimulus Color Sensor - OPT4048
+
+Qwiic 1x1
+* https://www.sparkfun.com/products/
+Qwiic Mini
+* https://www.sparkfun.com/products/
+
+Repository:
+* https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+The MIT License (MIT)
+
+Copyright (c) 2022 SparkFun Electronics
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions: The
+above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED
+"AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+License(http://opensource.org/licenses/MIT).
+
+Force included ahead of every source of the AVR variant of a check, to
+simulate a compiler whose double is a 32 bit float, like avr-gcc. The standard
+headers are included first, so the definition only reaches the library and the
+check itself.
+
+*/
+#pragma once
+#include <cinttypes>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <math.h>
+#include <random>
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+#define double float
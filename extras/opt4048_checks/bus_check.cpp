@@ -0,0 +1,196 @@
+/*
+bus_check.cpp
+
+SparkFun Tristimulus Color Sensor - OPT4048
+
+Qwiic 1x1
+* https://www.sparkfun.com/products/
+Qwiic Mini
+* https://www.sparkfun.com/products/
+
+Repository:
+* https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+The MIT License (MIT)
+
+Copyright (c) 2022 SparkFun Electronics
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions: The
+above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED
+"AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+License(http://opensource.org/licenses/MIT).
+Check of the I2C bus layer in sfe_bus.cpp against a simulated bus, the
+recording Wire in ../opt4048_replay/host_recording. The exact sequence of bus
+events is compared for the port clock, per-device clocks, Hs-mode with its
+master code, the default clock the port returns to, chunked reads, and the
+Alert Response Address. Speed negotiation is checked against devices with
+different limits.
+
+*/
+#include "sfe_bus.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using sfe_OPT4048::QwI2CDirect;
+
+namespace
+{
+
+// Two simulated OPT4048s: a fast one with Hs-mode, and one limited to Fast-mode.
+constexpr uint8_t kFastAddress = 0x44;
+constexpr uint8_t kSlowAddress = 0x45;
+constexpr uint8_t kIdRegister = 0x11;
+constexpr uint16_t kDeviceId = 0x0821;
+
+int failures = 0;
+
+void setupBus()
+{
+    Wire.reset();
+    Wire.addDevice(kFastAddress, 1000000, 3400000);
+    Wire.addDevice(kSlowAddress, 400000);
+    Wire.setRegister(kFastAddress, kIdRegister, kDeviceId);
+    Wire.setRegister(kSlowAddress, kIdRegister, kDeviceId);
+    QwI2CDirect::invalidateClock();
+    QwI2CDirect::setDefaultClock(100000);
+}
+
+void expect(const char *name, bool condition)
+{
+    if (!condition)
+    {
+        failures++;
+        printf("%s: FAILED\n", name);
+    }
+}
+
+void expectEvents(const char *name, const std::vector<std::string> &expected)
+{
+    std::vector<std::string> events = Wire.takeEvents();
+
+    if (events == expected)
+    {
+        printf("%-24s OK\n", name);
+        return;
+    }
+
+    failures++;
+    printf("%-24s FAILED\n  expected:\n", name);
+
+    for (const std::string &event : expected)
+        printf("    %s\n", event.c_str());
+
+    printf("  got:\n");
+
+    for (const std::string &event : events)
+        printf("    %s\n", event.c_str());
+}
+
+uint16_t readId(QwI2CDirect &bus, uint8_t address)
+{
+    uint8_t buff[2];
+
+    if (bus.readRegisterRegion(address, kIdRegister, buff, 2) != 0)
+        return 0;
+
+    return buff[0] << 8 | buff[1];
+}
+
+} // namespace
+
+int main()
+{
+    QwI2CDirect fast;
+    QwI2CDirect slow;
+    QwI2CDirect missing;
+    uint8_t buff[40];
+
+    fast.init(Wire);
+    slow.init(Wire);
+    missing.init(Wire);
+
+    // Without a clock of its own a device runs at the port clock, and the clock is never touched.
+    setupBus();
+    expect("port clock id", readId(fast, kFastAddress) == kDeviceId);
+    expectEvents("port clock", {"write 0x44 11 stop 100000", "read 0x44 2 stop 100000"});
+
+    // A device clock is set for the transfer, then the port returns to the default clock.
+    setupBus();
+    fast.setClock(1000000);
+    readId(fast, kFastAddress);
+    readId(slow, kSlowAddress);
+    expectEvents("device clock", {"clock 1000000", "write 0x44 11 stop 1000000", "read 0x44 2 stop 1000000",
+                                  "clock 100000", "write 0x45 11 stop 100000", "read 0x45 2 stop 100000"});
+
+    // The default clock is the one the port returns to.
+    setupBus();
+    QwI2CDirect::setDefaultClock(400000);
+    readId(fast, kFastAddress);
+    readId(slow, kSlowAddress);
+    expectEvents("default clock", {"clock 1000000", "write 0x44 11 stop 1000000", "read 0x44 2 stop 1000000",
+                                   "clock 400000", "write 0x45 11 stop 400000", "read 0x45 2 stop 400000"});
+
+    // Hs-mode: the master code at 400kHz, a repeated start at the Hs clock, and no STOP until the read is
+    // done. A write is a single Hs transfer.
+    setupBus();
+    fast.setClock(0);
+    fast.setHighSpeed(3400000);
+    expect("hs id", readId(fast, kFastAddress) == kDeviceId);
+    buff[0] = 0x32;
+    buff[1] = 0x08;
+    expect("hs write", fast.writeRegisterRegion(kFastAddress, 0x0A, buff, 2) == 0);
+    expect("hs register", Wire.getRegister(kFastAddress, 0x0A) == 0x3208);
+    expectEvents("hs-mode", {"clock 400000", "master 0x05 400000", "clock 3400000",
+                             "write 0x44 11 restart 3400000", "read 0x44 2 stop 3400000", "clock 100000",
+                             "clock 400000", "master 0x05 400000", "clock 3400000",
+                             "write 0x44 0A 32 08 stop 3400000", "clock 100000"});
+
+    // Reads longer than the Wire buffer are split into chunks that continue where the last one ended.
+    setupBus();
+    fast.setHighSpeed(0);
+    for (uint8_t reg = 0; reg < 20; reg++)
+        Wire.setRegister(kFastAddress, reg, 0x0100 * reg + reg);
+    expect("chunked read", fast.readRegisterRegion(kFastAddress, 0, buff, sizeof(buff)) == 0);
+    for (uint8_t reg = 0; reg < 20; reg++)
+        expect("chunked data", buff[2 * reg] == reg && buff[2 * reg + 1] == reg);
+    expectEvents("chunked read",
+                 {"write 0x44 00 stop 100000", "read 0x44 32 stop 100000", "write 0x44 stop 100000",
+                  "read 0x44 8 stop 100000"});
+
+    // The Alert Response Address is answered once per asserted ALERT.
+    setupBus();
+    Wire.setAlert(kSlowAddress);
+    expect("alert response", fast.alertResponse(buff) == 0 && buff[0] == kSlowAddress << 1);
+    expect("alert released", fast.alertResponse(buff) == -1);
+    expectEvents("alert response", {"read 0x0C 1 stop 100000", "nack 0x0C stop 100000"});
+
+    // Negotiation keeps the fastest speed each device answers at.
+    setupBus();
+    expect("negotiate hs", fast.negotiateClock(kFastAddress, kIdRegister, kDeviceId, 3400000) == 3400000);
+    expect("negotiate fast-mode", slow.negotiateClock(kSlowAddress, kIdRegister, kDeviceId, 3400000) == 400000);
+    expect("negotiate none", missing.negotiateClock(0x46, kIdRegister, kDeviceId) == 0);
+    Wire.takeEvents();
+    readId(slow, kSlowAddress);
+    expectEvents("negotiated clock", {"clock 400000", "write 0x45 11 stop 400000", "read 0x45 2 stop 400000",
+                                      "clock 100000"});
+
+    if (Wire.getViolations() != 0)
+        failures++;
+
+    printf(failures ? "FAILED\n" : "OK\n");
+
+    return failures ? 1 : 0;
+}
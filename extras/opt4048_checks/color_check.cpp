@@ -0,0 +1,338 @@
+/*
+color_check.cpp
+
+SparkFun Tristimulus Color Sensor - OPT4048
+
+Qwiic 1x1
+* https://www.sparkfun.com/products/
+Qwiic Mini
+* https://www.sparkfun.com/products/
+
+Repository:
+* https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+The MIT License (MIT)
+
+Copyright (c) 2022 SparkFun Electronics
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions: The
+above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED
+"AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+License(http://opensource.org/licenses/MIT).
+Error bounds of the fixed-point color conversions in sfe_opt4048_color.h
+against a double precision reference, on 300000 samples: raw codes over every
+exponent, with and without a white, and colors near the white. Checks the
+bounds documented in sfe_opt4048_color.h and prints the largest errors.
+
+*/
+#include "sfe_opt4048_color.h"
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+namespace
+{
+
+// The bounds documented in sfe_opt4048_color.h.
+constexpr double kMaxRgbError = 0.6;
+constexpr double kMaxLabError = 0.1;
+constexpr double kMaxBrightLabError = 0.2;
+constexpr double kMaxDeltaE76Error = 0.004;
+constexpr double kMaxDeltaE2000Error = 0.0025;
+
+// Samples up to this many times brighter than the white are checked against kMaxBrightLabError.
+constexpr double kBrightLimit = 8;
+
+constexpr int kSamples = 300000;
+
+// The CIE matrix of 9.2.4 of the datasheet, one row per channel.
+const double kCieMatrix[3][3] = {{.000234892992, -.0000189652390, .0000120811684},
+                                 {.0000407467441, .000198958202, -.0000158848115},
+                                 {.0000928619404, -.0000169739553, .000674021520}};
+
+const double kWhiteX = 0.95047;
+const double kWhiteZ = 1.08883;
+
+struct Lab
+{
+    double L;
+    double a;
+    double b;
+};
+
+// XYZ normalized to the Y of the white, or to the sample's own Y without a white.
+void referenceXYZ(const sfe_color_t *color, const sfe_color_t *white, double *xyz)
+{
+    double reference[3];
+
+    for (int i = 0; i < 3; i++)
+    {
+        xyz[i] = color->red * kCieMatrix[0][i] + color->green * kCieMatrix[1][i] + color->blue * kCieMatrix[2][i];
+
+        if (white != nullptr)
+            reference[i] =
+                white->red * kCieMatrix[0][i] + white->green * kCieMatrix[1][i] + white->blue * kCieMatrix[2][i];
+    }
+
+    double whiteY = white != nullptr ? reference[1] : xyz[1];
+
+    for (int i = 0; i < 3; i++)
+        xyz[i] /= whiteY;
+}
+
+// sRGB of one linear channel, 0 to 255 unrounded.
+double referenceGamma(double linear)
+{
+    if (linear <= 0)
+        return 0;
+
+    if (linear >= 1)
+        return 255;
+
+    return 255 * (linear <= 0.0031308 ? 12.92 * linear : 1.055 * pow(linear, 1 / 2.4) - 0.055);
+}
+
+double labF(double t)
+{
+    return t > 216.0 / 24389 ? cbrt(t) : 841.0 / 108 * t + 16.0 / 116;
+}
+
+Lab referenceLab(const double *xyz)
+{
+    double fx = labF(xyz[0] / kWhiteX);
+    double fy = labF(xyz[1]);
+    double fz = labF(xyz[2] / kWhiteZ);
+
+    return {116 * fy - 16, 500 * (fx - fy), 200 * (fy - fz)};
+}
+
+Lab referenceLuv(const double *xyz)
+{
+    double L = 116 * labF(xyz[1]) - 16;
+    double denominator = xyz[0] + 15 * xyz[1] + 3 * xyz[2];
+    double whiteDenominator = kWhiteX + 15 + 3 * kWhiteZ;
+
+    return {L, 13 * L * (4 * xyz[0] / denominator - 4 * kWhiteX / whiteDenominator),
+            13 * L * (9 * xyz[1] / denominator - 9 / whiteDenominator)};
+}
+
+// Sharma, Wu, and Dalal, "The CIEDE2000 Color-Difference Formula", 2005.
+double referenceDeltaE2000(const Lab &lab1, const Lab &lab2)
+{
+    const double kDegree = M_PI / 180;
+    const double kPow25To7 = pow(25, 7);
+
+    double C1 = hypot(lab1.a, lab1.b);
+    double C2 = hypot(lab2.a, lab2.b);
+    double meanC7 = pow((C1 + C2) / 2, 7);
+    double G = 0.5 * (1 - sqrt(meanC7 / (meanC7 + kPow25To7)));
+    double a1 = (1 + G) * lab1.a;
+    double a2 = (1 + G) * lab2.a;
+    double C1p = hypot(a1, lab1.b);
+    double C2p = hypot(a2, lab2.b);
+
+    auto hue = [](double b, double a) {
+        if (a == 0 && b == 0)
+            return 0.0;
+
+        double h = atan2(b, a);
+
+        return h < 0 ? h + 2 * M_PI : h;
+    };
+
+    double h1 = hue(lab1.b, a1);
+    double h2 = hue(lab2.b, a2);
+    double dh = 0;
+    double meanH = h1 + h2;
+
+    if (C1p * C2p != 0)
+    {
+        dh = h2 - h1;
+
+        if (dh > M_PI)
+            dh -= 2 * M_PI;
+        else if (dh < -M_PI)
+            dh += 2 * M_PI;
+
+        if (fabs(h1 - h2) <= M_PI)
+            meanH /= 2;
+        else if (meanH < 2 * M_PI)
+            meanH = (meanH + 2 * M_PI) / 2;
+        else
+            meanH = (meanH - 2 * M_PI) / 2;
+    }
+
+    double dL = lab2.L - lab1.L;
+    double dC = C2p - C1p;
+    double dH = 2 * sqrt(C1p * C2p) * sin(dh / 2);
+    double meanL = (lab1.L + lab2.L) / 2;
+    double meanCp = (C1p + C2p) / 2;
+    double meanCp7 = pow(meanCp, 7);
+    double T = 1 - 0.17 * cos(meanH - 30 * kDegree) + 0.24 * cos(2 * meanH) + 0.32 * cos(3 * meanH + 6 * kDegree) -
+               0.2 * cos(4 * meanH - 63 * kDegree);
+    double dTheta = 30 * kDegree * exp(-pow((meanH / kDegree - 275) / 25, 2));
+    double RC = 2 * sqrt(meanCp7 / (meanCp7 + kPow25To7));
+    double SL = 1 + 0.015 * pow(meanL - 50, 2) / sqrt(20 + pow(meanL - 50, 2));
+    double SC = 1 + 0.045 * meanCp;
+    double SH = 1 + 0.015 * meanCp * T;
+    double RT = -sin(2 * dTheta) * RC;
+
+    return sqrt(pow(dL / SL, 2) + pow(dC / SC, 2) + pow(dH / SH, 2) + RT * (dC / SC) * (dH / SH));
+}
+
+Lab toDouble(const sfe_opt4048_lab_t &lab)
+{
+    return {lab.L / (double)OPT4048_LAB_ONE, lab.a / (double)OPT4048_LAB_ONE, lab.b / (double)OPT4048_LAB_ONE};
+}
+
+Lab toDouble(const sfe_opt4048_luv_t &luv)
+{
+    return {luv.L / (double)OPT4048_LAB_ONE, luv.u / (double)OPT4048_LAB_ONE, luv.v / (double)OPT4048_LAB_ONE};
+}
+
+double maxDifference(const Lab &value, const Lab &reference)
+{
+    return fmax(fabs(value.L - reference.L), fmax(fabs(value.a - reference.a), fabs(value.b - reference.b)));
+}
+
+struct Errors
+{
+    double rgb = 0;
+    double lab = 0;
+    double luv = 0;
+    double brightLab = 0;
+    double brightLuv = 0;
+    double deltaE76 = 0;
+    double deltaE2000 = 0;
+    int samples = 0;
+    int brightSamples = 0;
+};
+
+// A raw code: a 20 bit mantissa shifted by an exponent of 0 to 8.
+uint32_t randomCode(std::mt19937 &random)
+{
+    return (random() & 0xFFFFF) << (random() % 9);
+}
+
+int check(const char *name, double value, double limit)
+{
+    bool ok = value <= limit;
+
+    printf("%-16s %8.5f  (limit %.4f)%s\n", name, value, limit, ok ? "" : "  FAILED");
+
+    return ok ? 0 : 1;
+}
+
+} // namespace
+
+int main()
+{
+    std::mt19937 random(4048);
+    std::uniform_real_distribution<double> unit(0, 1);
+    sfe_color_t white = {};
+    sfe_opt4048_lab_t previous = {};
+    Errors errors;
+
+    white.red = 200000;
+    white.green = 220000;
+    white.blue = 180000;
+
+    for (int i = 0; i < kSamples; i++)
+    {
+        sfe_color_t color = {};
+
+        if (i % 3 == 0)
+        {
+            // Near the white, from black to twice as bright, with a tint.
+            double scale = 2 * unit(random);
+
+            color.red = white.red * scale + random() % 50;
+            color.green = white.green * scale + random() % 50;
+            color.blue = white.blue * scale * (0.8 + 0.4 * unit(random));
+        }
+        else
+        {
+            color.red = randomCode(random);
+            color.green = randomCode(random);
+            color.blue = randomCode(random);
+        }
+
+        const sfe_color_t *reference = (i & 1) ? &white : nullptr;
+        sfe_opt4048_color_spaces_t spaces;
+        double xyz[3];
+
+        opt4048CalculateColorSpaces(&color, reference, &spaces);
+        referenceXYZ(&color, reference, xyz);
+
+        // Outside the sensor's gamut, or beyond the checked brightness.
+        if (!std::isfinite(xyz[1]) || xyz[1] <= 0 || xyz[0] < 0 || xyz[2] < 0 || xyz[1] > kBrightLimit ||
+            xyz[0] > kBrightLimit * kWhiteX || xyz[2] > kBrightLimit * kWhiteZ)
+            continue;
+
+        Lab lab = referenceLab(xyz);
+        Lab luv = referenceLuv(xyz);
+        double labError = maxDifference(toDouble(spaces.lab), lab);
+        double luvError = maxDifference(toDouble(spaces.luv), luv);
+
+        if (xyz[1] > 1)
+        {
+            errors.brightLab = fmax(errors.brightLab, labError);
+            errors.brightLuv = fmax(errors.brightLuv, luvError);
+            errors.brightSamples++;
+            continue;
+        }
+
+        errors.lab = fmax(errors.lab, labError);
+        errors.luv = fmax(errors.luv, luvError);
+        errors.samples++;
+
+        double linear[3] = {3.2406 * xyz[0] - 1.5372 * xyz[1] - 0.4986 * xyz[2],
+                            -0.9689 * xyz[0] + 1.8758 * xyz[1] + 0.0415 * xyz[2],
+                            0.0557 * xyz[0] - 0.2040 * xyz[1] + 1.0570 * xyz[2]};
+        uint8_t rgb[3] = {spaces.rgb.red, spaces.rgb.green, spaces.rgb.blue};
+
+        for (int k = 0; k < 3; k++)
+            errors.rgb = fmax(errors.rgb, fabs(rgb[k] - referenceGamma(linear[k])));
+
+        // The differences are checked on the library's own CIELAB values, so they show the error of the
+        // difference formulas alone.
+        Lab lab1 = toDouble(previous);
+        Lab lab2 = toDouble(spaces.lab);
+        double deltaE76 = sqrt(pow(lab1.L - lab2.L, 2) + pow(lab1.a - lab2.a, 2) + pow(lab1.b - lab2.b, 2));
+
+        errors.deltaE76 =
+            fmax(errors.deltaE76, fabs(opt4048DeltaE76(&previous, &spaces.lab) / (double)OPT4048_LAB_ONE - deltaE76));
+        errors.deltaE2000 =
+            fmax(errors.deltaE2000, fabs(opt4048DeltaE2000(&previous, &spaces.lab) / (double)OPT4048_LAB_ONE -
+                                         referenceDeltaE2000(lab1, lab2)));
+        previous = spaces.lab;
+    }
+
+    int failures = 0;
+
+    printf("%d samples up to the white, %d up to %g times brighter\n", errors.samples, errors.brightSamples,
+           kBrightLimit);
+    failures += check("sRGB", errors.rgb, kMaxRgbError);
+    failures += check("CIELAB", errors.lab, kMaxLabError);
+    failures += check("CIELUV", errors.luv, kMaxLabError);
+    failures += check("CIELAB brighter", errors.brightLab, kMaxBrightLabError);
+    failures += check("CIELUV brighter", errors.brightLuv, kMaxBrightLabError);
+    failures += check("Delta E 1976", errors.deltaE76, kMaxDeltaE76Error);
+    failures += check("Delta E 2000", errors.deltaE2000, kMaxDeltaE2000Error);
+
+    printf(failures ? "FAILED\n" : "OK\n");
+
+    return failures ? 1 : 0;
+}
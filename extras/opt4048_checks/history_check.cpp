@@ -0,0 +1,167 @@
+/*
+history_check.cpp
+
+SparkFun Tristimulus Color Sensor - OPT4048
+
+Qwiic 1x1
+* https://www.sparkfun.com/products/
+Qwiic Mini
+* https://www.sparkfun.com/products/
+
+Repository:
+* https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+The MIT License (MIT)
+
+Copyright (c) 2022 SparkFun Electronics
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions: The
+above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED
+"AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+License(http://opensource.org/licenses/MIT).
+
+Round trip check of QwOpt4048History: every code that goes in must come back
+out exactly. Covers raw codes (a 20 bit mantissa shifted left), codes that are
+not, as produced by the filters or the dark table, extremes, and a full buffer.
+
+*/
+#include "sfe_opt4048_history.h"
+
+#include <cinttypes>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace
+{
+
+int failures = 0;
+
+// Adds the samples until the history is full, then reads them back and compares.
+void roundTrip(const char *name, const std::vector<sfe_color_t> &samples)
+{
+    static uint8_t storage[4096];
+    QwOpt4048History history(storage, sizeof(storage));
+    sfe_color_t color;
+    size_t added = 0;
+    size_t checked = 0;
+
+    while (added < samples.size() && history.add(&samples[added]))
+        added++;
+
+    history.rewind();
+
+    while (history.next(&color))
+    {
+        const sfe_color_t &expected = samples[checked];
+
+        if (color.red != expected.red || color.green != expected.green || color.blue != expected.blue ||
+            color.white != expected.white || color.counterR != (expected.counterR & 0x0F))
+        {
+            if (failures++ < 10)
+                printf("%s: sample %zu: %" PRIu32 " %" PRIu32 " %" PRIu32 " %" PRIu32 " came back as %" PRIu32
+                       " %" PRIu32 " %" PRIu32 " %" PRIu32 "\n",
+                       name, checked, expected.red, expected.green, expected.blue, expected.white, color.red,
+                       color.green, color.blue, color.white);
+        }
+
+        checked++;
+    }
+
+    if (checked != added)
+    {
+        failures++;
+        printf("%s: %zu samples added, %zu read\n", name, added, checked);
+    }
+
+    printf("%-12s %5zu samples, %5u bytes, %5.2f bytes per sample\n", name, added, history.getBytesUsed(),
+           added ? (double)history.getBytesUsed() / added : 0.0);
+}
+
+sfe_color_t makeSample(uint32_t red, uint32_t green, uint32_t blue, uint32_t white, uint8_t counter)
+{
+    sfe_color_t color = {};
+
+    color.red = red;
+    color.green = green;
+    color.blue = blue;
+    color.white = white;
+    color.counterR = counter;
+
+    return color;
+}
+
+} // namespace
+
+int main()
+{
+    std::mt19937 random(4048);
+    std::vector<sfe_color_t> samples;
+
+    // Raw codes of a steady light with a little noise.
+    for (uint32_t i = 0; i < 2000; i++)
+    {
+        uint32_t mantissa = 500000 + random() % 8;
+        samples.push_back(makeSample(mantissa << 3, mantissa << 3, (mantissa - 1000) << 3, mantissa << 4, i));
+    }
+    roundTrip("raw steady", samples);
+
+    // Raw codes over every exponent.
+    samples.clear();
+    for (uint32_t i = 0; i < 2000; i++)
+    {
+        uint32_t codes[4];
+
+        for (uint32_t &code : codes)
+            code = (random() & 0xFFFFF) << (random() % 9);
+
+        samples.push_back(makeSample(codes[0], codes[1], codes[2], codes[3], i));
+    }
+    roundTrip("raw random", samples);
+
+    // Codes that are not a mantissa shifted left: filter outputs and dark corrected codes.
+    samples.clear();
+    samples.push_back(makeSample(4194299, 1234567, 134217731, 268435455, 0));
+    for (uint32_t i = 1; i < 2000; i++)
+    {
+        uint32_t codes[4];
+
+        for (uint32_t &code : codes)
+            code = random() & 0x0FFFFFFF;
+
+        samples.push_back(makeSample(codes[0], codes[1], codes[2], codes[3], i));
+    }
+    roundTrip("unaligned", samples);
+
+    // A slowly varying unaligned signal, like a filter output.
+    samples.clear();
+    for (uint32_t i = 0; i < 2000; i++)
+    {
+        uint32_t base = 3000000 + i * 37 + random() % 5;
+        samples.push_back(makeSample(base, base + 1, base * 3 + 7, base * 2 + 1, i));
+    }
+    roundTrip("filtered", samples);
+
+    // Extremes, including the whole 32 bit range.
+    samples.clear();
+    samples.push_back(makeSample(0, 0xFFFFFFFF, 1, 0x80000000, 0));
+    samples.push_back(makeSample(0xFFFFFFFF, 0, 0x80000001, 1, 1));
+    samples.push_back(makeSample(0xFFFFF << 8, 0xFFFFF, (0xFFFFF << 8) + 1, 0xFFFFE, 2));
+    samples.push_back(makeSample(0, 0, 0, 0, 3));
+    roundTrip("extremes", samples);
+
+    printf(failures ? "FAILED\n" : "OK\n");
+
+    return failures ? 1 : 0;
+}
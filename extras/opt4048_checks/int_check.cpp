@@ -0,0 +1,148 @@
+/*
+int_check.cpp
+
+SparkFun Tristimulus Color Sensor - OPT4048
+
+Qwiic 1x1
+* https://www.sparkfun.com/products/
+Qwiic Mini
+* https://www.sparkfun.com/products/
+
+Repository:
+* https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+The MIT License (MIT)
+
+Copyright (c) 2022 SparkFun Electronics
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions: The
+above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED
+"AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+License(http://opensource.org/licenses/MIT).
+Check of the INT pin direction and the simulated INT pin of
+../opt4048_replay. A data ready pin is an output: the INT_CONTROL images of
+QwOpt4048Static and the setIntInput() setter must set INT_DIR for it, and the
+simulated sensor only pulses its pin when configured that way.
+
+*/
+#include "sfe_opt4048_static.h"
+#include "trace_replay.h"
+
+#include <cstdio>
+
+using sfe_OPT4048::hostMicros;
+using sfe_OPT4048::hostSetMicros;
+using sfe_OPT4048::SimulatedOpt4048;
+
+namespace
+{
+
+using Output = QwOpt4048Static<RANGE_AUTO, CONVERSION_TIME_1MS, OPERATION_MODE_CONTINUOUS>;
+using Input = QwOpt4048Static<RANGE_AUTO, CONVERSION_TIME_1MS, OPERATION_MODE_CONTINUOUS, INT_DR_ALL_CHANNELS,
+                              THRESH_CHANNEL_CH0, FAULT_COUNT_1, true, false, true>;
+using Alert = QwOpt4048Static<RANGE_AUTO, CONVERSION_TIME_1MS, OPERATION_MODE_CONTINUOUS, INT_SMBUS_ALERT>;
+
+// The image of the defaults is the power-on INT_CONTROL with data ready for all channels.
+static_assert(Output::kIntControl == (OPT4048_INT_CONTROL_DEFAULT | (INT_DR_ALL_CHANNELS << 2)),
+              "default INT_CONTROL image is not a data ready output");
+static_assert((Input::kIntControl & 0x0010) == 0, "IntInput does not clear INT_DIR");
+
+int failures = 0;
+
+void expect(const char *name, bool condition)
+{
+    printf("%-24s %s\n", name, condition ? "OK" : "FAILED");
+
+    if (!condition)
+        failures++;
+}
+
+uint16_t readIntControl(QwOpt4048 &sensor)
+{
+    uint8_t buff[2];
+
+    if (sensor.readRegisterRegion(SFE_OPT4048_REGISTER_INT_CONTROL, buff) != 0)
+        return 0;
+
+    return buff[0] << 8 | buff[1];
+}
+
+// Counts the pulses of the simulated pin over the next ten sample periods, moving the clock to each one.
+int countPulses(SimulatedOpt4048 &device)
+{
+    uint64_t endUs = hostMicros() + 10 * Output::kSamplePeriodUs;
+    uint64_t due;
+    int pulses = 0;
+
+    while ((due = device.getNextInterruptUs()) != 0 && due <= endUs)
+    {
+        hostSetMicros(due);
+        pulses++;
+    }
+
+    return pulses;
+}
+
+} // namespace
+
+int main()
+{
+    hostSetMicros(1000000);
+
+    {
+        SimulatedOpt4048 device;
+        Output sensor;
+
+        sensor.setCommunicationBus(device, OPT4048_ADDR_DEF);
+        expect("static output", sensor.init() && readIntControl(sensor) == Output::kIntControl);
+        expect("static output pulses", countPulses(device) == 10);
+    }
+
+    {
+        SimulatedOpt4048 device;
+        Input sensor;
+
+        sensor.setCommunicationBus(device, OPT4048_ADDR_DEF);
+        expect("static input", sensor.init() && sensor.getIntInputEnable());
+        expect("static input pulses", countPulses(device) == 0);
+    }
+
+    {
+        SimulatedOpt4048 device;
+        Alert sensor;
+
+        sensor.setCommunicationBus(device, OPT4048_ADDR_DEF);
+        expect("static alert", sensor.init() && !sensor.getIntInputEnable());
+        expect("static alert pulses", countPulses(device) == 0);
+    }
+
+    // The setter on a running sensor: an input stops the pulses, an output brings them back.
+    {
+        SimulatedOpt4048 device;
+        Output sensor;
+
+        sensor.setCommunicationBus(device, OPT4048_ADDR_DEF);
+        sensor.init();
+        expect("setter input", sensor.setIntInput(true) && (readIntControl(sensor) & 0x0010) == 0 &&
+                                   sensor.getIntInputEnable());
+        expect("setter input pulses", countPulses(device) == 0);
+        expect("setter output", sensor.setIntInput(false) && readIntControl(sensor) == Output::kIntControl &&
+                                    !sensor.getIntInputEnable());
+        expect("setter output pulses", countPulses(device) == 10);
+    }
+
+    printf(failures ? "FAILED\n" : "OK\n");
+
+    return failures ? 1 : 0;
+}
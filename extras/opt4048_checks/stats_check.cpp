@@ -0,0 +1,161 @@
+/*
+stats_check.cpp
+
+SparkFun Tristimulus Color Sensor - OPT4048
+
+Qwiic 1x1
+* https://www.sparkfun.com/products/
+Qwiic Mini
+* https://www.sparkfun.com/products/
+
+Repository:
+* https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+The MIT License (MIT)
+
+Copyright (c) 2022 SparkFun Electronics
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions: The
+above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED
+"AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+License(http://opensource.org/licenses/MIT).
+
+Precision check of QwOpt4048Stats at large codes, where a running mean and
+variance lose precision first. Means and variances of noisy channels are
+compared against exact integer sums, for one accumulator and for two merged
+ones. Built twice: stats_check with the host's double, and stats_check_avr with
+double as a 32 bit float like on AVR, see avr_double.h.
+
+*/
+#include "sfe_opt4048_stats.h"
+
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace
+{
+
+// Largest errors accepted: a mean is returned in the precision of double, so on AVR it can be off by half a
+// step of a 24 bit mantissa, 1 code between 2^24 and 2^25.
+constexpr float kMaxMeanError = 1.01f;
+constexpr float kMaxVarianceError = 1e-3f;
+
+constexpr uint32_t kSamples = 100000;
+
+const char *const kNames[4] = {"red", "green", "blue", "white"};
+
+// Exact statistics of one channel from integer sums.
+struct Exact
+{
+    uint32_t first = 0;
+    int64_t sum = 0;
+    int64_t sumSquares = 0;
+    uint32_t count = 0;
+
+    void add(uint32_t code)
+    {
+        if (count++ == 0)
+            first = code;
+
+        int64_t offset = (int64_t)code - first;
+        sum += offset;
+        sumSquares += offset * offset;
+    }
+
+    // Mean relative to the first code, variance divided by count - 1.
+    void get(float *mean, float *variance) const
+    {
+        *mean = (float)sum / count;
+        *variance = (float)(count * sumSquares - sum * sum) / ((float)count * (count - 1));
+    }
+};
+
+int failures = 0;
+
+void compare(const char *name, QwOpt4048Stats &stats, const Exact *exact)
+{
+    for (uint8_t ch = 0; ch < 4; ch++)
+    {
+        float mean;
+        float variance;
+
+        exact[ch].get(&mean, &variance);
+
+        // The mean is compared relative to the first code; in a 32 bit double the code itself is not exact.
+        float meanError = std::fabs((float)(stats.getMean((opt4048_stat_t)ch) - exact[ch].first) - mean);
+        float varianceError = std::fabs((float)stats.getVariance((opt4048_stat_t)ch) / variance - 1);
+        bool ok = meanError <= kMaxMeanError && varianceError <= kMaxVarianceError;
+
+        if (!ok)
+            failures++;
+
+        printf("%-8s %-6s mean %12.2f error %6.3f  variance %8.2f error %8.5f %%  %s\n", name, kNames[ch],
+               (float)stats.getMean((opt4048_stat_t)ch), meanError, (float)stats.getVariance((opt4048_stat_t)ch),
+               varianceError * 100, ok ? "" : "FAILED");
+    }
+}
+
+} // namespace
+
+int main()
+{
+    std::mt19937 random(4048);
+    std::normal_distribution<float> noise(0, 18);
+    const uint32_t levels[4] = {20000000, 21000000, 50000, 30000000};
+    QwOpt4048Stats all;
+    QwOpt4048Stats first;
+    QwOpt4048Stats second;
+    Exact exact[4];
+
+    printf("double is %u bits\n", (unsigned)(sizeof(double) * 8));
+
+    for (uint32_t i = 0; i < kSamples; i++)
+    {
+        sfe_color_t color = {};
+        sfe_cie_t cie;
+        uint32_t codes[4];
+
+        // A slow drift of a few hundred codes under the noise.
+        for (uint8_t ch = 0; ch < 4; ch++)
+        {
+            codes[ch] = levels[ch] + (int32_t)std::lround(noise(random)) + i / 500;
+            exact[ch].add(codes[ch]);
+        }
+
+        color.red = codes[0];
+        color.green = codes[1];
+        color.blue = codes[2];
+        color.white = codes[3];
+        opt4048CalculateCIE(&color, &cie);
+
+        all.add(&color, &cie);
+
+        if (i < kSamples / 3)
+            first.add(&color, &cie);
+        else
+            second.add(&color, &cie);
+    }
+
+    first.merge(second);
+
+    compare("single", all, exact);
+    compare("merged", first, exact);
+
+    printf(failures ? "FAILED\n" : "OK\n");
+
+    return failures ? 1 : 0;
+}
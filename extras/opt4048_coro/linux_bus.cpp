@@ -0,0 +1,157 @@
+/*
+linux_bus.cpp
+
+SparkFun Tristimulus Color Sensor - OPT4048
+
+Qwiic 1x1
+* https://www.sparkfun.com/products/
+Qwiic Mini
+* https://www.sparkfun.com/products/
+
+Repository:
+* https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+The MIT License (MIT)
+
+Copyright (c) 2022 SparkFun Electronics
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions: The
+above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED
+"AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+License(http://opensource.org/licenses/MIT).
+
+The following functions implement the Linux hardware access declared in
+linux_bus.h.
+
+*/
+#include "linux_bus.h"
+
+#include <cstring>
+#include <fcntl.h>
+#include <linux/gpio.h>
+#include <linux/i2c-dev.h>
+#include <linux/i2c.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#include <vector>
+
+namespace sfe_OPT4048
+{
+
+// SMBus Alert Response Address, answered by every device asserting ALERT.
+#define kAlertResponseAddress 0x0C
+
+static int i2cTransfer(int fd, struct i2c_msg *messages, uint32_t count)
+{
+    struct i2c_rdwr_ioctl_data transfer;
+
+    if (fd < 0)
+        return -1;
+
+    transfer.msgs = messages;
+    transfer.nmsgs = count;
+
+    return ioctl(fd, I2C_RDWR, &transfer) == (int)count ? 0 : -1;
+}
+
+LinuxI2CBus::~LinuxI2CBus()
+{
+    end();
+}
+
+bool LinuxI2CBus::begin(const char *device)
+{
+    end();
+
+    _fd = open(device, O_RDWR | O_CLOEXEC);
+
+    return _fd >= 0;
+}
+
+void LinuxI2CBus::end()
+{
+    if (_fd >= 0)
+        close(_fd);
+
+    _fd = -1;
+}
+
+bool LinuxI2CBus::ping(uint8_t address)
+{
+    // An empty write, like QwI2C: nothing is read, so no flag is cleared.
+    struct i2c_msg message = {address, 0, 0, nullptr};
+
+    return i2cTransfer(_fd, &message, 1) == 0;
+}
+
+int LinuxI2CBus::writeRegisterRegion(uint8_t address, uint8_t offset, uint8_t *data, uint16_t length)
+{
+    std::vector<uint8_t> buffer(length + 1);
+
+    buffer[0] = offset;
+    memcpy(&buffer[1], data, length);
+
+    struct i2c_msg message = {address, 0, (uint16_t)buffer.size(), buffer.data()};
+
+    return i2cTransfer(_fd, &message, 1);
+}
+
+int LinuxI2CBus::readRegisterRegion(uint8_t addr, uint8_t reg, uint8_t *data, uint16_t numBytes)
+{
+    struct i2c_msg messages[2] = {{addr, 0, 1, &reg}, {addr, I2C_M_RD, numBytes, data}};
+
+    return i2cTransfer(_fd, messages, 2);
+}
+
+int LinuxI2CBus::alertResponse(uint8_t *response)
+{
+    struct i2c_msg message = {kAlertResponseAddress, I2C_M_RD, 1, response};
+
+    return i2cTransfer(_fd, &message, 1);
+}
+
+int openGpioInterrupt(const char *chip, uint32_t line, bool activeHigh)
+{
+    struct gpio_v2_line_request request;
+    int chipFd;
+    int result;
+
+    chipFd = open(chip, O_RDWR | O_CLOEXEC);
+    if (chipFd < 0)
+        return -1;
+
+    memset(&request, 0, sizeof(request));
+    request.offsets[0] = line;
+    request.num_lines = 1;
+    request.config.flags = GPIO_V2_LINE_FLAG_INPUT | (activeHigh ? GPIO_V2_LINE_FLAG_EDGE_RISING
+                                                                  : GPIO_V2_LINE_FLAG_EDGE_FALLING);
+    strncpy(request.consumer, "opt4048-int", sizeof(request.consumer) - 1);
+
+    result = ioctl(chipFd, GPIO_V2_GET_LINE_IOCTL, &request);
+    close(chipFd);
+
+    if (result < 0)
+        return -1;
+
+    // The line stays requested while its descriptor is open.
+    if (fcntl(request.fd, F_SETFL, fcntl(request.fd, F_GETFL) | O_NONBLOCK) < 0)
+    {
+        close(request.fd);
+        return -1;
+    }
+
+    return request.fd;
+}
+
+} // namespace sfe_OPT4048
@@ -0,0 +1,83 @@
+/*
+linux_bus.h
+
+SparkFun Tristimulus Color Sensor - OPT4048
+
+Qwiic 1x1
+* https://www.sparkfun.com/products/
+Qwiic Mini
+* https://www.sparkfun.com/products/
+
+Repository:
+* https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+The MIT License (MIT)
+
+Copyright (c) 2022 SparkFun Electronics
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions: The
+above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED
+"AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+License(http://opensource.org/licenses/MIT).
+
+Linux hardware access for the OPT4048 driver on a host: a QwDeviceBus on an
+i2c-dev adapter, and the INT pin as a GPIO line event file descriptor for
+AsyncOpt4048. Both use the kernel interfaces directly, no libraries needed.
+
+*/
+#pragma once
+#include "sfe_bus.h"
+#include <cstdint>
+
+namespace sfe_OPT4048
+{
+
+/// @brief QwDeviceBus on a Linux I2C adapter through i2c-dev, e.g. /dev/i2c-1 on a Raspberry Pi. Reads use
+///        a repeated start, like QwI2C.
+class LinuxI2CBus : public QwDeviceBus
+{
+  public:
+    LinuxI2CBus() = default;
+    ~LinuxI2CBus();
+
+    LinuxI2CBus(const LinuxI2CBus &) = delete;
+    LinuxI2CBus &operator=(const LinuxI2CBus &) = delete;
+
+    /// @brief Opens the adapter.
+    /// @param device The adapter's device node.
+    /// @return True on success.
+    bool begin(const char *device);
+
+    /// @brief Closes the adapter.
+    void end();
+
+    bool ping(uint8_t address) override;
+    int writeRegisterRegion(uint8_t address, uint8_t offset, uint8_t *data, uint16_t length) override;
+    int readRegisterRegion(uint8_t addr, uint8_t reg, uint8_t *data, uint16_t numBytes) override;
+    int alertResponse(uint8_t *response) override;
+
+  private:
+    int _fd = -1;
+};
+
+/// @brief Requests a GPIO line wired to the INT pin as an edge triggered input, through the GPIO character
+///        device (the interface libgpiod is built on).
+/// @param chip The GPIO chip's device node, e.g. /dev/gpiochip0.
+/// @param line The line offset on the chip.
+/// @param activeHigh As set with setIntActiveHigh(): rising edges if true, falling edges if false.
+/// @return Non-blocking file descriptor that becomes readable with each edge, for
+///         AsyncOpt4048::setInterruptFd(), or -1 on failure. Close it to release the line.
+int openGpioInterrupt(const char *chip, uint32_t line, bool activeHigh);
+
+} // namespace sfe_OPT4048
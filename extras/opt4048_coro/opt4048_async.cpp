@@ -0,0 +1,314 @@
+/*
+opt4048_async.cpp
+
+SparkFun Tristimulus Color Sensor - OPT4048
+
+Qwiic 1x1
+* https://www.sparkfun.com/products/
+Qwiic Mini
+* https://www.sparkfun.com/products/
+
+Repository:
+* https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+The MIT License (MIT)
+
+Copyright (c) 2022 SparkFun Electronics
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions: The
+above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED
+"AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+License(http://opensource.org/licenses/MIT).
+
+The following functions implement the coroutine layer declared in
+opt4048_async.h: the epoll event loop and the coroutine interface to the
+driver.
+
+*/
+#include "opt4048_async.h"
+#include "sfe_opt4048_log_format.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+namespace sfe_OPT4048
+{
+
+// Events handled per turn of the loop.
+#define kMaxEvents 16
+
+// Power-on value of the high threshold (register 0x09); the low threshold powers on as 0.
+#define kThresholdHighDefault 0xBFFF
+
+EpollLoop::EpollLoop()
+{
+    struct epoll_event event = {};
+
+    _epollFd = epoll_create1(EPOLL_CLOEXEC);
+    _timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+
+    // The timer is the only event without a wait attached.
+    event.events = EPOLLIN;
+    event.data.ptr = nullptr;
+
+    if (_epollFd >= 0 && _timerFd >= 0)
+        epoll_ctl(_epollFd, EPOLL_CTL_ADD, _timerFd, &event);
+}
+
+EpollLoop::~EpollLoop()
+{
+    // Destroys the suspended coroutines before the descriptors their waits refer to.
+    _tasks.clear();
+
+    if (_timerFd >= 0)
+        close(_timerFd);
+
+    if (_epollFd >= 0)
+        close(_epollFd);
+}
+
+void EpollLoop::schedule(Wait *wait)
+{
+    struct epoll_event event = {};
+
+    wait->readable = false;
+
+    if (wait->fd >= 0)
+    {
+        event.events = EPOLLIN | EPOLLONESHOT;
+        event.data.ptr = wait;
+
+        // A descriptor can only be waited on by one coroutine at a time; a second wait sees the deadline only.
+        if (epoll_ctl(_epollFd, EPOLL_CTL_ADD, wait->fd, &event) != 0)
+            wait->fd = -1;
+    }
+
+    _waits.push_back(wait);
+}
+
+void EpollLoop::spawn(Task<void> task)
+{
+    std::coroutine_handle<> handle = task.handle();
+
+    _tasks.push_back(std::move(task));
+    handle.resume();
+}
+
+void EpollLoop::stop()
+{
+    _stopped = true;
+}
+
+void EpollLoop::resume(Wait *wait, bool readable)
+{
+    if (wait->fd >= 0)
+        epoll_ctl(_epollFd, EPOLL_CTL_DEL, wait->fd, nullptr);
+
+    wait->readable = readable;
+    wait->handle.resume();
+}
+
+void EpollLoop::armTimer(uint64_t deadlineUs)
+{
+    struct itimerspec timer = {};
+
+    if (deadlineUs == _timerUs)
+        return;
+
+    // A zero expiration disarms the timer, which is right for kNoDeadline only.
+    if (deadlineUs != Wait::kNoDeadline)
+    {
+        timer.it_value.tv_sec = deadlineUs / 1000000;
+        timer.it_value.tv_nsec = (deadlineUs % 1000000) * 1000 + 1;
+    }
+
+    timerfd_settime(_timerFd, TFD_TIMER_ABSTIME, &timer, nullptr);
+    _timerUs = deadlineUs;
+}
+
+bool EpollLoop::run()
+{
+    struct epoll_event events[kMaxEvents];
+    std::vector<std::pair<Wait *, bool>> ready;
+    uint64_t expirations;
+
+    if (_epollFd < 0 || _timerFd < 0)
+        return false;
+
+    _stopped = false;
+
+    while (!_stopped)
+    {
+        _tasks.erase(std::remove_if(_tasks.begin(), _tasks.end(), [](const Task<void> &task) { return task.done(); }),
+                     _tasks.end());
+
+        if (_tasks.empty())
+            return true;
+
+        // Suspended on something other than the loop, nothing will resume it.
+        if (_waits.empty())
+            return false;
+
+        uint64_t deadlineUs = Wait::kNoDeadline;
+        for (Wait *wait : _waits)
+            deadlineUs = std::min(deadlineUs, wait->deadlineUs);
+
+        // On the system clock the timer wakes epoll; on the virtual clock only ready descriptors are polled.
+        if (hostSystemClock())
+            armTimer(deadlineUs);
+
+        int count = epoll_wait(_epollFd, events, kMaxEvents, hostSystemClock() ? -1 : 0);
+
+        if (count < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            return false;
+        }
+
+        if (count == 0 && !hostSystemClock())
+        {
+            // Nothing else can make a descriptor readable while virtual time stands still.
+            if (deadlineUs == Wait::kNoDeadline)
+                return false;
+
+            hostAdvanceTo(deadlineUs);
+        }
+
+        ready.clear();
+
+        for (int i = 0; i < count; i++)
+        {
+            if (events[i].data.ptr)
+                ready.emplace_back((Wait *)events[i].data.ptr, true);
+            else if (read(_timerFd, &expirations, sizeof(expirations)) > 0)
+                _timerUs = Wait::kNoDeadline;
+        }
+
+        uint64_t now = hostMicros();
+
+        for (Wait *wait : _waits)
+        {
+            if (wait->deadlineUs <= now &&
+                std::find_if(ready.begin(), ready.end(), [wait](const auto &entry) { return entry.first == wait; }) ==
+                    ready.end())
+                ready.emplace_back(wait, false);
+        }
+
+        // Taken off the list before resuming, as the coroutines schedule their next waits.
+        for (const auto &entry : ready)
+            _waits.erase(std::find(_waits.begin(), _waits.end(), entry.first));
+
+        for (const auto &entry : ready)
+            resume(entry.first, entry.second);
+    }
+
+    return true;
+}
+
+AsyncOpt4048::AsyncOpt4048(QwOpt4048 &sensor, Scheduler &scheduler) : _sensor(sensor), _scheduler(scheduler)
+{
+}
+
+void AsyncOpt4048::setInterruptFd(int fd)
+{
+    _interruptFd = fd;
+}
+
+void AsyncOpt4048::drainInterrupt()
+{
+    // Large enough for several GPIO line events, and for the 8 byte counter of an eventfd.
+    uint8_t buffer[256];
+
+    if (_interruptFd < 0)
+        return;
+
+    while (read(_interruptFd, buffer, sizeof(buffer)) > 0)
+        ;
+}
+
+Task<bool> AsyncOpt4048::configure(sfe_opt4048_config_t config)
+{
+    bool success = _sensor.restoreConfiguration(&config);
+
+    // The first sample of the new setting is a full period away, so any event pending now is stale.
+    drainInterrupt();
+
+    co_return success;
+}
+
+Task<bool> AsyncOpt4048::nextSample(sfe_color_t *color, uint32_t timeoutMs)
+{
+    uint64_t deadlineUs = hostMicros() + timeoutMs * 1000ULL;
+    uint32_t wait;
+
+    while (hostMicros() < deadlineUs)
+    {
+        if (_interruptFd >= 0)
+        {
+            uint64_t period = _sensor.getSamplePeriodUs();
+
+            if (co_await _scheduler.readable(_interruptFd, std::min(deadlineUs, hostMicros() + period + period / 2)))
+            {
+                drainInterrupt();
+                co_return _sensor.getAllChannelData(color);
+            }
+
+            // The event was missed, or the pin is not set up: the flag tells.
+            if (_sensor.getConvReadyFlag())
+                co_return _sensor.getAllChannelData(color);
+
+            continue;
+        }
+
+        if (!_sensor.getSampleWait(&wait))
+            co_return false;
+
+        if (wait > 0)
+        {
+            co_await _scheduler.sleepUntil(std::min(deadlineUs, hostMicros() + wait));
+            continue;
+        }
+
+        // When the flag is not set yet, pollSample() moves the prediction back a little.
+        if (_sensor.pollSample())
+            co_return _sensor.getAllChannelData(color);
+    }
+
+    co_return false;
+}
+
+sfe_opt4048_config_t AsyncOpt4048::makeConfig(uint16_t control, uint16_t intControl)
+{
+    sfe_opt4048_config_t config = {};
+    uint16_t regs[4] = {0, kThresholdHighDefault, control, intControl};
+
+    for (uint8_t i = 0; i < 4; i++)
+    {
+        config.regs[i * 2] = regs[i] >> 8;
+        config.regs[i * 2 + 1] = regs[i];
+    }
+
+    config.magic = OPT4048_CONFIG_MAGIC;
+    config.checksum = opt4048LogChecksum((const uint8_t *)&config, offsetof(sfe_opt4048_config_t, checksum));
+
+    return config;
+}
+
+} // namespace sfe_OPT4048
@@ -0,0 +1,353 @@
+/*
+opt4048_async.h
+
+SparkFun Tristimulus Color Sensor - OPT4048
+
+Qwiic 1x1
+* https://www.sparkfun.com/products/
+Qwiic Mini
+* https://www.sparkfun.com/products/
+
+Repository:
+* https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+The MIT License (MIT)
+
+Copyright (c) 2022 SparkFun Electronics
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions: The
+above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED
+"AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+License(http://opensource.org/licenses/MIT).
+
+C++20 coroutine layer over the OPT4048 driver for event loops on a host, e.g.
+a Linux gateway. A coroutine waits for the next sample with
+
+    co_await sensor.nextSample(&color);
+
+and the thread serves other work meanwhile. Waits end at the predicted
+completion of the sample, or when the INT pin's file descriptor (GPIO line
+events, an eventfd) becomes readable. Scheduler is the interface to the event
+loop; EpollLoop implements it on epoll, and runs on the virtual host clock too,
+so the layer is tested against SimulatedOpt4048 at full speed.
+
+Bus transfers stay blocking, about half a millisecond for a sample at 400 kHz.
+
+Requires C++20.
+
+*/
+#pragma once
+#include "sfe_opt4048.h"
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace sfe_OPT4048
+{
+
+template <typename T> class Task;
+
+// Coroutine frame state shared by every Task: whom to resume on completion.
+class TaskPromiseBase
+{
+  public:
+    struct FinalAwaiter
+    {
+        bool await_ready() noexcept
+        {
+            return false;
+        }
+
+        template <typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept
+        {
+            std::coroutine_handle<> continuation = handle.promise().continuation;
+
+            return continuation ? continuation : std::noop_coroutine();
+        }
+
+        void await_resume() noexcept
+        {
+        }
+    };
+
+    std::suspend_always initial_suspend() noexcept
+    {
+        return {};
+    }
+
+    FinalAwaiter final_suspend() noexcept
+    {
+        return {};
+    }
+
+    // The driver does not throw; an exception here is a bug in the application.
+    void unhandled_exception() noexcept
+    {
+        std::terminate();
+    }
+
+    std::coroutine_handle<> continuation;
+};
+
+template <typename T> class TaskPromise : public TaskPromiseBase
+{
+  public:
+    Task<T> get_return_object() noexcept;
+
+    void return_value(T value)
+    {
+        result = std::move(value);
+    }
+
+    std::optional<T> result;
+};
+
+template <> class TaskPromise<void> : public TaskPromiseBase
+{
+  public:
+    Task<void> get_return_object() noexcept;
+
+    void return_void() noexcept
+    {
+    }
+};
+
+/// @brief A coroutine returning T. It starts when awaited, or when handed to EpollLoop::spawn(), and
+///        resumes its awaiter when it completes.
+template <typename T = void> class [[nodiscard]] Task
+{
+  public:
+    using promise_type = TaskPromise<T>;
+
+    explicit Task(std::coroutine_handle<promise_type> handle) : _handle(handle)
+    {
+    }
+
+    Task(Task &&other) noexcept : _handle(std::exchange(other._handle, nullptr))
+    {
+    }
+
+    Task &operator=(Task &&other) noexcept
+    {
+        if (this != &other)
+        {
+            if (_handle)
+                _handle.destroy();
+
+            _handle = std::exchange(other._handle, nullptr);
+        }
+
+        return *this;
+    }
+
+    Task(const Task &) = delete;
+    Task &operator=(const Task &) = delete;
+
+    ~Task()
+    {
+        if (_handle)
+            _handle.destroy();
+    }
+
+    /// @brief True once the coroutine has completed.
+    bool done() const
+    {
+        return !_handle || _handle.done();
+    }
+
+    bool await_ready() const noexcept
+    {
+        return false;
+    }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+    {
+        _handle.promise().continuation = awaiting;
+
+        return _handle;
+    }
+
+    T await_resume()
+    {
+        if constexpr (!std::is_void_v<T>)
+            return std::move(*_handle.promise().result);
+    }
+
+    std::coroutine_handle<promise_type> handle() const
+    {
+        return _handle;
+    }
+
+  private:
+    std::coroutine_handle<promise_type> _handle;
+};
+
+template <typename T> Task<T> TaskPromise<T>::get_return_object() noexcept
+{
+    return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+}
+
+inline Task<void> TaskPromise<void>::get_return_object() noexcept
+{
+    return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+}
+
+/// @brief A suspended coroutine waiting for a file descriptor to become readable, for a deadline on the
+///        host clock, or for whichever comes first.
+struct Wait
+{
+    int fd;                        // -1 to wait for the deadline only
+    uint64_t deadlineUs;           // kNoDeadline to wait for the file descriptor only
+    bool readable;                 // Set by the scheduler: true if the file descriptor ended the wait
+    std::coroutine_handle<> handle;
+
+    static constexpr uint64_t kNoDeadline = UINT64_MAX;
+};
+
+/// @brief Interface to the event loop. An application with its own loop (sd-event, libuv, Asio) implements
+///        schedule() on it; EpollLoop is a ready-made one.
+class Scheduler
+{
+  public:
+    virtual ~Scheduler() = default;
+
+    /// @brief Resumes wait->handle once the wait is over, after setting wait->readable. The wait lives in
+    ///        the suspended coroutine's frame and stays valid until then.
+    virtual void schedule(Wait *wait) = 0;
+
+    struct WaitAwaiter
+    {
+        Scheduler &scheduler;
+        Wait wait;
+
+        bool await_ready() const noexcept
+        {
+            return false;
+        }
+
+        void await_suspend(std::coroutine_handle<> handle)
+        {
+            wait.handle = handle;
+            scheduler.schedule(&wait);
+        }
+
+        bool await_resume() const noexcept
+        {
+            return wait.readable;
+        }
+    };
+
+    /// @brief Suspends until a time on the host clock, see hostMicros().
+    WaitAwaiter sleepUntil(uint64_t us)
+    {
+        return WaitAwaiter{*this, {-1, us, false, nullptr}};
+    }
+
+    /// @brief Suspends until a file descriptor is readable or the deadline passes.
+    /// @return From co_await: true if the file descriptor is readable, false at the deadline.
+    WaitAwaiter readable(int fd, uint64_t deadlineUs = Wait::kNoDeadline)
+    {
+        return WaitAwaiter{*this, {fd, deadlineUs, false, nullptr}};
+    }
+};
+
+/// @brief Single threaded event loop on epoll and a timerfd. On the virtual host clock it jumps to the next
+///        deadline whenever no file descriptor is ready, so simulations run at full speed.
+class EpollLoop : public Scheduler
+{
+  public:
+    EpollLoop();
+    ~EpollLoop();
+
+    EpollLoop(const EpollLoop &) = delete;
+    EpollLoop &operator=(const EpollLoop &) = delete;
+
+    void schedule(Wait *wait) override;
+
+    /// @brief Starts a top level coroutine. The loop owns it until it completes.
+    void spawn(Task<void> task);
+
+    /// @brief Runs until every spawned coroutine has completed, or stop() is called.
+    /// @return False on an epoll error, or if the coroutines wait for something that can never happen.
+    bool run();
+
+    /// @brief Makes run() return after the coroutines resumed in this turn of the loop.
+    void stop();
+
+  private:
+    void resume(Wait *wait, bool readable);
+    void armTimer(uint64_t deadlineUs);
+
+    int _epollFd;
+    int _timerFd;
+    uint64_t _timerUs = Wait::kNoDeadline;
+    bool _stopped = false;
+    std::vector<Wait *> _waits;
+    std::vector<Task<void>> _tasks;
+};
+
+/// @brief Coroutine interface to a QwOpt4048. One operation at a time: a coroutine awaits nextSample() or
+///        configure() before it, or another coroutine, starts the next.
+class AsyncOpt4048
+{
+  public:
+    /// @param sensor The driver, with its bus set up.
+    /// @param scheduler The event loop to wait on.
+    AsyncOpt4048(QwOpt4048 &sensor, Scheduler &scheduler);
+
+    /// @brief Waits on the INT pin instead of the predicted conversion time. The pin has to be a data ready
+    ///        output with INT_DR_ALL_CHANNELS: INT_DIR set, as at power-on and after setIntInput(false), in
+    ///        the INT_CONTROL image passed to configure(), e.g. QwOpt4048Static<...>::kIntControl with
+    ///        IntInput left false.
+    /// @param fd Non-blocking file descriptor that becomes readable with each sample, e.g. from
+    ///        openGpioInterrupt() or an eventfd. Its data is read and discarded. -1 goes back to prediction.
+    void setInterruptFd(int fd);
+
+    /// @brief Writes a configuration image in one burst, see restoreConfiguration(). Writing CONTROL in an
+    ///        active mode starts the sample prediction; pending INT pin events are discarded.
+    /// @param config The image, e.g. from saveConfiguration() or makeConfig(). Taken by value, so it may be a
+    ///        temporary.
+    /// @return From co_await: true on success.
+    Task<bool> configure(sfe_opt4048_config_t config);
+
+    /// @brief Waits for the next sample without blocking the thread, then reads it. Without an INT pin,
+    ///        waits until the sample is predicted to complete and confirms it with one flag read. With an
+    ///        INT pin, waits for it; a missed event costs one and a half sample periods, after which the
+    ///        flag is read instead.
+    /// @param color Pointer to store the sample.
+    /// @param timeoutMs Maximum time to wait in milliseconds.
+    /// @return From co_await: true on success. False on timeout or a bus error; without an INT pin also
+    ///         right away when no conversion is running, e.g. after power down or a one-shot already read.
+    Task<bool> nextSample(sfe_color_t *color, uint32_t timeoutMs = 1000);
+
+    /// @brief Builds a configuration image for configure() without a bus access, with the thresholds at
+    ///        their power-on values.
+    /// @param control CONTROL register image, e.g. QwOpt4048Static<...>::kControl.
+    /// @param intControl INT_CONTROL register image, e.g. QwOpt4048Static<...>::kIntControl.
+    static sfe_opt4048_config_t makeConfig(uint16_t control, uint16_t intControl);
+
+  private:
+    void drainInterrupt();
+
+    QwOpt4048 &_sensor;
+    Scheduler &_scheduler;
+    int _interruptFd = -1;
+};
+
+} // namespace sfe_OPT4048
@@ -0,0 +1,267 @@
+/*
+opt4048_coro.cpp
+
+SparkFun Tristimulus Color Sensor - OPT4048
+
+Qwiic 1x1
+* https://www.sparkfun.com/products/
+Qwiic Mini
+* https://www.sparkfun.com/products/
+
+Repository:
+* https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+The MIT License (MIT)
+
+Copyright (c) 2022 SparkFun Electronics
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions: The
+above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED
+"AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+License(http://opensource.org/licenses/MIT).
+
+Command line demo of the coroutine layer: reads samples with co_await on one
+thread and writes them as CSV.
+
+    opt4048_coro [--realtime] [--int] [seconds]
+    opt4048_coro --i2c /dev/i2c-1 [--address 0x45] [--gpio /dev/gpiochip0 line] [seconds]
+
+Without --i2c the sensor is SimulatedOpt4048, on the virtual clock unless
+--realtime is given; --int adds a simulated INT pin on an eventfd. See
+README.md in this folder.
+
+*/
+#include "linux_bus.h"
+#include "opt4048_async.h"
+#include "sfe_opt4048_static.h"
+#include "trace_replay.h"
+
+#include <cerrno>
+#include <chrono>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+using namespace sfe_OPT4048;
+
+namespace
+{
+
+// Automatic range and 25 ms per channel, for a sample every 100 ms. The INT pin pulses when all four
+// channels are done.
+using Setup = QwOpt4048Static<RANGE_AUTO, CONVERSION_TIME_25MS, OPERATION_MODE_CONTINUOUS, INT_DR_ALL_CHANNELS,
+                              THRESH_CHANNEL_CH0, FAULT_COUNT_1, false>;
+
+// Virtual time at which simulations start.
+constexpr uint64_t kSimulationStartUs = 1000000;
+
+struct Options
+{
+    double seconds = 10;
+    bool realtime = false;
+    bool simulatedInterrupt = false;
+    const char *i2c = nullptr;
+    uint8_t address = OPT4048_ADDR_DEF;
+    const char *gpioChip = nullptr;
+    uint32_t gpioLine = 0;
+};
+
+struct Counters
+{
+    uint64_t samples = 0;
+    uint64_t failures = 0;
+};
+
+// Stands in for the INT pin of the simulated sensor: signals an eventfd whenever the pin, as configured in
+// the sensor's INT_CONTROL, pulses for a completed sample.
+Task<void> simulateInterrupt(Scheduler &scheduler, const SimulatedOpt4048 &device, int fd)
+{
+    const uint64_t one = 1;
+
+    while (true)
+    {
+        uint64_t due = device.getNextInterruptUs();
+
+        // Not signalling yet, look again in a millisecond.
+        co_await scheduler.sleepUntil(due ? due : hostMicros() + 1000);
+
+        if (due && write(fd, &one, sizeof(one)) < 0)
+            co_return;
+    }
+}
+
+Task<void> readSamples(EpollLoop &loop, AsyncOpt4048 &sensor, uint64_t endUs, FILE *out, Counters &counters)
+{
+    sfe_color_t color;
+    sfe_cie_t cie;
+    uint64_t startUs = hostMicros();
+
+    if (!co_await sensor.configure(AsyncOpt4048::makeConfig(Setup::kControl, Setup::kIntControl)))
+    {
+        counters.failures++;
+        loop.stop();
+        co_return;
+    }
+
+    while (hostMicros() < endUs)
+    {
+        if (!co_await sensor.nextSample(&color))
+        {
+            counters.failures++;
+            continue;
+        }
+
+        opt4048CalculateCIE(&color, &cie);
+        fprintf(out, "%" PRIu64 ",%" PRIu32 ",%" PRIu32 ",%" PRIu32 ",%" PRIu32 ",%.6f,%.6f,%.3f\n",
+                hostMicros() - startUs, color.red, color.green, color.blue, color.white, cie.CIEx, cie.CIEy, cie.lux);
+        counters.samples++;
+    }
+
+    // Also ends the simulated INT pin.
+    loop.stop();
+}
+
+int run(const Options &options)
+{
+    EpollLoop loop;
+    SimulatedOpt4048 device;
+    LinuxI2CBus bus;
+    QwOpt4048 sensor;
+    AsyncOpt4048 asyncSensor(sensor, loop);
+    Counters counters;
+    int interruptFd = -1;
+
+    if (options.i2c || options.realtime)
+        hostUseSystemClock();
+    else
+        hostSetMicros(kSimulationStartUs);
+
+    if (options.i2c)
+    {
+        if (!bus.begin(options.i2c))
+        {
+            fprintf(stderr, "cannot open %s\n", options.i2c);
+            return 1;
+        }
+
+        sensor.setCommunicationBus(bus, options.address);
+
+        if (options.gpioChip)
+        {
+            interruptFd = openGpioInterrupt(options.gpioChip, options.gpioLine, false);
+            if (interruptFd < 0)
+            {
+                fprintf(stderr, "cannot request line %" PRIu32 " of %s\n", options.gpioLine, options.gpioChip);
+                return 1;
+            }
+        }
+    }
+    else
+    {
+        sensor.setCommunicationBus(device, OPT4048_ADDR_DEF);
+
+        if (options.simulatedInterrupt)
+        {
+            interruptFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            loop.spawn(simulateInterrupt(loop, device, interruptFd));
+        }
+    }
+
+    if (!sensor.isConnected())
+    {
+        fprintf(stderr, "OPT4048 not detected\n");
+        return 1;
+    }
+
+    asyncSensor.setInterruptFd(interruptFd);
+
+    printf("time_us,red,green,blue,white,cie_x,cie_y,lux\n");
+
+    auto start = std::chrono::steady_clock::now();
+    uint64_t startUs = hostMicros();
+
+    loop.spawn(readSamples(loop, asyncSensor, startUs + (uint64_t)(options.seconds * 1e6), stdout, counters));
+
+    bool ok = loop.run();
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    fprintf(stderr, "%" PRIu64 " samples, %" PRIu64 " failures, %.1f s of sensor time in %.3f s\n", counters.samples,
+            counters.failures, (hostMicros() - startUs) / 1e6, elapsed.count());
+
+    if (interruptFd >= 0)
+        close(interruptFd);
+
+    return ok && counters.failures == 0 ? 0 : 1;
+}
+
+// Accepts a positive, finite number of seconds and nothing else.
+bool parseSeconds(const char *text, double *seconds)
+{
+    char *end;
+    double value;
+
+    errno = 0;
+    value = strtod(text, &end);
+
+    if (end == text || *end != '\0' || errno != 0 || !std::isfinite(value) || value <= 0)
+        return false;
+
+    *seconds = value;
+
+    return true;
+}
+
+void usage()
+{
+    fprintf(stderr, "usage: opt4048_coro [--realtime] [--int] [seconds]\n"
+                    "       opt4048_coro --i2c device [--address address] [--gpio chip line] [seconds]\n");
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    Options options;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--realtime"))
+            options.realtime = true;
+        else if (!strcmp(argv[i], "--int"))
+            options.simulatedInterrupt = true;
+        else if (!strcmp(argv[i], "--i2c") && i + 1 < argc)
+            options.i2c = argv[++i];
+        else if (!strcmp(argv[i], "--address") && i + 1 < argc)
+            options.address = (uint8_t)strtoul(argv[++i], nullptr, 0);
+        else if (!strcmp(argv[i], "--gpio") && i + 2 < argc)
+        {
+            options.gpioChip = argv[++i];
+            options.gpioLine = (uint32_t)strtoul(argv[++i], nullptr, 0);
+        }
+        else if (argv[i][0] != '-' && parseSeconds(argv[i], &options.seconds))
+            ;
+        else
+        {
+            usage();
+            return 2;
+        }
+    }
+
+    return run(options);
+}
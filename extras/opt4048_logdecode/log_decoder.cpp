@@ -0,0 +1,386 @@
+/*
+log_decoder.cpp
+
+SparkFun Tristimulus Color Sensor - OPT4048
+
+Qwiic 1x1
+* https://www.sparkfun.com/products/
+Qwiic Mini
+* https://www.sparkfun.com/products/
+
+Repository:
+* https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+The MIT License (MIT)
+
+Copyright (c) 2022 SparkFun Electronics
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions: The
+above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED
+"AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+License(http://opensource.org/licenses/MIT).
+
+The following functions implement the parallel log decoder declared in
+log_decoder.h.
+
+Decoding runs in two parallel passes over the mapped file. The first pass
+validates every record and counts them per chunk, along with the micros()
+wrap-arounds inside the chunk. A short sequential step turns those counts into
+row offsets and time offsets, and checks the sequence numbers across chunk
+boundaries. The second pass decodes the samples and hands them to the sink.
+
+*/
+#include "log_decoder.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+namespace sfe_OPT4048
+{
+
+void LogStats::add(const LogStats &other)
+{
+    records += other.records;
+    padding += other.padding;
+    checksumErrors += other.checksumErrors;
+    crcErrors += other.crcErrors;
+    droppedSamples += other.droppedSamples;
+    repeatedSamples += other.repeatedSamples;
+}
+
+LogFile::~LogFile()
+{
+    close();
+}
+
+bool LogFile::open(const std::string &path, std::string &error)
+{
+    struct stat info;
+    const sfe_opt4048_log_header_t *hdr;
+
+    close();
+
+    _fd = ::open(path.c_str(), O_RDONLY);
+    if (_fd < 0)
+    {
+        error = "cannot open " + path;
+        return false;
+    }
+
+    if (fstat(_fd, &info) != 0 || info.st_size < (off_t)OPT4048_LOG_SECTOR_SIZE)
+    {
+        error = path + " is too small to be a log";
+        close();
+        return false;
+    }
+
+    _size = info.st_size;
+    void *map = mmap(nullptr, _size, PROT_READ, MAP_SHARED, _fd, 0);
+    if (map == MAP_FAILED)
+    {
+        error = "cannot map " + path;
+        _size = 0;
+        close();
+        return false;
+    }
+
+    _data = static_cast<const uint8_t *>(map);
+    madvise(map, _size, MADV_SEQUENTIAL);
+
+    hdr = reinterpret_cast<const sfe_opt4048_log_header_t *>(_data);
+
+    if (memcmp(hdr->magic, OPT4048_LOG_MAGIC, sizeof(hdr->magic)) != 0)
+        error = "bad magic, not an OPT4048 log";
+    else if (hdr->checksum != opt4048LogChecksum(_data, sizeof(*hdr) - sizeof(hdr->checksum)))
+        error = "header checksum mismatch";
+    else if (hdr->version != OPT4048_LOG_VERSION)
+        error = "unsupported log version " + std::to_string(hdr->version);
+    else if (hdr->headerSize != OPT4048_LOG_SECTOR_SIZE || hdr->recordSize != OPT4048_LOG_RECORD_SIZE)
+        error = "unsupported header or record size";
+    else
+        return true;
+
+    close();
+    return false;
+}
+
+void LogFile::close()
+{
+    if (_data)
+        munmap(const_cast<uint8_t *>(_data), _size);
+
+    if (_fd >= 0)
+        ::close(_fd);
+
+    _data = nullptr;
+    _size = 0;
+    _fd = -1;
+}
+
+const sfe_opt4048_log_header_t &LogFile::header() const
+{
+    return *reinterpret_cast<const sfe_opt4048_log_header_t *>(_data);
+}
+
+size_t LogFile::sectorCount() const
+{
+    // A partially written last sector is ignored.
+    return _data ? (_size / OPT4048_LOG_SECTOR_SIZE) - 1 : 0;
+}
+
+const uint8_t *LogFile::sector(size_t index) const
+{
+    return _data + (index + 1) * OPT4048_LOG_SECTOR_SIZE;
+}
+
+size_t LogFile::size() const
+{
+    return _size;
+}
+
+namespace
+{
+
+// Summary of one chunk from the first pass.
+struct ChunkInfo
+{
+    LogStats stats;
+    uint64_t wraps = 0;      // micros() wrap-arounds between the first and last record of the chunk
+    bool empty = true;
+    uint32_t firstTime = 0;
+    uint32_t lastTime = 0;
+    uint16_t firstSequence = 0;
+    uint16_t lastSequence = 0;
+    uint8_t firstCounter = 0;
+    uint8_t lastCounter = 0;
+    uint64_t firstRow = 0;   // Filled in by the sequential step
+    uint64_t timeBase = 0;   // Filled in by the sequential step
+};
+
+inline const sfe_opt4048_log_record_t *recordAt(const uint8_t *sector, size_t index)
+{
+    return reinterpret_cast<const sfe_opt4048_log_record_t *>(sector + index * OPT4048_LOG_RECORD_SIZE);
+}
+
+// 0 = padding, 1 = valid, -1 = corrupt
+inline int classify(const sfe_opt4048_log_record_t *record)
+{
+    if (record->marker != OPT4048_LOG_RECORD_MARKER)
+        return 0;
+
+    if (record->checksum !=
+        opt4048LogChecksum(reinterpret_cast<const uint8_t *>(record), OPT4048_LOG_RECORD_SIZE - sizeof(record->checksum)))
+        return -1;
+
+    return 1;
+}
+
+// Sample counter of Channel Zero, upper nibble of the third image byte.
+inline uint8_t counterOf(const sfe_opt4048_log_record_t *record)
+{
+    return (record->image[3] >> 4) & 0x0F;
+}
+
+template <class Fn> void parallelFor(size_t count, unsigned threads, Fn fn)
+{
+    std::atomic<size_t> next(0);
+    std::vector<std::thread> workers;
+    unsigned n = std::max(1u, std::min<unsigned>(threads, count));
+
+    for (unsigned t = 0; t < n; t++)
+    {
+        workers.emplace_back([&]() {
+            for (size_t i = next++; i < count; i = next++)
+                fn(i);
+        });
+    }
+
+    for (auto &worker : workers)
+        worker.join();
+}
+
+} // namespace
+
+LogDecoder::LogDecoder(unsigned threads, size_t sectorsPerChunk)
+    : _threads(threads ? threads : std::max(1u, std::thread::hardware_concurrency())),
+      _sectorsPerChunk(std::max<size_t>(1, sectorsPerChunk))
+{
+}
+
+unsigned LogDecoder::threads() const
+{
+    return _threads;
+}
+
+bool LogDecoder::decode(const LogFile &log, LogSink *sink, LogStats &stats)
+{
+    size_t sectors = log.sectorCount();
+    size_t chunks = (sectors + _sectorsPerChunk - 1) / _sectorsPerChunk;
+    std::vector<ChunkInfo> info(chunks);
+
+    stats = LogStats();
+
+    // Pass 1: validate, count, and find the boundaries of every chunk.
+    parallelFor(chunks, _threads, [&](size_t c) {
+        ChunkInfo &ci = info[c];
+        size_t end = std::min(sectors, (c + 1) * _sectorsPerChunk);
+
+        for (size_t s = c * _sectorsPerChunk; s < end; s++)
+        {
+            const uint8_t *sector = log.sector(s);
+
+            for (size_t r = 0; r < OPT4048_LOG_RECORDS_PER_SECTOR; r++)
+            {
+                const sfe_opt4048_log_record_t *record = recordAt(sector, r);
+                int kind = classify(record);
+
+                if (kind == 0)
+                {
+                    ci.stats.padding++;
+                    continue;
+                }
+                if (kind < 0)
+                {
+                    ci.stats.checksumErrors++;
+                    continue;
+                }
+
+                if (opt4048CheckImageCRC(record->image))
+                    ci.stats.crcErrors++;
+
+                if (ci.empty)
+                {
+                    ci.empty = false;
+                    ci.firstTime = record->timestampUs;
+                    ci.firstSequence = record->sequence;
+                    ci.firstCounter = counterOf(record);
+                }
+                else
+                {
+                    if (record->timestampUs < ci.lastTime)
+                        ci.wraps++;
+
+                    ci.stats.droppedSamples += (uint16_t)(record->sequence - ci.lastSequence - 1);
+
+                    if (counterOf(record) == ci.lastCounter)
+                        ci.stats.repeatedSamples++;
+                }
+
+                ci.lastTime = record->timestampUs;
+                ci.lastSequence = record->sequence;
+                ci.lastCounter = counterOf(record);
+                ci.stats.records++;
+            }
+        }
+    });
+
+    // Sequential step: row offsets, time offsets, and checks across chunk boundaries.
+    uint64_t row = 0;
+    uint64_t wraps = 0;
+    bool havePrevious = false;
+    uint32_t previousTime = log.header().startMicros;
+    uint16_t previousSequence = 0;
+    uint8_t previousCounter = 0;
+
+    for (ChunkInfo &ci : info)
+    {
+        stats.add(ci.stats);
+        ci.firstRow = row;
+        row += ci.stats.records;
+
+        if (ci.empty)
+            continue;
+
+        if (ci.firstTime < previousTime)
+            wraps++;
+
+        if (havePrevious)
+        {
+            stats.droppedSamples += (uint16_t)(ci.firstSequence - previousSequence - 1);
+
+            if (ci.firstCounter == previousCounter)
+                stats.repeatedSamples++;
+        }
+        else
+            stats.droppedSamples += ci.firstSequence;
+
+        ci.timeBase = wraps << 32;
+        wraps += ci.wraps;
+
+        havePrevious = true;
+        previousTime = ci.lastTime;
+        previousSequence = ci.lastSequence;
+        previousCounter = ci.lastCounter;
+    }
+
+    if (!sink)
+        return true;
+
+    if (!sink->begin(stats.records))
+        return false;
+
+    // Pass 2: decode.
+    uint64_t start = log.header().startMicros;
+
+    parallelFor(chunks, _threads, [&](size_t c) {
+        const ChunkInfo &ci = info[c];
+        size_t end = std::min(sectors, (c + 1) * _sectorsPerChunk);
+        uint64_t timeBase = ci.timeBase;
+        uint32_t lastTime = ci.firstTime;
+        std::vector<LogSample> samples;
+
+        samples.reserve(ci.stats.records);
+
+        for (size_t s = c * _sectorsPerChunk; s < end; s++)
+        {
+            const uint8_t *sector = log.sector(s);
+
+            for (size_t r = 0; r < OPT4048_LOG_RECORDS_PER_SECTOR; r++)
+            {
+                const sfe_opt4048_log_record_t *record = recordAt(sector, r);
+
+                if (classify(record) <= 0)
+                    continue;
+
+                if (record->timestampUs < lastTime)
+                    timeBase += 1ULL << 32;
+                lastTime = record->timestampUs;
+
+                LogSample sample;
+                sample.timeUs = timeBase + record->timestampUs - start;
+                sample.sequence = record->sequence;
+                sample.control = record->control;
+                sample.flags = record->flags;
+                sample.status = record->status;
+                sample.crcErrors = opt4048CheckImageCRC(record->image);
+                opt4048DecodeImage(record->image, &sample.color);
+                opt4048CalculateCIE(&sample.color, &sample.cie);
+
+                samples.push_back(sample);
+            }
+        }
+
+        sink->consume(c, ci.firstRow, samples);
+    });
+
+    return sink->end();
+}
+
+} // namespace sfe_OPT4048
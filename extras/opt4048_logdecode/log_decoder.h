@@ -0,0 +1,157 @@
+/*
+log_decoder.h
+
+SparkFun Tristimulus Color Sensor - OPT4048
+
+Qwiic 1x1
+* https://www.sparkfun.com/products/
+Qwiic Mini
+* https://www.sparkfun.com/products/
+
+Repository:
+* https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+The MIT License (MIT)
+
+Copyright (c) 2022 SparkFun Electronics
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions: The
+above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED
+"AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+License(http://opensource.org/licenses/MIT).
+
+Host side decoder for binary OPT4048 sample logs written by QwOpt4048Logger.
+The log is memory mapped and split into chunks of whole sectors that are
+decoded in parallel. Decoding uses the same functions as the Arduino library
+(sfe_opt4048_decode.h), so values match what the sensor would have reported.
+
+Requires a POSIX system (mmap) and C++17.
+
+*/
+#pragma once
+#include "sfe_opt4048_decode.h"
+#include "sfe_opt4048_log_format.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace sfe_OPT4048
+{
+
+/// @brief One decoded record.
+struct LogSample
+{
+    uint64_t timeUs;   // Microseconds since the log header, with micros() wrap-around removed
+    uint16_t sequence;
+    uint16_t control;
+    uint16_t flags;
+    uint8_t status;
+    uint8_t crcErrors; // Bit mask of channels whose CRC did not match
+    sfe_color_t color;
+    sfe_cie_t cie;
+};
+
+/// @brief Integrity counters gathered while decoding.
+struct LogStats
+{
+    uint64_t records = 0;        // Valid records decoded
+    uint64_t padding = 0;        // Empty records written by the final flush
+    uint64_t checksumErrors = 0; // Records skipped because their checksum did not match
+    uint64_t crcErrors = 0;      // Records with at least one channel CRC mismatch
+    uint64_t droppedSamples = 0; // Samples missing according to the sequence numbers
+    uint64_t repeatedSamples = 0; // Records whose channel counters did not advance
+
+    void add(const LogStats &other);
+};
+
+/// @brief Read only, memory mapped view of a log file.
+class LogFile
+{
+  public:
+    LogFile() = default;
+    ~LogFile();
+
+    LogFile(const LogFile &) = delete;
+    LogFile &operator=(const LogFile &) = delete;
+
+    /// @brief Maps the file and validates the header.
+    /// @param path The log file.
+    /// @param error Set to a description of the problem on failure.
+    /// @return True on success.
+    bool open(const std::string &path, std::string &error);
+
+    /// @brief Unmaps the file.
+    void close();
+
+    const sfe_opt4048_log_header_t &header() const;
+
+    /// @brief Number of complete record sectors following the header.
+    size_t sectorCount() const;
+
+    /// @brief Pointer to the first byte of a record sector.
+    const uint8_t *sector(size_t index) const;
+
+    /// @brief Size of the mapped file in bytes.
+    size_t size() const;
+
+  private:
+    int _fd = -1;
+    const uint8_t *_data = nullptr;
+    size_t _size = 0;
+};
+
+/// @brief Receives decoded samples. consume() is called from the worker threads, concurrently and not
+///        necessarily in chunk order; the row numbers tell the sink where each chunk belongs.
+class LogSink
+{
+  public:
+    virtual ~LogSink() = default;
+
+    /// @brief Called once before decoding with the total number of valid records.
+    virtual bool begin(uint64_t totalRecords) = 0;
+
+    /// @brief Called from a worker thread with a chunk of decoded samples. Must be thread safe.
+    /// @param chunk Index of the chunk; chunks are numbered in file order.
+    /// @param firstRow Row number of the first sample in the chunk.
+    /// @param samples The decoded samples.
+    virtual void consume(size_t chunk, uint64_t firstRow, const std::vector<LogSample> &samples) = 0;
+
+    /// @brief Called once after all chunks have been consumed.
+    virtual bool end() = 0;
+};
+
+/// @brief Decodes a log in parallel.
+class LogDecoder
+{
+  public:
+    /// @param threads Number of worker threads, 0 for one per core.
+    /// @param sectorsPerChunk Number of 512 byte sectors handed to a worker at a time.
+    explicit LogDecoder(unsigned threads = 0, size_t sectorsPerChunk = 2048);
+
+    /// @brief Decodes every record in the log and passes the samples to the sink.
+    /// @param log The opened log.
+    /// @param sink Receives the samples, may be null to only gather statistics.
+    /// @param stats Filled with the integrity counters for the whole log.
+    /// @return True on success.
+    bool decode(const LogFile &log, LogSink *sink, LogStats &stats);
+
+    unsigned threads() const;
+
+  private:
+    unsigned _threads;
+    size_t _sectorsPerChunk;
+};
+
+} // namespace sfe_OPT4048
@@ -0,0 +1,531 @@
+/*
+opt4048_logdecode.cpp
+
+SparkFun Tristimulus Color Sensor - OPT4048
+
+Qwiic 1x1
+* https://www.sparkfun.com/products/
+Qwiic Mini
+* https://www.sparkfun.com/products/
+
+Repository:
+* https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+The MIT License (MIT)
+
+Copyright (c) 2022 SparkFun Electronics
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions: The
+above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED
+"AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+License(http://opensource.org/licenses/MIT).
+
+Command line tool that decodes binary OPT4048 sample logs written by
+QwOpt4048Logger into CSV or a columnar binary file.
+
+    opt4048_logdecode [-j threads] [-f csv|columnar] [-o output] log.bin
+    opt4048_logdecode --bench [-j threads] log.bin
+    opt4048_logdecode --generate records log.bin
+
+See README.md in this folder for the columnar file layout.
+
+*/
+#include "OPT4048_Registers.h"
+#include "log_decoder.h"
+
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unistd.h>
+
+using namespace sfe_OPT4048;
+
+namespace
+{
+
+// Appends integers and doubles to a string without going through printf.
+class Formatter
+{
+  public:
+    explicit Formatter(std::string &out) : _out(out)
+    {
+    }
+
+    Formatter &operator<<(uint64_t value)
+    {
+        char buff[24];
+        auto res = std::to_chars(buff, buff + sizeof(buff), value);
+        _out.append(buff, res.ptr);
+        return *this;
+    }
+
+    Formatter &operator<<(double value)
+    {
+        char buff[32];
+        auto res = std::to_chars(buff, buff + sizeof(buff), value, std::chars_format::fixed, 6);
+        _out.append(buff, res.ptr);
+        return *this;
+    }
+
+    Formatter &operator<<(char c)
+    {
+        _out.push_back(c);
+        return *this;
+    }
+
+  private:
+    std::string &_out;
+};
+
+// Formats chunks in parallel and writes them in file order.
+class CsvSink : public LogSink
+{
+  public:
+    explicit CsvSink(FILE *out) : _out(out)
+    {
+    }
+
+    bool begin(uint64_t) override
+    {
+        static const char header[] = "time_us,sequence,red,green,blue,white,cie_x,cie_y,lux,cct,control,flags,"
+                                     "status,crc_errors\n";
+        return fwrite(header, 1, sizeof(header) - 1, _out) == sizeof(header) - 1;
+    }
+
+    void consume(size_t chunk, uint64_t, const std::vector<LogSample> &samples) override
+    {
+        std::string text;
+        Formatter f(text);
+
+        text.reserve(samples.size() * 110);
+
+        for (const LogSample &s : samples)
+        {
+            f << s.timeUs << ',' << (uint64_t)s.sequence << ',' << (uint64_t)s.color.red << ','
+              << (uint64_t)s.color.green << ',' << (uint64_t)s.color.blue << ',' << (uint64_t)s.color.white << ','
+              << s.cie.CIEx << ',' << s.cie.CIEy << ',' << s.cie.lux << ',' << s.cie.CCT << ','
+              << (uint64_t)s.control << ',' << (uint64_t)s.flags << ',' << (uint64_t)s.status << ','
+              << (uint64_t)s.crcErrors << '\n';
+        }
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        _ready[chunk] = std::move(text);
+
+        // Write out every chunk that is now next in line.
+        for (auto it = _ready.find(_next); it != _ready.end(); it = _ready.find(_next))
+        {
+            if (fwrite(it->second.data(), 1, it->second.size(), _out) != it->second.size())
+                _failed = true;
+            _ready.erase(it);
+            _next++;
+        }
+    }
+
+    bool end() override
+    {
+        return !_failed && _ready.empty() && fflush(_out) == 0;
+    }
+
+  private:
+    FILE *_out;
+    std::mutex _mutex;
+    std::map<size_t, std::string> _ready;
+    size_t _next = 0;
+    bool _failed = false;
+};
+
+// Column types of the columnar format.
+enum ColumnType : uint8_t
+{
+    kColumnU32 = 0,
+    kColumnU64 = 1,
+    kColumnF64 = 2
+};
+
+struct ColumnDesc
+{
+    char name[16];
+    uint8_t type;
+    uint8_t reserved[7];
+    uint64_t offset; // File offset of the column data
+};
+
+struct ColumnarHeader
+{
+    char magic[8]; // "OPT4048C"
+    uint32_t version;
+    uint32_t columns;
+    uint64_t rows;
+};
+
+// Writes each chunk straight to its final position in every column with pwrite, so rows never
+// need to be held in memory and chunks can arrive in any order.
+class ColumnarSink : public LogSink
+{
+  public:
+    explicit ColumnarSink(int fd) : _fd(fd)
+    {
+    }
+
+    bool begin(uint64_t rows) override
+    {
+        static const struct
+        {
+            const char *name;
+            ColumnType type;
+        } layout[] = {{"time_us", kColumnU64}, {"sequence", kColumnU32}, {"red", kColumnU32},
+                      {"green", kColumnU32},   {"blue", kColumnU32},     {"white", kColumnU32},
+                      {"cie_x", kColumnF64},   {"cie_y", kColumnF64},    {"lux", kColumnF64},
+                      {"cct", kColumnF64},     {"control", kColumnU32},  {"flags", kColumnU32},
+                      {"status", kColumnU32},  {"crc_errors", kColumnU32}};
+
+        ColumnarHeader header = {};
+        uint64_t offset;
+
+        memcpy(header.magic, "OPT4048C", sizeof(header.magic));
+        header.version = 1;
+        header.columns = sizeof(layout) / sizeof(layout[0]);
+        header.rows = rows;
+
+        _columns.resize(header.columns);
+        offset = sizeof(header) + header.columns * sizeof(ColumnDesc);
+
+        for (size_t i = 0; i < _columns.size(); i++)
+        {
+            ColumnDesc &desc = _columns[i];
+            memset(&desc, 0, sizeof(desc));
+            strncpy(desc.name, layout[i].name, sizeof(desc.name) - 1);
+            desc.type = layout[i].type;
+            desc.offset = (offset + 7) & ~7ULL;
+            offset = desc.offset + rows * width(desc.type);
+        }
+
+        if (pwrite(_fd, &header, sizeof(header), 0) != sizeof(header))
+            return false;
+
+        ssize_t descBytes = _columns.size() * sizeof(ColumnDesc);
+        if (pwrite(_fd, _columns.data(), descBytes, sizeof(header)) != descBytes)
+            return false;
+
+        return ftruncate(_fd, offset) == 0;
+    }
+
+    void consume(size_t, uint64_t firstRow, const std::vector<LogSample> &samples) override
+    {
+        std::vector<uint8_t> buff;
+
+        for (size_t col = 0; col < _columns.size(); col++)
+        {
+            size_t w = width(_columns[col].type);
+            buff.resize(samples.size() * w);
+
+            for (size_t i = 0; i < samples.size(); i++)
+                store(col, samples[i], &buff[i * w]);
+
+            ssize_t bytes = buff.size();
+            if (bytes && pwrite(_fd, buff.data(), bytes, _columns[col].offset + firstRow * w) != bytes)
+                _failed = true;
+        }
+    }
+
+    bool end() override
+    {
+        return !_failed;
+    }
+
+  private:
+    static size_t width(uint8_t type)
+    {
+        return type == kColumnU32 ? 4 : 8;
+    }
+
+    static void store(size_t col, const LogSample &s, uint8_t *dest)
+    {
+        uint32_t u32 = 0;
+        uint64_t u64 = 0;
+        double f64 = 0;
+
+        switch (col)
+        {
+        case 0: u64 = s.timeUs; break;
+        case 1: u32 = s.sequence; break;
+        case 2: u32 = s.color.red; break;
+        case 3: u32 = s.color.green; break;
+        case 4: u32 = s.color.blue; break;
+        case 5: u32 = s.color.white; break;
+        case 6: f64 = s.cie.CIEx; break;
+        case 7: f64 = s.cie.CIEy; break;
+        case 8: f64 = s.cie.lux; break;
+        case 9: f64 = s.cie.CCT; break;
+        case 10: u32 = s.control; break;
+        case 11: u32 = s.flags; break;
+        case 12: u32 = s.status; break;
+        default: u32 = s.crcErrors; break;
+        }
+
+        if (col == 0)
+            memcpy(dest, &u64, 8);
+        else if (col >= 6 && col <= 9)
+            memcpy(dest, &f64, 8);
+        else
+            memcpy(dest, &u32, 4);
+    }
+
+    int _fd;
+    std::vector<ColumnDesc> _columns;
+    bool _failed = false;
+};
+
+// Counts samples so the decode work can't be optimized away while benchmarking.
+class NullSink : public LogSink
+{
+  public:
+    bool begin(uint64_t) override
+    {
+        return true;
+    }
+
+    void consume(size_t, uint64_t, const std::vector<LogSample> &samples) override
+    {
+        _samples += samples.size();
+    }
+
+    bool end() override
+    {
+        return true;
+    }
+
+    std::atomic<uint64_t> _samples{0};
+};
+
+// Encodes one channel the way the sensor does, for synthetic logs.
+void encodeChannel(uint32_t code, uint8_t counter, uint8_t *regs)
+{
+    uint8_t exponent = 0;
+
+    while (code >= (1UL << 20) && exponent < 15)
+    {
+        code >>= 1;
+        exponent++;
+    }
+
+    uint8_t crc = opt4048CalculateCRC(code, exponent, counter);
+    uint16_t msb = (exponent << 12) | (code >> 8);
+    uint16_t lsb = ((code & 0xFF) << 8) | (counter << 4) | crc;
+
+    regs[0] = msb >> 8;
+    regs[1] = msb;
+    regs[2] = lsb >> 8;
+    regs[3] = lsb;
+}
+
+int generate(uint64_t records, const char *path)
+{
+    FILE *out = fopen(path, "wb");
+    if (!out)
+    {
+        fprintf(stderr, "cannot create %s\n", path);
+        return 1;
+    }
+
+    sfe_opt4048_log_header_t header = {};
+    memcpy(header.magic, OPT4048_LOG_MAGIC, sizeof(header.magic));
+    header.version = OPT4048_LOG_VERSION;
+    header.headerSize = OPT4048_LOG_SECTOR_SIZE;
+    header.recordSize = OPT4048_LOG_RECORD_SIZE;
+    header.deviceId = OPT4048_DEVICE_ID;
+    header.i2cAddress = OPT4048_ADDR_LOW;
+    header.control = 0x3058; // Auto range, 1ms, continuous
+    header.intControl = 0x8011;
+    header.checksum = opt4048LogChecksum((const uint8_t *)&header, sizeof(header) - sizeof(header.checksum));
+    fwrite(&header, sizeof(header), 1, out);
+
+    uint8_t sector[OPT4048_LOG_SECTOR_SIZE];
+    uint32_t time = 0;
+
+    for (uint64_t i = 0; i < records;)
+    {
+        memset(sector, 0, sizeof(sector));
+
+        for (size_t r = 0; r < OPT4048_LOG_RECORDS_PER_SECTOR && i < records; r++, i++)
+        {
+            sfe_opt4048_log_record_t *rec = (sfe_opt4048_log_record_t *)&sector[r * OPT4048_LOG_RECORD_SIZE];
+            double level = 1.0 + 0.2 * sin(i * 0.05);
+            uint8_t counter = i & 0x0F;
+
+            time += 4000;
+            rec->timestampUs = time;
+            encodeChannel(200000 * level, counter, &rec->image[0]);
+            encodeChannel(300000 * level, counter, &rec->image[4]);
+            encodeChannel(150000 * level, counter, &rec->image[8]);
+            encodeChannel(700000 * level, counter, &rec->image[12]);
+            rec->control = header.control;
+            rec->sequence = i;
+            rec->marker = OPT4048_LOG_RECORD_MARKER;
+            rec->checksum = opt4048LogChecksum((const uint8_t *)rec, OPT4048_LOG_RECORD_SIZE - sizeof(rec->checksum));
+        }
+
+        fwrite(sector, sizeof(sector), 1, out);
+    }
+
+    return fclose(out) == 0 ? 0 : 1;
+}
+
+int bench(const LogFile &log, unsigned maxThreads)
+{
+    double megabytes = log.size() / 1e6;
+
+    printf("%-8s %10s %10s\n", "threads", "seconds", "MB/s");
+
+    for (unsigned threads = 1;; threads = std::min(threads * 2, maxThreads))
+    {
+        LogDecoder decoder(threads);
+        NullSink sink;
+        LogStats stats;
+        double best = 1e30;
+
+        // Best of three runs to take page cache warm-up out of the result.
+        for (int run = 0; run < 3; run++)
+        {
+            auto start = std::chrono::steady_clock::now();
+            decoder.decode(log, &sink, stats);
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            best = std::min(best, elapsed.count());
+        }
+
+        printf("%-8u %10.3f %10.1f\n", threads, best, megabytes / best);
+
+        if (threads == maxThreads)
+            break;
+    }
+
+    return 0;
+}
+
+void usage()
+{
+    fprintf(stderr, "usage: opt4048_logdecode [-j threads] [-f csv|columnar] [-o output] log.bin\n"
+                    "       opt4048_logdecode --bench [-j threads] log.bin\n"
+                    "       opt4048_logdecode --generate records log.bin\n");
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    unsigned threads = 0;
+    std::string format = "csv";
+    const char *output = nullptr;
+    const char *input = nullptr;
+    bool benchmark = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "-j") && i + 1 < argc)
+            threads = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-f") && i + 1 < argc)
+            format = argv[++i];
+        else if (!strcmp(argv[i], "-o") && i + 1 < argc)
+            output = argv[++i];
+        else if (!strcmp(argv[i], "--bench"))
+            benchmark = true;
+        else if (!strcmp(argv[i], "--generate") && i + 2 < argc)
+            return generate(strtoull(argv[i + 1], nullptr, 10), argv[i + 2]);
+        else if (argv[i][0] != '-' && !input)
+            input = argv[i];
+        else
+        {
+            usage();
+            return 2;
+        }
+    }
+
+    if (!input || (format != "csv" && format != "columnar") || (format == "columnar" && !output))
+    {
+        usage();
+        return 2;
+    }
+
+    LogFile log;
+    std::string error;
+
+    if (!log.open(input, error))
+    {
+        fprintf(stderr, "%s: %s\n", input, error.c_str());
+        return 1;
+    }
+
+    LogDecoder decoder(threads);
+
+    if (benchmark)
+        return bench(log, decoder.threads());
+
+    LogStats stats;
+    bool ok;
+    auto start = std::chrono::steady_clock::now();
+
+    if (format == "csv")
+    {
+        FILE *out = output ? fopen(output, "w") : stdout;
+        if (!out)
+        {
+            fprintf(stderr, "cannot create %s\n", output);
+            return 1;
+        }
+
+        CsvSink sink(out);
+        ok = decoder.decode(log, &sink, stats);
+
+        if (output)
+            ok = (fclose(out) == 0) && ok;
+    }
+    else
+    {
+        int fd = open(output, O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0)
+        {
+            fprintf(stderr, "cannot create %s\n", output);
+            return 1;
+        }
+
+        ColumnarSink sink(fd);
+        ok = decoder.decode(log, &sink, stats);
+        ok = (close(fd) == 0) && ok;
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    fprintf(stderr,
+            "%llu records, %llu dropped, %llu repeated, %llu CRC errors, %llu checksum errors, %llu padding\n"
+            "%.1f MB in %.3f s (%.1f MB/s, %u threads)\n",
+            (unsigned long long)stats.records, (unsigned long long)stats.droppedSamples,
+            (unsigned long long)stats.repeatedSamples, (unsigned long long)stats.crcErrors,
+            (unsigned long long)stats.checksumErrors, (unsigned long long)stats.padding, log.size() / 1e6,
+            elapsed.count(), log.size() / 1e6 / elapsed.count(), decoder.threads());
+
+    if (!ok)
+    {
+        fprintf(stderr, "error writing output\n");
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,103 @@
+/*
+Arduino.h
+
+SparkFun Tristimulus Color Sensor - OPT4048
+
+Qwiic 1x1
+* https://www.sparkfun.com/products/
+Qwiic Mini
+* https://www.sparkfun.com/products/
+
+Repository:
+* https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+The MIT License (MIT)
+
+Copyright (c) 2022 SparkFun Electronics
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions: The
+above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED
+"AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+License(http://opensource.org/licenses/MIT).
+
+Minimal Arduino core for building the OPT4048 driver on a host. Time is
+virtual: micros() returns a clock that only moves when delay() is called or a
+replayed transaction moves it, so a trace replays at full host speed and the
+driver sees the same timing it saw in the field. Programs that run in real time
+switch to the system clock with hostUseSystemClock().
+
+*/
+#pragma once
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#define PROGMEM
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+
+inline void yield()
+{
+}
+
+class Print
+{
+  public:
+    virtual ~Print() = default;
+
+    virtual size_t write(uint8_t value) = 0;
+
+    virtual size_t write(const uint8_t *buffer, size_t size)
+    {
+        size_t n = 0;
+
+        while (size--)
+            n += write(*buffer++);
+
+        return n;
+    }
+};
+
+namespace sfe_OPT4048
+{
+
+/// @brief Retrieves the virtual clock, 64 bits wide. micros() returns its low 32 bits like on an Arduino.
+uint64_t hostMicros();
+
+/// @brief Moves the virtual clock forward. Earlier times are ignored.
+void hostAdvanceTo(uint64_t us);
+
+/// @brief Sets the virtual clock.
+void hostSetMicros(uint64_t us);
+
+/// @brief Switches from the virtual clock to the system's monotonic clock, for running in real time, e.g.
+///        against hardware. delay() then sleeps, and hostAdvanceTo() and hostSetMicros() have no effect.
+void hostUseSystemClock();
+
+/// @brief Tells if the system clock is in use.
+bool hostSystemClock();
+
+} // namespace sfe_OPT4048
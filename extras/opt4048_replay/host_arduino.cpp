@@ -0,0 +1,136 @@
+/*
+host_arduino.cpp
+
+SparkFun Tristimulus Color Sensor - OPT4048
+
+Qwiic 1x1
+* https://www.sparkfun.com/products/
+Qwiic Mini
+* https://www.sparkfun.com/products/
+
+Repository:
+* https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+The MIT License (MIT)
+
+Copyright (c) 2022 SparkFun Electronics
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions: The
+above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED
+"AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+License(http://opensource.org/licenses/MIT).
+
+The following functions implement the host clock, virtual or system, and the
+Arduino functions declared in host/Arduino.h.
+
+*/
+#include "Arduino.h"
+#include "Wire.h"
+
+#include <cerrno>
+#include <ctime>
+
+namespace sfe_OPT4048
+{
+
+static uint64_t virtualMicros = 0;
+static bool systemClock = false;
+
+uint64_t hostMicros()
+{
+    struct timespec now;
+
+    if (!systemClock)
+        return virtualMicros;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+void hostAdvanceTo(uint64_t us)
+{
+    if (!systemClock && us > virtualMicros)
+        virtualMicros = us;
+}
+
+void hostSetMicros(uint64_t us)
+{
+    if (!systemClock)
+        virtualMicros = us;
+}
+
+void hostUseSystemClock()
+{
+    systemClock = true;
+}
+
+bool hostSystemClock()
+{
+    return systemClock;
+}
+
+static void hostSleep(uint64_t us)
+{
+    struct timespec duration;
+
+    if (!systemClock)
+    {
+        virtualMicros += us;
+        return;
+    }
+
+    duration.tv_sec = us / 1000000;
+    duration.tv_nsec = (us % 1000000) * 1000;
+
+    while (nanosleep(&duration, &duration) != 0 && errno == EINTR)
+        ;
+}
+
+} // namespace sfe_OPT4048
+
+unsigned long millis()
+{
+    return (uint32_t)(sfe_OPT4048::hostMicros() / 1000);
+}
+
+unsigned long micros()
+{
+    return (uint32_t)sfe_OPT4048::hostMicros();
+}
+
+void delay(unsigned long ms)
+{
+    sfe_OPT4048::hostSleep(ms * 1000ULL);
+}
+
+void delayMicroseconds(unsigned int us)
+{
+    sfe_OPT4048::hostSleep(us);
+}
+
+void pinMode(uint8_t, uint8_t)
+{
+}
+
+void digitalWrite(uint8_t, uint8_t)
+{
+}
+
+int digitalRead(uint8_t)
+{
+    return HIGH;
+}
+
+TwoWire Wire;
@@ -0,0 +1,126 @@
+/*
+Wire.h
+
+SparkFun Tristimulus Color Sensor - OPT4048
+
+Qwiic 1x1
+* https://www.sparkfun.com/products/
+Qwiic Mini
+* https://www.sparkfun.com/products/
+
+Repository:
+* https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+The MIT License (MIT)
+
+Copyright (c) 2022 SparkFun Electronics
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions: The
+above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED
+"AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+License(http://opensource.org/licenses/MIT).
+Recording stand-in for the Arduino Wire library on a host, a drop-in for
+host/Wire.h. Simulated devices answer with their register files, and every
+bus event is recorded: clock changes, Hs-mode master codes, and transfers with
+the clock they ran at and whether they ended with a STOP. Rules of the bus are
+checked as the events happen; breaking one counts a violation.
+
+*/
+#pragma once
+#include "Arduino.h"
+
+#include <string>
+#include <vector>
+
+class TwoWire
+{
+  public:
+    /// @brief A simulated device.
+    /// @param address 7 bit I2C address.
+    /// @param maxClockHz Fastest Standard, Fast-mode, or Fast-mode Plus clock the device answers at.
+    /// @param hsClockHz Fastest Hs-mode clock the device answers at, 0 if it doesn't support Hs-mode.
+    void addDevice(uint8_t address, uint32_t maxClockHz, uint32_t hsClockHz = 0);
+
+    /// @brief Sets a 16 bit register of a simulated device, read back big endian.
+    void setRegister(uint8_t address, uint8_t reg, uint16_t value);
+
+    /// @brief Retrieves a 16 bit register of a simulated device.
+    uint16_t getRegister(uint8_t address, uint8_t reg);
+
+    /// @brief Makes a simulated device answer the next SMBus Alert Response Address read.
+    void setAlert(uint8_t address);
+
+    /// @brief Removes the devices and events and resets the port to 100kHz.
+    void reset();
+
+    /// @brief The events since the last call, one string each, and clears them:
+    ///        "clock 400000"                      setClock()
+    ///        "begin", "end"                      begin() and end()
+    ///        "master 0x05 400000"                Hs-mode master code, its 7 bit address, and the clock
+    ///        "write 0x44 0A 32 08 stop 1000000"  written bytes, STOP or restart, and the clock
+    ///        "read 0x44 2 restart 3400000"       number of bytes read, STOP or restart, and the clock
+    ///        "nack 0x44 stop 100000"             a transfer nobody answered
+    /// @return The events.
+    std::vector<std::string> takeEvents();
+
+    /// @brief Retrieves the clock the port is set to.
+    uint32_t getClock();
+
+    /// @brief Retrieves the number of broken bus rules: a master code sent faster than 400kHz or ended with a
+    ///        STOP, a transfer faster than 1MHz without a master code before it, or a clock change in the
+    ///        middle of a transfer. Each one is also printed.
+    uint32_t getViolations();
+
+    void begin();
+    void end();
+    void setClock(uint32_t clockHz);
+    void beginTransmission(uint8_t address);
+    void beginTransmission(int address);
+    uint8_t endTransmission(bool stop = true);
+    uint8_t requestFrom(int address, int length, int stop = 1);
+    size_t write(uint8_t value);
+    size_t write(const uint8_t *buffer, size_t size);
+    int available();
+    int read();
+
+  private:
+    struct Device
+    {
+        uint8_t address;
+        uint32_t maxClockHz;
+        uint32_t hsClockHz;
+        uint16_t registers[32];
+        uint8_t pointer;
+        bool alert;
+    };
+
+    Device *findDevice(uint8_t address);
+    bool answers(const Device *device);
+    void startTransfer();
+    void record(const char *type, uint8_t address, const std::string &detail, bool stop);
+    void violation(const char *rule);
+
+    std::vector<Device> _devices;
+    std::vector<std::string> _events;
+    std::vector<uint8_t> _txBuffer;
+    std::vector<uint8_t> _rxBuffer;
+    size_t _rxIndex = 0;
+    uint8_t _txAddress = 0;
+    uint32_t _clockHz = 100000;
+    bool _masterCodeSent = false; // A master code was sent and the bus is held with a repeated start
+    bool _highSpeed = false;      // In Hs-mode until the next STOP
+    uint32_t _violations = 0;
+};
+
+extern TwoWire Wire;
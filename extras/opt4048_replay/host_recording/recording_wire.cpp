@@ -0,0 +1,321 @@
+/*
+recording_wire.cpp
+
+SparkFun Tristimulus Color Sensor - OPT4048
+
+Qwiic 1x1
+* https://www.sparkfun.com/products/
+Qwiic Mini
+* https://www.sparkfun.com/products/
+
+Repository:
+* https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+The MIT License (MIT)
+
+Copyright (c) 2022 SparkFun Electronics
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions: The
+above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED
+"AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+License(http://opensource.org/licenses/MIT).
+The following functions implement the recording Wire stand-in declared in
+host_recording/Wire.h.
+
+*/
+#include "Wire.h"
+
+#include <cstdio>
+
+// Hs-mode master codes are 0000 1XX as 7 bit addresses.
+#define kMasterCodeMask 0x7C
+#define kMasterCode 0x04
+
+// SMBus Alert Response Address as a 7 bit address.
+#define kAlertResponseAddress 0x0C
+
+#define kMaxFastClockHz 400000
+#define kMaxFastPlusClockHz 1000000
+
+// endTransmission() result when the address is not acknowledged.
+#define kAddressNack 2
+
+void TwoWire::addDevice(uint8_t address, uint32_t maxClockHz, uint32_t hsClockHz)
+{
+    Device device = {};
+
+    device.address = address;
+    device.maxClockHz = maxClockHz;
+    device.hsClockHz = hsClockHz;
+
+    _devices.push_back(device);
+}
+
+void TwoWire::setRegister(uint8_t address, uint8_t reg, uint16_t value)
+{
+    Device *device = findDevice(address);
+
+    if (device != nullptr && reg < 32)
+        device->registers[reg] = value;
+}
+
+uint16_t TwoWire::getRegister(uint8_t address, uint8_t reg)
+{
+    Device *device = findDevice(address);
+
+    return device != nullptr && reg < 32 ? device->registers[reg] : 0;
+}
+
+void TwoWire::setAlert(uint8_t address)
+{
+    Device *device = findDevice(address);
+
+    if (device != nullptr)
+        device->alert = true;
+}
+
+void TwoWire::reset()
+{
+    _devices.clear();
+    _events.clear();
+    _clockHz = 100000;
+    _masterCodeSent = false;
+    _highSpeed = false;
+}
+
+std::vector<std::string> TwoWire::takeEvents()
+{
+    std::vector<std::string> events;
+
+    events.swap(_events);
+
+    return events;
+}
+
+uint32_t TwoWire::getClock()
+{
+    return _clockHz;
+}
+
+uint32_t TwoWire::getViolations()
+{
+    return _violations;
+}
+
+void TwoWire::begin()
+{
+    _clockHz = 100000;
+    _masterCodeSent = false;
+    _highSpeed = false;
+    _events.push_back("begin");
+}
+
+void TwoWire::end()
+{
+    _events.push_back("end");
+}
+
+void TwoWire::setClock(uint32_t clockHz)
+{
+    if (!_txBuffer.empty())
+        violation("clock changed in the middle of a transfer");
+
+    _clockHz = clockHz;
+    _events.push_back("clock " + std::to_string(clockHz));
+}
+
+void TwoWire::beginTransmission(uint8_t address)
+{
+    _txAddress = address;
+    _txBuffer.clear();
+}
+
+void TwoWire::beginTransmission(int address)
+{
+    beginTransmission((uint8_t)address);
+}
+
+uint8_t TwoWire::endTransmission(bool stop)
+{
+    char detail[8];
+    std::string bytes;
+
+    if ((_txAddress & kMasterCodeMask) == kMasterCode)
+    {
+        if (_clockHz > kMaxFastClockHz)
+            violation("master code faster than 400kHz");
+
+        if (stop)
+            violation("master code ended with a STOP");
+
+        snprintf(detail, sizeof(detail), "0x%02X", _txAddress);
+        _events.push_back(std::string("master ") + detail + " " + std::to_string(_clockHz));
+        _masterCodeSent = !stop;
+        _txBuffer.clear();
+
+        // No device acknowledges a master code.
+        return kAddressNack;
+    }
+
+    startTransfer();
+
+    Device *device = findDevice(_txAddress);
+    bool acknowledged = device != nullptr && answers(device);
+
+    for (uint8_t value : _txBuffer)
+    {
+        snprintf(detail, sizeof(detail), "%02X ", value);
+        bytes += detail;
+    }
+
+    if (acknowledged && !_txBuffer.empty())
+    {
+        device->pointer = _txBuffer[0];
+
+        for (size_t i = 1; i + 1 < _txBuffer.size(); i += 2)
+        {
+            if (device->pointer < 32)
+                device->registers[device->pointer] = _txBuffer[i] << 8 | _txBuffer[i + 1];
+
+            device->pointer++;
+        }
+
+        device->pointer = _txBuffer[0];
+    }
+
+    record(acknowledged ? "write" : "nack", _txAddress, bytes, stop);
+    _txBuffer.clear();
+
+    return acknowledged ? 0 : kAddressNack;
+}
+
+uint8_t TwoWire::requestFrom(int address, int length, int stop)
+{
+    _rxBuffer.clear();
+    _rxIndex = 0;
+
+    startTransfer();
+
+    if (address == kAlertResponseAddress)
+    {
+        for (Device &device : _devices)
+        {
+            if (device.alert && answers(&device))
+            {
+                device.alert = false;
+                _rxBuffer.push_back(device.address << 1);
+                break;
+            }
+        }
+
+        record(_rxBuffer.empty() ? "nack" : "read", address, _rxBuffer.empty() ? "" : "1 ", stop);
+
+        return _rxBuffer.size();
+    }
+
+    Device *device = findDevice(address);
+
+    if (device == nullptr || !answers(device))
+    {
+        record("nack", address, "", stop);
+        return 0;
+    }
+
+    for (int i = 0; i < length; i++)
+    {
+        uint8_t reg = device->pointer + i / 2;
+        uint16_t value = reg < 32 ? device->registers[reg] : 0;
+
+        _rxBuffer.push_back(i & 1 ? value & 0xFF : value >> 8);
+    }
+
+    device->pointer += length / 2;
+    record("read", address, std::to_string(length) + " ", stop);
+
+    return length;
+}
+
+size_t TwoWire::write(uint8_t value)
+{
+    _txBuffer.push_back(value);
+
+    return 1;
+}
+
+size_t TwoWire::write(const uint8_t *buffer, size_t size)
+{
+    _txBuffer.insert(_txBuffer.end(), buffer, buffer + size);
+
+    return size;
+}
+
+int TwoWire::available()
+{
+    return _rxBuffer.size() - _rxIndex;
+}
+
+int TwoWire::read()
+{
+    return _rxIndex < _rxBuffer.size() ? _rxBuffer[_rxIndex++] : -1;
+}
+
+TwoWire::Device *TwoWire::findDevice(uint8_t address)
+{
+    for (Device &device : _devices)
+    {
+        if (device.address == address)
+            return &device;
+    }
+
+    return nullptr;
+}
+
+bool TwoWire::answers(const Device *device)
+{
+    if (_highSpeed)
+        return device->hsClockHz != 0 && _clockHz <= device->hsClockHz;
+
+    return _clockHz <= device->maxClockHz;
+}
+
+// The first transfer after a master code starts Hs-mode.
+void TwoWire::startTransfer()
+{
+    if (_masterCodeSent)
+    {
+        _highSpeed = true;
+        _masterCodeSent = false;
+    }
+    else if (!_highSpeed && _clockHz > kMaxFastPlusClockHz)
+        violation("faster than 1MHz without a master code");
+}
+
+// A STOP ends Hs-mode.
+void TwoWire::record(const char *type, uint8_t address, const std::string &detail, bool stop)
+{
+    char name[8];
+
+    snprintf(name, sizeof(name), "0x%02X", address);
+    _events.push_back(std::string(type) + " " + name + " " + detail + (stop ? "stop " : "restart ") +
+                      std::to_string(_clockHz));
+
+    if (stop)
+        _highSpeed = false;
+}
+
+void TwoWire::violation(const char *rule)
+{
+    _violations++;
+    printf("bus rule broken: %s\n", rule);
+}
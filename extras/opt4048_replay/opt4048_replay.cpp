@@ -0,0 +1,297 @@
+/*
+opt4048_replay.cpp
+
+SparkFun Tristimulus Color Sensor - OPT4048
+
+Qwiic 1x1
+* https://www.sparkfun.com/products/
+Qwiic Mini
+* https://www.sparkfun.com/products/
+
+Repository:
+* https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+The MIT License (MIT)
+
+Copyright (c) 2022 SparkFun Electronics
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions: The
+above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED
+"AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+License(http://opensource.org/licenses/MIT).
+
+Command line tool that replays OPT4048 bus traces recorded with
+QwOpt4048TraceRecorder into the driver, on a host and at full speed.
+
+    opt4048_replay [-o output.csv] trace.bin
+    opt4048_replay --dump trace.bin
+    opt4048_replay --generate seconds trace.bin
+
+See README.md in this folder for how to compare builds.
+
+*/
+#include "sfe_opt4048.h"
+#include "sfe_opt4048_trace.h"
+#include "trace_replay.h"
+
+#include <cerrno>
+#include <chrono>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+using namespace sfe_OPT4048;
+
+namespace
+{
+
+// Virtual time at which generated traces start.
+constexpr uint64_t kGenerateStartUs = 1000000;
+
+class FilePrint : public Print
+{
+  public:
+    explicit FilePrint(FILE *file) : _file(file)
+    {
+    }
+
+    size_t write(uint8_t value) override
+    {
+        return fwrite(&value, 1, 1, _file);
+    }
+
+    size_t write(const uint8_t *buffer, size_t size) override
+    {
+        return fwrite(buffer, 1, size, _file);
+    }
+
+  private:
+    FILE *_file;
+};
+
+// The application code the trace was recorded from, starting where the recorder was inserted. It matches
+// examples/example25_TraceRecording; change it to match the sketch a field trace came from.
+template <typename More, typename Emit> void runScenario(QwOpt4048 &sensor, More more, Emit emit)
+{
+    sfe_color_t color;
+
+    sensor.setBasicSetup();
+
+    while (more())
+    {
+        if (sensor.waitForSample() && sensor.getAllChannelData(&color))
+            emit(color);
+    }
+}
+
+int generate(double seconds, const char *path)
+{
+    FILE *out = fopen(path, "wb");
+
+    if (!out)
+    {
+        fprintf(stderr, "cannot create %s\n", path);
+        return 1;
+    }
+
+    SimulatedOpt4048 device;
+    FilePrint print(out);
+    QwOpt4048 sensor;
+    QwOpt4048TraceRecorder recorder;
+    uint64_t samples = 0;
+
+    hostSetMicros(kGenerateStartUs);
+    uint64_t endUs = kGenerateStartUs + (uint64_t)(seconds * 1e6);
+
+    sensor.setCommunicationBus(device, 0x44);
+    recorder.begin(sensor, device, print);
+
+    runScenario(
+        sensor, [&] { return hostMicros() < endUs; }, [&](const sfe_color_t &) { samples++; });
+
+    bool ok = fclose(out) == 0 && recorder.getWriteErrors() == 0;
+
+    fprintf(stderr, "%" PRIu64 " samples, %" PRIu32 " transactions, %" PRIu32 " bytes\n", samples,
+            recorder.getTransactions(), recorder.getBytesWritten());
+
+    return ok ? 0 : 1;
+}
+
+int dump(const TraceFile &trace)
+{
+    static const char *const types[] = {"ping", "write", "read", "alert"};
+
+    for (const TraceRecord &record : trace.records())
+    {
+        const sfe_opt4048_trace_record_t &header = record.header;
+
+        printf("%" PRIu64 " %u %s 0x%02X 0x%02X %u %d", record.timeUs - trace.header().startMicros,
+               header.durationUs, header.type < 4 ? types[header.type] : "?", header.address, header.reg,
+               header.length, header.result);
+
+        if (opt4048TraceHasData(&header))
+        {
+            const uint8_t *data = trace.data(record);
+
+            printf(" ");
+            for (uint16_t i = 0; i < header.length; i++)
+                printf("%02X", data[i]);
+        }
+
+        printf("\n");
+    }
+
+    return 0;
+}
+
+int replay(const TraceFile &trace, FILE *out)
+{
+    TraceReplayBus bus(trace);
+    QwOpt4048 sensor;
+    sfe_cie_t cie;
+    uint64_t samples = 0;
+    uint64_t lastCalls = 0;
+
+    sensor.setCommunicationBus(bus, trace.header().i2cAddress);
+
+    fprintf(out, "time_us,red,green,blue,white,cie_x,cie_y,lux\n");
+
+    auto start = std::chrono::steady_clock::now();
+
+    // Stops at the end of the trace, or when the driver no longer touches the bus.
+    auto more = [&] {
+        bool progress = bus.stats().calls != lastCalls;
+        lastCalls = bus.stats().calls;
+        return progress && !bus.finished();
+    };
+
+    auto emit = [&](const sfe_color_t &color) {
+        opt4048CalculateCIE(&color, &cie);
+        fprintf(out, "%" PRIu64 ",%" PRIu32 ",%" PRIu32 ",%" PRIu32 ",%" PRIu32 ",%.6f,%.6f,%.3f\n",
+                hostMicros() - trace.header().startMicros, color.red, color.green, color.blue, color.white,
+                cie.CIEx, cie.CIEy, cie.lux);
+        samples++;
+    };
+
+    runScenario(sensor, more, emit);
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    const ReplayStats &stats = bus.stats();
+    double spanS = trace.records().empty()
+                       ? 0
+                       : (trace.records().back().timeUs - trace.header().startMicros) / 1e6;
+
+    fprintf(stderr,
+            "%zu records%s, %.1f s of bus traffic replayed in %.3f s\n"
+            "%" PRIu64 " samples, %" PRIu64 " calls, %" PRIu64 " matched, %" PRIu64 " skipped, %" PRIu64
+            " unmatched, %" PRIu64 " write mismatches, %zu not reached\n"
+            "recorded bus time %" PRIu64 " us\n",
+            trace.records().size(), trace.truncated() ? " (truncated)" : "", spanS, elapsed.count(), samples,
+            stats.calls, stats.matched, stats.skipped, stats.unmatched, stats.dataMismatches, bus.remaining(),
+            stats.busUs);
+
+    return 0;
+}
+
+// Accepts a positive, finite number of seconds and nothing else.
+bool parseSeconds(const char *text, double *seconds)
+{
+    char *end;
+
+    errno = 0;
+    *seconds = strtod(text, &end);
+
+    return end != text && *end == '\0' && errno == 0 && std::isfinite(*seconds) && *seconds > 0;
+}
+
+void usage()
+{
+    fprintf(stderr, "usage: opt4048_replay [-o output.csv] trace.bin\n"
+                    "       opt4048_replay --dump trace.bin\n"
+                    "       opt4048_replay --generate seconds trace.bin\n");
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const char *output = nullptr;
+    const char *input = nullptr;
+    bool dumpTrace = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "-o") && i + 1 < argc)
+            output = argv[++i];
+        else if (!strcmp(argv[i], "--dump"))
+            dumpTrace = true;
+        else if (!strcmp(argv[i], "--generate") && i + 2 < argc)
+        {
+            double seconds;
+
+            if (!parseSeconds(argv[i + 1], &seconds) || argv[i + 2][0] == '-')
+            {
+                usage();
+                return 2;
+            }
+
+            return generate(seconds, argv[i + 2]);
+        }
+        else if (argv[i][0] != '-' && !input)
+            input = argv[i];
+        else
+        {
+            usage();
+            return 2;
+        }
+    }
+
+    if (!input)
+    {
+        usage();
+        return 2;
+    }
+
+    TraceFile trace;
+    std::string error;
+
+    if (!trace.load(input, error))
+    {
+        fprintf(stderr, "%s: %s\n", input, error.c_str());
+        return 1;
+    }
+
+    if (dumpTrace)
+        return dump(trace);
+
+    FILE *out = output ? fopen(output, "w") : stdout;
+    if (!out)
+    {
+        fprintf(stderr, "cannot create %s\n", output);
+        return 1;
+    }
+
+    int result = replay(trace, out);
+
+    if (output && fclose(out) != 0)
+    {
+        fprintf(stderr, "error writing output\n");
+        return 1;
+    }
+
+    return result;
+}
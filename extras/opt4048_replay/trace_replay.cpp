@@ -0,0 +1,416 @@
+/*
+trace_replay.cpp
+
+SparkFun Tristimulus Color Sensor - OPT4048
+
+Qwiic 1x1
+* https://www.sparkfun.com/products/
+Qwiic Mini
+* https://www.sparkfun.com/products/
+
+Repository:
+* https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+The MIT License (MIT)
+
+Copyright (c) 2022 SparkFun Electronics
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions: The
+above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED
+"AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+License(http://opensource.org/licenses/MIT).
+
+The following functions implement the trace replay and the simulated sensor
+declared in trace_replay.h.
+
+*/
+#include "trace_replay.h"
+#include "OPT4048_Registers.h"
+#include "sfe_opt4048_decode.h"
+
+#include <cstdio>
+#include <cstring>
+
+namespace sfe_OPT4048
+{
+
+bool TraceFile::load(const std::string &path, std::string &error)
+{
+    FILE *in = fopen(path.c_str(), "rb");
+    std::vector<uint8_t> file;
+    uint8_t buff[65536];
+    size_t n;
+
+    if (!in)
+    {
+        error = "cannot open file";
+        return false;
+    }
+
+    while ((n = fread(buff, 1, sizeof(buff), in)) > 0)
+        file.insert(file.end(), buff, buff + n);
+
+    fclose(in);
+
+    if (file.size() < sizeof(_header))
+    {
+        error = "file too short for a trace header";
+        return false;
+    }
+
+    memcpy(&_header, file.data(), sizeof(_header));
+
+    if (memcmp(_header.magic, OPT4048_TRACE_MAGIC, sizeof(_header.magic)) != 0)
+    {
+        error = "not an OPT4048 trace";
+        return false;
+    }
+
+    if (_header.version != OPT4048_TRACE_VERSION || _header.recordSize != OPT4048_TRACE_RECORD_SIZE)
+    {
+        error = "unsupported trace version";
+        return false;
+    }
+
+    _records.clear();
+    _data.clear();
+    _truncated = false;
+
+    size_t pos = sizeof(_header);
+    uint64_t timeUs = _header.startMicros;
+    uint32_t lastUs = _header.startMicros;
+
+    while (pos < file.size())
+    {
+        TraceRecord record;
+
+        if (file.size() - pos < sizeof(record.header))
+        {
+            _truncated = true;
+            break;
+        }
+
+        memcpy(&record.header, &file[pos], sizeof(record.header));
+
+        size_t length = opt4048TraceHasData(&record.header) ? record.header.length : 0;
+
+        if (file.size() - pos - sizeof(record.header) < length)
+        {
+            _truncated = true;
+            break;
+        }
+
+        // Timestamps are 32 bit micros() values; consecutive records are less than 71 minutes apart.
+        timeUs += (uint32_t)(record.header.timestampUs - lastUs);
+        lastUs = record.header.timestampUs;
+
+        record.timeUs = timeUs;
+        record.dataOffset = _data.size();
+
+        _data.insert(_data.end(), &file[pos + sizeof(record.header)], &file[pos + sizeof(record.header)] + length);
+        _records.push_back(record);
+
+        pos += sizeof(record.header) + length;
+    }
+
+    return true;
+}
+
+const sfe_opt4048_trace_header_t &TraceFile::header() const
+{
+    return _header;
+}
+
+const std::vector<TraceRecord> &TraceFile::records() const
+{
+    return _records;
+}
+
+const uint8_t *TraceFile::data(const TraceRecord &record) const
+{
+    return _data.data() + record.dataOffset;
+}
+
+bool TraceFile::truncated() const
+{
+    return _truncated;
+}
+
+TraceReplayBus::TraceReplayBus(const TraceFile &trace) : _trace(trace)
+{
+    hostSetMicros(trace.header().startMicros);
+}
+
+const TraceRecord *TraceReplayBus::match(uint8_t type, uint8_t address, uint8_t reg, uint16_t length)
+{
+    const std::vector<TraceRecord> &records = _trace.records();
+    size_t end = _next + kLookahead < records.size() ? _next + kLookahead : records.size();
+
+    _stats.calls++;
+
+    for (size_t i = _next; i < end; i++)
+    {
+        const sfe_opt4048_trace_record_t &header = records[i].header;
+
+        if (header.type != type || header.address != address || header.reg != reg || header.length != length)
+            continue;
+
+        _stats.matched++;
+        _stats.skipped += i - _next;
+        _stats.busUs += header.durationUs;
+        _next = i + 1;
+        _unmatchedInRow = 0;
+
+        // The driver sees the time of the recorded transaction, and its duration.
+        hostAdvanceTo(records[i].timeUs);
+        hostAdvanceTo(records[i].timeUs + header.durationUs);
+
+        return &records[i];
+    }
+
+    _stats.unmatched++;
+    _unmatchedInRow++;
+
+    return nullptr;
+}
+
+bool TraceReplayBus::ping(uint8_t address)
+{
+    const TraceRecord *record = match(OPT4048_TRACE_PING, address, 0, 0);
+
+    return record != nullptr && record->header.result != 0;
+}
+
+int TraceReplayBus::writeRegisterRegion(uint8_t address, uint8_t offset, uint8_t *data, uint16_t length)
+{
+    const TraceRecord *record = match(OPT4048_TRACE_WRITE, address, offset, length);
+
+    if (record == nullptr)
+        return -1;
+
+    if (memcmp(_trace.data(*record), data, length) != 0)
+        _stats.dataMismatches++;
+
+    return record->header.result;
+}
+
+int TraceReplayBus::readRegisterRegion(uint8_t addr, uint8_t reg, uint8_t *data, uint16_t numBytes)
+{
+    const TraceRecord *record = match(OPT4048_TRACE_READ, addr, reg, numBytes);
+
+    if (record == nullptr)
+        return -1;
+
+    if (opt4048TraceHasData(&record->header))
+        memcpy(data, _trace.data(*record), numBytes);
+
+    return record->header.result;
+}
+
+int TraceReplayBus::alertResponse(uint8_t *response)
+{
+    const TraceRecord *record = match(OPT4048_TRACE_ALERT, 0x0C, 0, 1);
+
+    if (record == nullptr)
+        return -1;
+
+    if (opt4048TraceHasData(&record->header))
+        *response = *_trace.data(*record);
+
+    return record->header.result;
+}
+
+bool TraceReplayBus::finished() const
+{
+    return _next >= _trace.records().size() || _unmatchedInRow >= kMaxUnmatched;
+}
+
+size_t TraceReplayBus::remaining() const
+{
+    return _trace.records().size() - _next;
+}
+
+const ReplayStats &TraceReplayBus::stats() const
+{
+    return _stats;
+}
+
+SimulatedOpt4048::SimulatedOpt4048(uint8_t address) : _address(address)
+{
+    _regs[SFE_OPT4048_REGISTER_CONTROL] = OPT4048_CONTROL_DEFAULT;
+    _regs[SFE_OPT4048_REGISTER_INT_CONTROL] = OPT4048_INT_CONTROL_DEFAULT;
+    _regs[SFE_OPT4048_REGISTER_DEVICE_ID] = OPT4048_DEVICE_ID_REGISTER;
+}
+
+void SimulatedOpt4048::busTime(uint16_t bytes)
+{
+    // Address and register byte plus the data, nine clocks each at 400 kHz.
+    hostSetMicros(hostMicros() + (bytes + 2) * 45 / 2);
+}
+
+void SimulatedOpt4048::convert()
+{
+    opt4048_reg_control_t controlReg;
+    double t = hostMicros() / 1e6;
+    double green = (200 + 150 * sin(2 * M_PI * t / 60)) / 2.15e-3;
+    double codes[4] = {0.9 * green * (1 + 0.2 * sin(2 * M_PI * t / 17)), green,
+                       0.6 * green * (1 + 0.2 * cos(2 * M_PI * t / 23)), 2 * green};
+
+    controlReg.word = _regs[SFE_OPT4048_REGISTER_CONTROL];
+    _counter = (_counter + 1) & 0x0F;
+
+    for (uint8_t channel = 0; channel < 4; channel++)
+    {
+        uint8_t exponent = controlReg.range;
+        uint32_t code = (uint32_t)codes[channel];
+
+        // Auto range picks the finest range that holds the result.
+        if (exponent == RANGE_AUTO)
+            for (exponent = 0; exponent < RANGE_144LUX && (code >> exponent) > 0xFFFFF; exponent++)
+                ;
+
+        uint32_t mantissa = code >> exponent;
+        if (mantissa > 0xFFFFF)
+            mantissa = 0xFFFFF;
+
+        uint8_t crc = opt4048CalculateCRC(mantissa, exponent, _counter);
+
+        _regs[channel * 2] = (exponent << 12) | (mantissa >> 8);
+        _regs[channel * 2 + 1] = ((mantissa & 0xFF) << 8) | (_counter << 4) | crc;
+    }
+
+    _regs[SFE_OPT4048_REGISTER_FLAGS] |= 0x04;
+}
+
+void SimulatedOpt4048::update()
+{
+    opt4048_reg_control_t controlReg;
+
+    if (!_converting || hostMicros() < _nextConversionUs)
+        return;
+
+    controlReg.word = _regs[SFE_OPT4048_REGISTER_CONTROL];
+    uint32_t periodUs = opt4048ConversionTimeUs((opt4048_conversion_time_t)controlReg.conversion_time) * 4;
+
+    if (controlReg.op_mode == OPERATION_MODE_CONTINUOUS)
+    {
+        while (_nextConversionUs <= hostMicros())
+            _nextConversionUs += periodUs;
+    }
+    else
+    {
+        // A one-shot returns to power down.
+        controlReg.op_mode = OPERATION_MODE_POWER_DOWN;
+        _regs[SFE_OPT4048_REGISTER_CONTROL] = controlReg.word;
+        _converting = false;
+    }
+
+    convert();
+}
+
+uint64_t SimulatedOpt4048::getNextConversionUs() const
+{
+    opt4048_reg_control_t controlReg;
+
+    if (!_converting)
+        return 0;
+
+    if (_nextConversionUs > hostMicros())
+        return _nextConversionUs;
+
+    controlReg.word = _regs[SFE_OPT4048_REGISTER_CONTROL];
+
+    // A one-shot has completed, the next access powers down.
+    if (controlReg.op_mode != OPERATION_MODE_CONTINUOUS)
+        return 0;
+
+    uint32_t periodUs = opt4048ConversionTimeUs((opt4048_conversion_time_t)controlReg.conversion_time) * 4;
+
+    return _nextConversionUs + periodUs * ((hostMicros() - _nextConversionUs) / periodUs + 1);
+}
+
+uint64_t SimulatedOpt4048::getNextInterruptUs() const
+{
+    opt4048_reg_int_control_t intReg;
+
+    intReg.word = _regs[SFE_OPT4048_REGISTER_INT_CONTROL];
+
+    if (!intReg.int_dir || intReg.int_cfg != INT_DR_ALL_CHANNELS)
+        return 0;
+
+    return getNextConversionUs();
+}
+
+bool SimulatedOpt4048::ping(uint8_t address)
+{
+    busTime(0);
+
+    return address == _address;
+}
+
+int SimulatedOpt4048::writeRegisterRegion(uint8_t address, uint8_t offset, uint8_t *data, uint16_t length)
+{
+    opt4048_reg_control_t controlReg;
+
+    update();
+    busTime(length);
+
+    if (address != _address || offset + length / 2 > sizeof(_regs) / sizeof(_regs[0]))
+        return -1;
+
+    for (uint16_t i = 0; i < length / 2; i++)
+        _regs[offset + i] = (data[i * 2] << 8) | data[i * 2 + 1];
+
+    if (offset <= SFE_OPT4048_REGISTER_CONTROL && offset + length / 2 > SFE_OPT4048_REGISTER_CONTROL)
+    {
+        controlReg.word = _regs[SFE_OPT4048_REGISTER_CONTROL];
+        _converting = controlReg.op_mode != OPERATION_MODE_POWER_DOWN;
+        _nextConversionUs =
+            hostMicros() + opt4048ConversionTimeUs((opt4048_conversion_time_t)controlReg.conversion_time) * 4;
+    }
+
+    return 0;
+}
+
+int SimulatedOpt4048::readRegisterRegion(uint8_t addr, uint8_t reg, uint8_t *data, uint16_t numBytes)
+{
+    update();
+    busTime(numBytes);
+
+    if (addr != _address || reg + numBytes / 2 > sizeof(_regs) / sizeof(_regs[0]))
+        return -1;
+
+    for (uint16_t i = 0; i < numBytes / 2; i++)
+    {
+        data[i * 2] = _regs[reg + i] >> 8;
+        data[i * 2 + 1] = _regs[reg + i];
+    }
+
+    // Reading FLAGS clears the conversion ready flag.
+    if (reg <= SFE_OPT4048_REGISTER_FLAGS && reg + numBytes / 2 > SFE_OPT4048_REGISTER_FLAGS)
+        _regs[SFE_OPT4048_REGISTER_FLAGS] &= ~0x04;
+
+    return 0;
+}
+
+int SimulatedOpt4048::alertResponse(uint8_t *response)
+{
+    (void)response;
+    busTime(1);
+
+    // ALERT is never asserted.
+    return -1;
+}
+
+} // namespace sfe_OPT4048
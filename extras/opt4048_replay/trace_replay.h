@@ -0,0 +1,168 @@
+/*
+trace_replay.h
+
+SparkFun Tristimulus Color Sensor - OPT4048
+
+Qwiic 1x1
+* https://www.sparkfun.com/products/
+Qwiic Mini
+* https://www.sparkfun.com/products/
+
+Repository:
+* https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+The MIT License (MIT)
+
+Copyright (c) 2022 SparkFun Electronics
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions: The
+above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED
+"AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+License(http://opensource.org/licenses/MIT).
+
+Host side replay of OPT4048 bus traces recorded with QwOpt4048TraceRecorder.
+TraceReplayBus is a QwDeviceBus that answers the driver's transactions from
+the trace, so the unmodified driver runs against hours of field traffic in
+seconds. SimulatedOpt4048 is a register level model of the sensor, used to
+produce synthetic traces.
+
+Requires C++17.
+
+*/
+#pragma once
+#include "sfe_bus.h"
+#include "sfe_opt4048_trace_format.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace sfe_OPT4048
+{
+
+/// @brief One record of a loaded trace.
+struct TraceRecord
+{
+    sfe_opt4048_trace_record_t header;
+    uint64_t timeUs;   // Timestamp with the micros() wrap-around removed
+    size_t dataOffset; // Offset of the record's data in TraceFile::data()
+};
+
+/// @brief A trace read into memory.
+class TraceFile
+{
+  public:
+    /// @brief Reads and validates a trace. A record cut off at the end, e.g. by a power loss, is dropped.
+    /// @param path The trace file.
+    /// @param error Set to a description of the problem on failure.
+    /// @return True on success.
+    bool load(const std::string &path, std::string &error);
+
+    const sfe_opt4048_trace_header_t &header() const;
+    const std::vector<TraceRecord> &records() const;
+    const uint8_t *data(const TraceRecord &record) const;
+
+    /// @brief True if the file ended in the middle of a record.
+    bool truncated() const;
+
+  private:
+    sfe_opt4048_trace_header_t _header = {};
+    std::vector<TraceRecord> _records;
+    std::vector<uint8_t> _data;
+    bool _truncated = false;
+};
+
+/// @brief Counters gathered while replaying.
+struct ReplayStats
+{
+    uint64_t calls = 0;          // Bus calls made by the driver
+    uint64_t matched = 0;        // Calls answered from the trace
+    uint64_t skipped = 0;        // Records passed over to find a match, i.e. calls the driver no longer makes
+    uint64_t unmatched = 0;      // Calls without a matching record, i.e. calls the recorded driver didn't make
+    uint64_t dataMismatches = 0; // Matched writes whose bytes differ from the recording
+    uint64_t busUs = 0;          // Recorded duration of the matched transactions
+};
+
+/// @brief Answers bus transactions from a trace and drives the virtual clock from its timestamps.
+///        Every call is matched against the next records of the same type, address, register, and length;
+///        records that don't match within a short window are skipped, so a build that adds or drops
+///        transactions stays in step with the trace.
+class TraceReplayBus : public QwDeviceBus
+{
+  public:
+    explicit TraceReplayBus(const TraceFile &trace);
+
+    bool ping(uint8_t address) override;
+    int writeRegisterRegion(uint8_t address, uint8_t offset, uint8_t *data, uint16_t length) override;
+    int readRegisterRegion(uint8_t addr, uint8_t reg, uint8_t *data, uint16_t numBytes) override;
+    int alertResponse(uint8_t *response) override;
+
+    /// @brief True once every record was replayed or skipped, or the driver stopped matching the trace.
+    bool finished() const;
+
+    /// @brief Number of records not reached yet.
+    size_t remaining() const;
+
+    const ReplayStats &stats() const;
+
+    /// @brief Records searched ahead for a match.
+    static constexpr size_t kLookahead = 16;
+
+    /// @brief Unmatched calls in a row after which the replay gives up.
+    static constexpr uint32_t kMaxUnmatched = 64;
+
+  private:
+    const TraceRecord *match(uint8_t type, uint8_t address, uint8_t reg, uint16_t length);
+
+    const TraceFile &_trace;
+    size_t _next = 0;
+    uint32_t _unmatchedInRow = 0;
+    ReplayStats _stats;
+};
+
+/// @brief Register level model of an OPT4048 in continuous and one-shot mode, lit by a light that slowly
+///        changes in brightness and color. Transactions take the time of a 400 kHz bus on the virtual clock.
+class SimulatedOpt4048 : public QwDeviceBus
+{
+  public:
+    explicit SimulatedOpt4048(uint8_t address = 0x44);
+
+    bool ping(uint8_t address) override;
+    int writeRegisterRegion(uint8_t address, uint8_t offset, uint8_t *data, uint16_t length) override;
+    int readRegisterRegion(uint8_t addr, uint8_t reg, uint8_t *data, uint16_t numBytes) override;
+    int alertResponse(uint8_t *response) override;
+
+    /// @brief Retrieves the completion time of the next sample, e.g. to drive a simulated INT line.
+    /// @return The time on the host clock, or 0 if no conversion is running.
+    uint64_t getNextConversionUs() const;
+
+    /// @brief Retrieves the time the INT pin next signals a completed sample, as configured in INT_CONTROL:
+    ///        only an output with INT_DR_ALL_CHANNELS pulses once per sample. An input, SMBus alert, and
+    ///        INT_DR_NEXT_CHANNEL, whose per-channel pulses the simulation does not model, never do.
+    /// @return The time on the host clock, or 0 if the pin does not signal the next sample.
+    uint64_t getNextInterruptUs() const;
+
+  private:
+    void update();
+    void convert();
+    void busTime(uint16_t bytes);
+
+    uint8_t _address;
+    uint16_t _regs[0x12] = {};
+    uint64_t _nextConversionUs = 0;
+    uint8_t _counter = 0;
+    bool _converting = false;
+};
+
+} // namespace sfe_OPT4048
@@ -0,0 +1,42 @@
+#!/bin/sh
+# Flash and RAM of example 11 built with the virtual bus (BENCH_MODE 1) and with the direct bus (BENCH_MODE 2),
+# for each board, and the difference. Requires arduino-cli with the cores of the boards installed.
+#
+#   size_report.sh [fqbn ...]
+#
+# The default boards are an AVR, the Uno, and a 32 bit core, the Zero.
+
+set -e
+
+cd "$(dirname "$0")/../.."
+
+SKETCH=examples/example11_BusBenchmark
+BUILD=$(mktemp -d)
+trap 'rm -rf "$BUILD"' EXIT
+
+if [ $# -eq 0 ]; then
+    set -- arduino:avr:uno arduino:samd:arduino_zero_native
+fi
+
+# Prints "flash ram" of one build; ram is - on cores that don't report it.
+sizes()
+{
+    arduino-cli compile --fqbn "$1" --library . --build-path "$BUILD/$3" \
+        --build-property "compiler.cpp.extra_flags=-DBENCH_MODE=$2" "$SKETCH" 2>&1 |
+        awk '/Sketch uses/ { flash = $3 } /Global variables use/ { ram = $4 }
+             END { if (flash == "") exit 1; print flash, (ram == "" ? "-" : ram) }'
+}
+
+# Each column is flash/RAM in bytes.
+printf '%-36s %16s %16s %16s\n' "board" "virtual bus   " "direct bus    " "difference    "
+
+build=0
+for fqbn in "$@"; do
+    build=$((build + 2))
+    virtual=$(sizes "$fqbn" 1 $build) || { echo "$fqbn: build failed" >&2; continue; }
+    direct=$(sizes "$fqbn" 2 $((build + 1))) || { echo "$fqbn: build failed" >&2; continue; }
+
+    echo "$fqbn $virtual $direct" | awk '{
+        ram = ($3 == "-" || $5 == "-") ? "-" : sprintf("%+d", $5 - $3)
+        printf "%-36s %9d/%-6s %9d/%-6s %+9d/%-6s\n", $1, $2, $3, $4, $5, $4 - $2, ram }'
+done
@@ -35,7 +35,6 @@ The following file defines the registers for the opt4048 IC.
 */
 
 #pragma once
-#include "Arduino.h"
 #include <stdint.h>
 
 #define OPT4048_ADDR_HIGH 0x45 
@@ -46,6 +45,13 @@ The following file defines the registers for the opt4048 IC.
 
 #define OPT4048_DEVICE_ID 0x2084
 
+// Raw value of the DEVICE_ID register (0x11) that OPT4048_DEVICE_ID is decoded from.
+#define OPT4048_DEVICE_ID_REGISTER 0x0821
+
+// Power-on values of the CONTROL (0x0A) and INT_CONTROL (0x0B) registers.
+#define OPT4048_CONTROL_DEFAULT 0x3208
+#define OPT4048_INT_CONTROL_DEFAULT 0x8011
+
 // Setttings - use find in your editor for to search for "settings"
 // to scroll through all predefined setting types.
 /// @brief Range Settings found in Register 0x0A
@@ -39,9 +39,62 @@ interacting with the opt4048 IC.
 #pragma once
 #include "sfe_bus.h"
 #include "sfe_opt4048.h"
+#include "sfe_opt4048_alert.h"
+#include "sfe_opt4048_color.h"
+#include "sfe_opt4048_dark.h"
+#include "sfe_opt4048_events.h"
+#include "sfe_opt4048_filter.h"
+#include "sfe_opt4048_flicker.h"
+#include "sfe_opt4048_hdr.h"
+#include "sfe_opt4048_history.h"
+#include "sfe_opt4048_logger.h"
+#include "sfe_opt4048_palette.h"
+#include "sfe_opt4048_recovery.h"
+#include "sfe_opt4048_static.h"
+#include "sfe_opt4048_stats.h"
+#include "sfe_opt4048_stream.h"
+#include "sfe_opt4048_sync.h"
+#include "sfe_opt4048_trace.h"
 #include <Wire.h>
 
-class SparkFun_OPT4048 : public QwOpt4048
+/// @brief The I2C bus of the Arduino classes below, and the bus speed settings they share.
+/// @tparam Base The driver class, e.g. QwOpt4048.
+/// @tparam Bus The I2C bus class, sfe_OPT4048::QwI2C or sfe_OPT4048::QwI2CDirect.
+template <typename Base, typename Bus> class SparkFun_OPT4048I2C : public Base
+{
+  public:
+    /// @brief Sets the I2C clock used for this sensor. Sensors sharing a Wire port each keep their own
+    ///     speed, which is set before every transfer; afterwards the port returns to its default clock,
+    ///     see sfe_OPT4048::QwI2CDirect::setDefaultClock().
+    /// @param clockHz The SCL frequency, or 0 to use the default clock.
+    void setBusClock(uint32_t clockHz)
+    {
+        _i2cBus.setClock(clockHz);
+    }
+
+    /// @brief Enables I2C Hs-mode for this sensor. See sfe_OPT4048::QwI2CDirect::setHighSpeed().
+    /// @param hsClockHz The Hs-mode SCL frequency, or 0 to disable Hs-mode.
+    void setHighSpeed(uint32_t hsClockHz)
+    {
+        _i2cBus.setHighSpeed(hsClockHz);
+    }
+
+    /// @brief Finds and keeps the fastest I2C speed at which the sensor answers reliably: Hs-mode if a
+    ///     clock is given, then Fast-mode Plus, Fast-mode, and Standard-mode. Call after begin().
+    /// @param hsClockHz Hs-mode clock to try first, or 0 to skip Hs-mode.
+    /// @return The selected clock, or 0 if the sensor didn't answer at any speed.
+    uint32_t negotiateBusSpeed(uint32_t hsClockHz = 0)
+    {
+        return _i2cBus.negotiateClock(this->getI2CAddress(), SFE_OPT4048_REGISTER_DEVICE_ID,
+                                      OPT4048_DEVICE_ID_REGISTER, hsClockHz);
+    }
+
+  protected:
+    // I2C bus class
+    Bus _i2cBus;
+};
+
+class SparkFun_OPT4048 : public SparkFun_OPT4048I2C<QwOpt4048, sfe_OPT4048::QwI2C>
 {
 
   public:
@@ -84,7 +137,110 @@ class SparkFun_OPT4048 : public QwOpt4048
         return this->QwOpt4048::init();
     }
 
-  private:
-    // I2C bus class
-    sfe_OPT4048::QwI2C _i2cBus;
+    /// @brief Fast alternative to begin() followed by the setters: the configuration is written in a
+    ///     single burst and, unless verify is set, nothing else is sent. See QwOpt4048::fastStart().
+    /// @param control CONTROL register image, e.g. QwOpt4048Static<...>::kControl.
+    /// @param intControl INT_CONTROL register image, e.g. QwOpt4048Static<...>::kIntControl.
+    /// @param readyAtMicros Optional pointer to store the predicted completion time of the first sample.
+    /// @param verify Pings the device and checks its ID first.
+    /// @param deviceAddress The I2C Address of the device if not provided, the default address is used.
+    /// @return True on success, false on startup failure
+    bool beginFast(uint16_t control, uint16_t intControl, uint32_t *readyAtMicros = nullptr, bool verify = false,
+                   uint8_t deviceAddress = OPT4048_ADDR_LOW)
+    {
+        setCommunicationBus(_i2cBus, deviceAddress);
+
+        _i2cBus.init();
+
+        return fastStart(control, intControl, readyAtMicros, verify);
+    }
+
+    /// @brief Fast alternative to begin() followed by the setters. See QwOpt4048::fastStart().
+    /// @param wirePort The Wire port - Arduino specific.
+    /// @param control CONTROL register image, e.g. QwOpt4048Static<...>::kControl.
+    /// @param intControl INT_CONTROL register image, e.g. QwOpt4048Static<...>::kIntControl.
+    /// @param readyAtMicros Optional pointer to store the predicted completion time of the first sample.
+    /// @param verify Pings the device and checks its ID first.
+    /// @param deviceAddress The I2C Address of the device if not provided, the default address is used.
+    /// @return True on success, false on startup failure
+    bool beginFast(TwoWire &wirePort, uint16_t control, uint16_t intControl, uint32_t *readyAtMicros = nullptr,
+                   bool verify = false, uint8_t deviceAddress = OPT4048_ADDR_LOW)
+    {
+        setCommunicationBus(_i2cBus, deviceAddress);
+
+        _i2cBus.init(wirePort, true);
+
+        return fastStart(control, intControl, readyAtMicros, verify);
+    }
+};
+
+/// @brief Arduino version of QwOpt4048Static: the sensor configuration is given as template arguments
+///        and written in one burst by begin(). Example:
+///        SparkFun_OPT4048Static<RANGE_AUTO, CONVERSION_TIME_100MS, OPERATION_MODE_CONTINUOUS> myColor;
+template <opt4048_range_t Range, opt4048_conversion_time_t ConversionTime, opt4048_operation_mode_t Mode,
+          opt4048_int_cfg_t IntMechanism = INT_DR_ALL_CHANNELS, opt4048_threshold_channel_t ThresholdChannel =
+                                                                  THRESH_CHANNEL_CH0,
+          opt4048_fault_count_t FaultCount = FAULT_COUNT_1, bool IntLatch = true, bool IntActiveHigh = false,
+          bool IntInput = false, bool Qwake = false>
+class SparkFun_OPT4048Static
+    : public SparkFun_OPT4048I2C<QwOpt4048Static<Range, ConversionTime, Mode, IntMechanism, ThresholdChannel,
+                                                 FaultCount, IntLatch, IntActiveHigh, IntInput, Qwake>,
+                                 sfe_OPT4048::QwI2C>
+{
+  public:
+    /// @brief Connects to the device and writes the compile-time configuration.
+    /// @param deviceAddress The I2C Address of the device if not provided, the default address is used.
+    /// @return True on success, false on startup failure
+    bool begin(uint8_t deviceAddress = OPT4048_ADDR_LOW)
+    {
+        this->setCommunicationBus(this->_i2cBus, deviceAddress);
+
+        this->_i2cBus.init();
+
+        return this->init();
+    }
+
+    /// @brief Connects to the device and writes the compile-time configuration.
+    /// @param wirePort The Wire port - Arduino specific.
+    /// @param deviceAddress The I2C Address of the device if not provided, the default address is used.
+    /// @return True on success, false on startup failure
+    bool begin(TwoWire &wirePort, uint8_t deviceAddress = OPT4048_ADDR_LOW)
+    {
+        this->setCommunicationBus(this->_i2cBus, deviceAddress);
+
+        this->_i2cBus.init(wirePort, true);
+
+        return this->init();
+    }
+};
+
+/// @brief Arduino version of QwOpt4048Direct: the full driver with the I2C bus bound at compile time, so
+///        register accesses are not dispatched through QwDeviceBus.
+class SparkFun_OPT4048Direct : public SparkFun_OPT4048I2C<QwOpt4048Direct, sfe_OPT4048::QwI2CDirect>
+{
+  public:
+    /// @brief Sets the I2C port and checks that the device is connected.
+    /// @param deviceAddress The I2C Address of the device if not provided, the default address is used.
+    /// @return True on success, false on startup failure
+    bool begin(uint8_t deviceAddress = OPT4048_ADDR_LOW)
+    {
+        setCommunicationBus(_i2cBus, deviceAddress);
+
+        _i2cBus.init();
+
+        return init();
+    }
+
+    /// @brief Sets the I2C port and checks that the device is connected.
+    /// @param wirePort The Wire port - Arduino specific.
+    /// @param deviceAddress The I2C Address of the device if not provided, the default address is used.
+    /// @return True on success, false on startup failure
+    bool begin(TwoWire &wirePort, uint8_t deviceAddress = OPT4048_ADDR_LOW)
+    {
+        setCommunicationBus(_i2cBus, deviceAddress);
+
+        _i2cBus.init(wirePort, true);
+
+        return init();
+    }
 };
@@ -37,19 +37,162 @@ over Inter-Integrated Circuit (I2C).
 
 #include "sfe_bus.h"
 
-#define kMaxTransferBuffer 32
+// Hs-mode master codes are sent at Fast-mode speed.
+const static uint32_t kMasterCodeClockHz = 400000;
 
-// What we use for transfer chunk size
-const static uint16_t kChunkSize = kMaxTransferBuffer;
+// Clock of a port after Wire.begin().
+const static uint32_t kDefaultClockHz = 100000;
+
+// Speeds tried by negotiateClock() after Hs-mode, fastest first: Fast-mode Plus, Fast-mode, Standard-mode.
+const static uint32_t kNegotiateClocksHz[] = {1000000, 400000, 100000};
+
+// SMBus Alert Response Address (0001 100) as a 7 bit address.
+const static uint8_t kAlertResponseAddress = 0x0C;
+
+// Consecutive good device ID reads needed to accept a speed.
+const static uint8_t kNegotiateReads = 3;
 
 namespace sfe_OPT4048
 {
 
+// Last clock set on a port. Several devices on one port can run at different speeds, so setClock()
+// is only called when the speed actually changes.
+static TwoWire *lastClockPort = nullptr;
+static uint32_t lastClockHz = 0;
+
+// Clock the port is returned to after a transfer at a device's own speed.
+static uint32_t defaultClockHz = kDefaultClockHz;
+
+static void applyClock(TwoWire *port, uint32_t clockHz)
+{
+    if (port == lastClockPort && clockHz == lastClockHz)
+        return;
+
+    port->setClock(clockHz);
+    lastClockPort = port;
+    lastClockHz = clockHz;
+}
+
+/// @brief Forgets the clock last set on the I2C port, e.g. after Wire.begin() reset it.
+void QwI2CDirect::invalidateClock()
+{
+    lastClockPort = nullptr;
+}
+
+/// @brief Sets the clock the port is returned to after each transfer at a device's own speed, so that
+///        devices without one, including those driven by other libraries, keep running at it.
+/// @param clockHz The SCL frequency the application uses for the port, 100kHz unless set.
+void QwI2CDirect::setDefaultClock(uint32_t clockHz)
+{
+    defaultClockHz = clockHz;
+}
+
+/// @brief Sets the clock used for this device. Devices sharing a port each keep their own speed.
+/// @param clockHz The SCL frequency, or 0 to use the default clock, see setDefaultClock().
+void QwI2CDirect::setClock(uint32_t clockHz)
+{
+    _clockHz = clockHz;
+}
+
+/// @brief Enables Hs-mode for this device. Each transfer starts with the master code at Fast-mode speed,
+///        followed by a repeated start at the Hs clock. This needs a controller that can clock at Hs
+///        rates and keeps the bus after the master code is NACKed, which not every core does; use
+///        negotiateClock() to check.
+/// @param hsClockHz The Hs-mode SCL frequency, or 0 to disable Hs-mode.
+/// @param masterCode The master code 0000 1XX0 to send, XX taken from bits 1:0. The Wire API can only
+///        send a write bit, so the last bit is always 0.
+void QwI2CDirect::setHighSpeed(uint32_t hsClockHz, uint8_t masterCode)
+{
+    _hsClockHz = hsClockHz;
+    _masterCode = masterCode & 0x03;
+}
+
+/// @brief Retrieves the clock used for this device.
+/// @return The Hs-mode clock if enabled, otherwise the device clock (0 if the port clock is used).
+uint32_t QwI2CDirect::getClock()
+{
+    return _hsClockHz ? _hsClockHz : _clockHz;
+}
+
+/// @brief Prepares the port for a transfer to this device at its own speed: sets its clock, and in
+///        Hs-mode sends the master code without a STOP.
+void QwI2CDirect::selectClock()
+{
+    if (_hsClockHz)
+    {
+        applyClock(_i2cPort, kMasterCodeClockHz);
+
+        // 0000 1XX0 as a 7 bit address with the write bit. No device acknowledges a master code.
+        _i2cPort->beginTransmission((uint8_t)(0x04 | _masterCode));
+        _i2cPort->endTransmission(false);
+
+        applyClock(_i2cPort, _hsClockHz);
+    }
+    else
+        applyClock(_i2cPort, _clockHz);
+}
+
+/// @brief Returns the port to the default clock after a transfer at this device's own speed. In Hs-mode
+///        the STOP has already ended Hs-mode on the bus.
+void QwI2CDirect::restoreClock()
+{
+    applyClock(_i2cPort, defaultClockHz);
+}
+
+/// @brief Finds the fastest speed at which the device answers reliably: Hs-mode if requested, then
+///        Fast-mode Plus, Fast-mode, and Standard-mode. A speed is accepted when the ID register reads
+///        back correctly several times in a row, and it is kept as the device clock.
+/// @param address I2C address of device
+/// @param idRegister Register holding the device ID
+/// @param expectedId The device ID, read as a big endian 16 bit value
+/// @param hsClockHz Hs-mode clock to try first, or 0 to skip Hs-mode
+/// @return The selected clock, or 0 if the device didn't answer at any speed.
+uint32_t QwI2CDirect::negotiateClock(uint8_t address, uint8_t idRegister, uint16_t expectedId, uint32_t hsClockHz)
+{
+    if (hsClockHz)
+    {
+        setHighSpeed(hsClockHz);
+
+        if (probe(address, idRegister, expectedId))
+            return hsClockHz;
+
+        setHighSpeed(0);
+    }
+
+    for (uint8_t i = 0; i < sizeof(kNegotiateClocksHz) / sizeof(kNegotiateClocksHz[0]); i++)
+    {
+        setClock(kNegotiateClocksHz[i]);
+
+        if (probe(address, idRegister, expectedId))
+            return kNegotiateClocksHz[i];
+    }
+
+    setClock(0);
+
+    return 0;
+}
+
+bool QwI2CDirect::probe(uint8_t address, uint8_t idRegister, uint16_t expectedId)
+{
+    uint8_t buff[2];
+
+    for (uint8_t i = 0; i < kNegotiateReads; i++)
+    {
+        if (readRegisterRegion(address, idRegister, buff, 2) != 0)
+            return false;
+
+        if (((buff[0] << 8) | buff[1]) != expectedId)
+            return false;
+    }
+
+    return true;
+}
+
 /// @brief  Initializes I2C and checks for device
 /// @param wirePort I2C port
 /// @param bInit   If true, initializes the I2C port
 /// @return True if device is present and initialized, false otherwise
-bool QwI2C::init(TwoWire &wirePort, bool bInit)
+bool QwI2CDirect::init(TwoWire &wirePort, bool bInit)
 {
 
     // if we don't have a wire port already
@@ -66,7 +209,7 @@ bool QwI2C::init(TwoWire &wirePort, bool bInit)
 
 /// @brief Initializes I2C and checks for device
 /// @return True if device is present and initialized, false otherwise
-bool QwI2C::init()
+bool QwI2CDirect::init()
 {
     if (!_i2cPort)
         return init(Wire);
@@ -74,84 +217,29 @@ bool QwI2C::init()
         return false;
 }
 
-/// @brief Checks for device presence on the I2C bus
-/// @param i2c_address I2C address of device
-/// @return True if device is present, false otherwise
-bool QwI2C::ping(uint8_t i2c_address)
-{
-
-    if (!_i2cPort)
-        return false;
-
-    _i2cPort->beginTransmission(i2c_address);
-    return _i2cPort->endTransmission() == 0;
-}
-
-/// @brief Reads a register region from a device.
-/// @param i2c_address I2C address of device
-/// @param offset Register offset to read from
-/// @param data Pointer to byte to store read data
-/// @param length Number of bytes to read
-/// @return Number of bytes read (-1 indicates failure)
-int QwI2C::writeRegisterRegion(uint8_t i2c_address, uint8_t offset, uint8_t *data, uint16_t length)
+/// @brief Reads the SMBus Alert Response Address. Every device asserting ALERT answers with its own
+///        address; the lowest address wins arbitration and releases ALERT, the others keep it asserted
+///        and answer the next query.
+/// @param response Pointer to store the response: the 7 bit address in bits 7:1, a device specific
+///        status bit in bit 0.
+/// @return 0 on success, -1 if no device answered (ALERT is not asserted)
+int QwI2CDirect::alertResponse(uint8_t *response)
 {
-
-    _i2cPort->beginTransmission(i2c_address);
-    _i2cPort->write(offset);
-    _i2cPort->write(data, (int)length);
-
-    return _i2cPort->endTransmission() ? -1 : 0; // -1 = error, 0 = success
-}
-
-/// @brief Reads a single byte from a register
-/// @param addr I2C address of device
-/// @param reg  Register offset to read from
-/// @param data Pointer to byte to store read data
-/// @param numBytes Number of bytes to read
-/// @return Number of bytes read (-1 indicates failure)
-int QwI2C::readRegisterRegion(uint8_t addr, uint8_t reg, uint8_t *data, uint16_t numBytes)
-{
-    uint8_t nChunk;
-    uint16_t nReturned;
-
     if (!_i2cPort)
         return -1;
 
-    int i;
-    bool bFirstInter = true;
-
-    while (numBytes > 0)
-    {
-        _i2cPort->beginTransmission(addr);
-
-        if (bFirstInter)
-        {
-            _i2cPort->write(reg);
-            bFirstInter = false;
-        }
+    beginAccess();
 
-        if (_i2cPort->endTransmission() != 0)
-            return -1;
+    uint8_t nReturned = _i2cPort->requestFrom((int)kAlertResponseAddress, (int)1, (int)true);
 
-        // We're chunking in data - keeping the max chunk to kMaxI2CBufferLength
-        nChunk = numBytes > kChunkSize ? kChunkSize : numBytes;
+    endAccess();
 
-        nReturned = _i2cPort->requestFrom((int)addr, (int)nChunk, (int)true);
-
-        if (nReturned == 0)
-            return -1;
-
-        for (i = 0; i < nReturned; i++)
-        {
-            *data++ = _i2cPort->read();
-        }
-
-        // Decrement the amount of data recieved from the overall data request amount
-        numBytes = numBytes - nReturned;
+    if (nReturned == 0)
+        return -1;
 
-    } // end while
+    *response = _i2cPort->read();
 
-    return 0; // Success
+    return 0;
 }
 
 } // namespace sfe_OPT4048
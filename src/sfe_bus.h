@@ -53,27 +53,234 @@ class QwDeviceBus
     virtual int writeRegisterRegion(uint8_t address, uint8_t offset, uint8_t *data, uint16_t length) = 0;
 
     virtual int readRegisterRegion(uint8_t addr, uint8_t reg, uint8_t *data, uint16_t numBytes) = 0;
+
+    /// @brief Reads the SMBus Alert Response Address. Buses without support report that no device answered,
+    ///        so implementations written before it keep compiling.
+    /// @param response Pointer to store the response.
+    /// @return 0 on success, -1 if no device answered.
+    virtual int alertResponse(uint8_t *response)
+    {
+        (void)response;
+        return -1;
+    }
 };
 
-/// @brief This class implements the I2C interface for the OPT4048
-class QwI2C : public QwDeviceBus
+/// @brief Non-virtual I2C interface for the OPT4048. QwOpt4048Direct binds to it at compile time, and the
+///        transfers are defined here so register accesses resolve statically and can be inlined. Only the
+///        clock switching for a device speed of its own is out of line.
+class QwI2CDirect
 {
   public:
 
-    QwI2C(void) : _i2cPort(nullptr) {};
+    QwI2CDirect(void) : _i2cPort(nullptr), _clockHz(0), _hsClockHz(0), _masterCode(0) {};
 
     bool init();
 
     bool init(TwoWire &wirePort, bool bInit = false);
 
-    bool ping(uint8_t address);
+    /// @brief Checks for device presence on the I2C bus
+    /// @param i2c_address I2C address of device
+    /// @return True if device is present, false otherwise
+    bool ping(uint8_t i2c_address)
+    {
+        if (!_i2cPort)
+            return false;
+
+        bool success;
+
+        beginAccess();
+
+        _i2cPort->beginTransmission(i2c_address);
+        success = _i2cPort->endTransmission() == 0;
+
+        endAccess();
+
+        return success;
+    }
+
+    /// @brief Writes a register region to a device.
+    /// @param i2c_address I2C address of device
+    /// @param offset Register offset to write to
+    /// @param data Pointer to the data to write
+    /// @param length Number of bytes to write
+    /// @return 0 on success, -1 on failure
+    int writeRegisterRegion(uint8_t i2c_address, uint8_t offset, uint8_t *data, uint16_t length)
+    {
+        uint8_t status;
+
+        beginAccess();
+
+        _i2cPort->beginTransmission(i2c_address);
+        _i2cPort->write(offset);
+        _i2cPort->write(data, (int)length);
+
+        status = _i2cPort->endTransmission();
+
+        endAccess();
+
+        return status ? -1 : 0; // -1 = error, 0 = success
+    }
+
+    /// @brief Reads a register region from a device, in chunks that fit the Wire buffer.
+    /// @param addr I2C address of device
+    /// @param reg  Register offset to read from
+    /// @param data Pointer to store the read data
+    /// @param numBytes Number of bytes to read
+    /// @return 0 on success, -1 on failure
+    int readRegisterRegion(uint8_t addr, uint8_t reg, uint8_t *data, uint16_t numBytes)
+    {
+        uint8_t nChunk;
+        uint16_t nReturned;
+
+        if (!_i2cPort)
+            return -1;
+
+        int i;
+        bool bFirstInter = true;
+
+        while (numBytes > 0)
+        {
+            beginAccess();
+
+            _i2cPort->beginTransmission(addr);
+
+            if (bFirstInter)
+            {
+                _i2cPort->write(reg);
+                bFirstInter = false;
+            }
+
+            // A STOP would end Hs-mode, so the read follows with a repeated start.
+            if (_i2cPort->endTransmission(!_hsClockHz) != 0)
+            {
+                endAccess();
+                return -1;
+            }
+
+            // We're chunking in data - keeping the max chunk to the Wire buffer
+            nChunk = numBytes > kChunkSize ? (uint16_t)kChunkSize : numBytes;
+
+            nReturned = _i2cPort->requestFrom((int)addr, (int)nChunk, (int)true);
+
+            endAccess();
+
+            if (nReturned == 0)
+                return -1;
+
+            for (i = 0; i < nReturned; i++)
+            {
+                *data++ = _i2cPort->read();
+            }
+
+            // Decrement the amount of data recieved from the overall data request amount
+            numBytes = numBytes - nReturned;
+
+        } // end while
 
-    int writeRegisterRegion(uint8_t address, uint8_t offset, uint8_t *data, uint16_t length);
+        return 0; // Success
+    }
 
-    int readRegisterRegion(uint8_t addr, uint8_t reg, uint8_t *data, uint16_t numBytes);
+    int alertResponse(uint8_t *response);
+
+    void setClock(uint32_t clockHz);
+
+    void setHighSpeed(uint32_t hsClockHz, uint8_t masterCode = 1);
+
+    uint32_t getClock();
+
+    uint32_t negotiateClock(uint8_t address, uint8_t idRegister, uint16_t expectedId, uint32_t hsClockHz = 0);
+
+    static void invalidateClock();
+
+    static void setDefaultClock(uint32_t clockHz);
 
   private:
+    // What we use for transfer chunk size: the Wire buffer.
+    enum
+    {
+        kChunkSize = 32
+    };
+
+    // A device at the port clock needs no clock switching, so only the test is inlined.
+    void beginAccess()
+    {
+        if (_hsClockHz || _clockHz)
+            selectClock();
+    }
+
+    void endAccess()
+    {
+        if (_hsClockHz || _clockHz)
+            restoreClock();
+    }
+
+    void selectClock();
+    void restoreClock();
+    bool probe(uint8_t address, uint8_t idRegister, uint16_t expectedId);
+
     TwoWire *_i2cPort;
+    uint32_t _clockHz;
+    uint32_t _hsClockHz;
+    uint8_t _masterCode;
+};
+
+/// @brief This class implements the I2C interface for the OPT4048
+class QwI2C final : public QwDeviceBus
+{
+  public:
+
+    bool init()
+    {
+        return _i2c.init();
+    }
+
+    bool init(TwoWire &wirePort, bool bInit = false)
+    {
+        return _i2c.init(wirePort, bInit);
+    }
+
+    bool ping(uint8_t address)
+    {
+        return _i2c.ping(address);
+    }
+
+    int writeRegisterRegion(uint8_t address, uint8_t offset, uint8_t *data, uint16_t length)
+    {
+        return _i2c.writeRegisterRegion(address, offset, data, length);
+    }
+
+    int readRegisterRegion(uint8_t addr, uint8_t reg, uint8_t *data, uint16_t numBytes)
+    {
+        return _i2c.readRegisterRegion(addr, reg, data, numBytes);
+    }
+
+    int alertResponse(uint8_t *response)
+    {
+        return _i2c.alertResponse(response);
+    }
+
+    void setClock(uint32_t clockHz)
+    {
+        _i2c.setClock(clockHz);
+    }
+
+    void setHighSpeed(uint32_t hsClockHz, uint8_t masterCode = 1)
+    {
+        _i2c.setHighSpeed(hsClockHz, masterCode);
+    }
+
+    uint32_t getClock()
+    {
+        return _i2c.getClock();
+    }
+
+    uint32_t negotiateClock(uint8_t address, uint8_t idRegister, uint16_t expectedId, uint32_t hsClockHz = 0)
+    {
+        return _i2c.negotiateClock(address, idRegister, expectedId, hsClockHz);
+    }
+
+  private:
+    QwI2CDirect _i2c;
 };
 
 } // namespace sfe_OPT4048
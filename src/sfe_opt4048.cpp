@@ -37,9 +37,17 @@ main functionality for the OPT4048 IC.
 */
 #include "sfe_opt4048.h"
 #include "OPT4048_Registers.h"
+#include "sfe_opt4048_dark.h"
+#include "sfe_opt4048_log_format.h"
 #include <math.h>
+#include <stddef.h>
+#include <string.h>
 
-bool QwOpt4048::init(void)
+static_assert(sizeof(QwOpt4048) <= OPT4048_INSTANCE_RAM_BUDGET, "QwOpt4048 exceeds its per-instance RAM budget");
+static_assert(sizeof(QwOpt4048Direct) <= OPT4048_INSTANCE_RAM_BUDGET,
+              "QwOpt4048Direct exceeds its per-instance RAM budget");
+
+template <class TBus> bool QwOpt4048Driver<TBus>::init(void)
 {
     if (!_sfeBus->ping(_i2cAddress))
         return false;
@@ -47,10 +55,38 @@ bool QwOpt4048::init(void)
     if (getDeviceID() != OPT4048_DEVICE_ID)
         return false;
 
+    // Seeds the CONTROL shadow used for conversion timing.
+    uint8_t buff[2];
+    if (readRegisterRegion(SFE_OPT4048_REGISTER_CONTROL, buff) != 0)
+        return false;
+
     return true;
 }
 
-bool QwOpt4048::isConnected()
+template <class TBus>
+bool QwOpt4048Driver<TBus>::fastStart(uint16_t control, uint16_t intControl, uint32_t *readyAtMicros, bool verify)
+{
+    uint8_t buff[4];
+
+    if (verify && (!_sfeBus->ping(_i2cAddress) || getDeviceID() != OPT4048_DEVICE_ID))
+        return false;
+
+    buff[0] = control >> 8;
+    buff[1] = control;
+    buff[2] = intControl >> 8;
+    buff[3] = intControl;
+
+    // Also starts the conversion timing prediction.
+    if (writeRegisterRegion(SFE_OPT4048_REGISTER_CONTROL, buff, 4) != 0)
+        return false;
+
+    if (readyAtMicros != nullptr)
+        *readyAtMicros = _sampleDueMicros;
+
+    return true;
+}
+
+template <class TBus> bool QwOpt4048Driver<TBus>::isConnected()
 {
     if (getDeviceID() != OPT4048_DEVICE_ID)
         return false;
@@ -58,7 +94,7 @@ bool QwOpt4048::isConnected()
         return true;
 }
 
-uint16_t QwOpt4048::getDeviceID()
+template <class TBus> uint16_t QwOpt4048Driver<TBus>::getDeviceID()
 {
 
     uint8_t buff[2];
@@ -79,35 +115,71 @@ uint16_t QwOpt4048::getDeviceID()
     return uniqueId;
 }
 
-void QwOpt4048::setCommunicationBus(sfe_OPT4048::QwDeviceBus &theBus, uint8_t i2cAddress)
+template <class TBus> void QwOpt4048Driver<TBus>::setCommunicationBus(TBus &theBus, uint8_t i2cAddress)
 {
     _sfeBus = &theBus;
     _i2cAddress = i2cAddress;
 }
 
-void QwOpt4048::setCommunicationBus(sfe_OPT4048::QwDeviceBus &theBus)
+template <class TBus> void QwOpt4048Driver<TBus>::setCommunicationBus(TBus &theBus)
 {
     _sfeBus = &theBus;
 }
 
-int32_t QwOpt4048::writeRegisterRegion(uint8_t offset, uint8_t *data, uint16_t length)
+template <class TBus> TBus *QwOpt4048Driver<TBus>::getCommunicationBus()
+{
+    return _sfeBus;
+}
+
+template <class TBus> uint8_t QwOpt4048Driver<TBus>::getI2CAddress()
+{
+    return _i2cAddress;
+}
+
+template <class TBus> int32_t QwOpt4048Driver<TBus>::writeRegisterRegion(uint8_t offset, uint8_t *data, uint16_t length)
 {
-    return _sfeBus->writeRegisterRegion(_i2cAddress, offset, data, length);
+    int32_t retVal;
+
+    retVal = _sfeBus->writeRegisterRegion(_i2cAddress, offset, data, length);
+
+    if (retVal == 0 && offset <= SFE_OPT4048_REGISTER_CONTROL && offset + length / 2 > SFE_OPT4048_REGISTER_CONTROL)
+        updateControlShadow(&data[(SFE_OPT4048_REGISTER_CONTROL - offset) * 2], true);
+
+    return retVal;
 }
 
-int32_t QwOpt4048::readRegisterRegion(uint8_t offset, uint8_t *data, uint16_t length)
+template <class TBus> int32_t QwOpt4048Driver<TBus>::readRegisterRegion(uint8_t offset, uint8_t *data, uint16_t length)
 {
-    return _sfeBus->readRegisterRegion(_i2cAddress, offset, data, length);
+    int32_t retVal;
+
+    retVal = _sfeBus->readRegisterRegion(_i2cAddress, offset, data, length);
+
+    if (retVal == 0 && offset <= SFE_OPT4048_REGISTER_CONTROL && offset + length / 2 > SFE_OPT4048_REGISTER_CONTROL)
+        updateControlShadow(&data[(SFE_OPT4048_REGISTER_CONTROL - offset) * 2], false);
+
+    return retVal;
 }
 
-void QwOpt4048::setBasicSetup()
+template <class TBus> int32_t QwOpt4048Driver<TBus>::readAlertResponse(uint8_t *address)
+{
+    uint8_t response;
+
+    if (_sfeBus->alertResponse(&response) != 0)
+        return -1;
+
+    *address = response >> 1;
+
+    return 0;
+}
+
+template <class TBus> void QwOpt4048Driver<TBus>::setBasicSetup()
 {
     setRange(RANGE_36LUX);
     setConversionTime(CONVERSION_TIME_200MS);
     setOperationMode(OPERATION_MODE_CONTINUOUS);
 }
 
-bool QwOpt4048::setRange(opt4048_range_t range)
+template <class TBus> bool QwOpt4048Driver<TBus>::setRange(opt4048_range_t range)
 {
     uint8_t buff[2];
     int32_t retVal;
@@ -134,7 +206,7 @@ bool QwOpt4048::setRange(opt4048_range_t range)
     return true;
 }
 
-opt4048_range_t QwOpt4048::getRange()
+template <class TBus> opt4048_range_t QwOpt4048Driver<TBus>::getRange()
 {
     uint8_t buff[2];
     opt4048_reg_control_t controlReg;
@@ -147,7 +219,7 @@ opt4048_range_t QwOpt4048::getRange()
     return (opt4048_range_t)controlReg.range;
 }
 
-bool QwOpt4048::setConversionTime(opt4048_conversion_time_t time)
+template <class TBus> bool QwOpt4048Driver<TBus>::setConversionTime(opt4048_conversion_time_t time)
 {
     uint8_t buff[2];
     int32_t retVal;
@@ -174,7 +246,7 @@ bool QwOpt4048::setConversionTime(opt4048_conversion_time_t time)
     return true;
 }
 
-opt4048_conversion_time_t QwOpt4048::getConversionTime()
+template <class TBus> opt4048_conversion_time_t QwOpt4048Driver<TBus>::getConversionTime()
 {
     uint8_t buff[2];
     opt4048_reg_control_t controlReg;
@@ -187,7 +259,7 @@ opt4048_conversion_time_t QwOpt4048::getConversionTime()
     return (opt4048_conversion_time_t)controlReg.conversion_time;
 }
 
-bool QwOpt4048::setQwake(bool enable)
+template <class TBus> bool QwOpt4048Driver<TBus>::setQwake(bool enable)
 {
     uint8_t buff[2];
     int32_t retVal;
@@ -214,7 +286,7 @@ bool QwOpt4048::setQwake(bool enable)
     return true;
 }
 
-bool QwOpt4048::getQwake()
+template <class TBus> bool QwOpt4048Driver<TBus>::getQwake()
 {
     uint8_t buff[2];
     opt4048_reg_control_t controlReg;
@@ -230,7 +302,7 @@ bool QwOpt4048::getQwake()
     return true;
 }
 
-bool QwOpt4048::setOperationMode(opt4048_operation_mode_t mode)
+template <class TBus> bool QwOpt4048Driver<TBus>::setOperationMode(opt4048_operation_mode_t mode)
 {
     uint8_t buff[2];
     int32_t retVal;
@@ -257,7 +329,7 @@ bool QwOpt4048::setOperationMode(opt4048_operation_mode_t mode)
     return true;
 }
 
-opt4048_operation_mode_t QwOpt4048::getOperationMode()
+template <class TBus> opt4048_operation_mode_t QwOpt4048Driver<TBus>::getOperationMode()
 {
     uint8_t buff[2];
     opt4048_reg_control_t controlReg;
@@ -270,7 +342,7 @@ opt4048_operation_mode_t QwOpt4048::getOperationMode()
     return (opt4048_operation_mode_t)controlReg.op_mode;
 }
 
-bool QwOpt4048::setIntLatch(bool enable)
+template <class TBus> bool QwOpt4048Driver<TBus>::setIntLatch(bool enable)
 {
     uint8_t buff[2];
     int32_t retVal;
@@ -297,7 +369,7 @@ bool QwOpt4048::setIntLatch(bool enable)
     return true;
 }
 
-bool QwOpt4048::getIntLatch()
+template <class TBus> bool QwOpt4048Driver<TBus>::getIntLatch()
 {
     uint8_t buff[2];
     opt4048_reg_control_t controlReg;
@@ -313,7 +385,7 @@ bool QwOpt4048::getIntLatch()
     return false;
 }
 
-bool QwOpt4048::setIntActiveHigh(bool enable)
+template <class TBus> bool QwOpt4048Driver<TBus>::setIntActiveHigh(bool enable)
 {
     uint8_t buff[2];
     int32_t retVal;
@@ -340,7 +412,7 @@ bool QwOpt4048::setIntActiveHigh(bool enable)
     return true;
 }
 
-bool QwOpt4048::getIntActiveHigh()
+template <class TBus> bool QwOpt4048Driver<TBus>::getIntActiveHigh()
 {
     uint8_t buff[2];
     opt4048_reg_control_t intReg;
@@ -356,7 +428,7 @@ bool QwOpt4048::getIntActiveHigh()
     return true;
 }
 
-bool QwOpt4048::setIntInput(bool enable)
+template <class TBus> bool QwOpt4048Driver<TBus>::setIntInput(bool enable)
 {
     uint8_t buff[2];
     int32_t retVal;
@@ -370,7 +442,8 @@ bool QwOpt4048::setIntInput(bool enable)
     intReg.word = buff[0] << 8;
     intReg.word |= buff[1];
 
-    intReg.int_dir = (uint8_t)enable;
+    // INT_DIR is set for an output, which is the power-on state.
+    intReg.int_dir = !enable;
 
     buff[0] = intReg.word >> 8;
     buff[1] = intReg.word;
@@ -383,7 +456,7 @@ bool QwOpt4048::setIntInput(bool enable)
     return true;
 }
 
-bool QwOpt4048::getIntInputEnable()
+template <class TBus> bool QwOpt4048Driver<TBus>::getIntInputEnable()
 {
     uint8_t buff[2];
     opt4048_reg_int_control_t intReg;
@@ -393,13 +466,13 @@ bool QwOpt4048::getIntInputEnable()
     intReg.word = buff[0] << 8;
     intReg.word |= buff[1];
 
-    if (!intReg.int_dir)
+    if (intReg.int_dir)
         return false;
 
     return true;
 }
 
-bool QwOpt4048::setIntMechanism(opt4048_int_cfg_t mechanism)
+template <class TBus> bool QwOpt4048Driver<TBus>::setIntMechanism(opt4048_int_cfg_t mechanism)
 {
     uint8_t buff[2];
     int32_t retVal;
@@ -426,7 +499,7 @@ bool QwOpt4048::setIntMechanism(opt4048_int_cfg_t mechanism)
     return true;
 }
 
-opt4048_int_cfg_t QwOpt4048::getIntMechanism()
+template <class TBus> opt4048_int_cfg_t QwOpt4048Driver<TBus>::getIntMechanism()
 {
     uint8_t buff[2];
     opt4048_reg_int_control_t intReg;
@@ -439,7 +512,7 @@ opt4048_int_cfg_t QwOpt4048::getIntMechanism()
     return ((opt4048_int_cfg_t)intReg.int_cfg);
 }
 
-opt4048_reg_flags_t QwOpt4048::getAllFlags()
+template <class TBus> opt4048_reg_flags_t QwOpt4048Driver<TBus>::getAllFlags()
 {
     uint8_t buff[2];
     opt4048_reg_flags_t flagReg;
@@ -452,7 +525,7 @@ opt4048_reg_flags_t QwOpt4048::getAllFlags()
     return flagReg;
 }
 
-bool QwOpt4048::getOverloadFlag()
+template <class TBus> bool QwOpt4048Driver<TBus>::getOverloadFlag()
 {
     opt4048_reg_flags_t flagReg;
     flagReg = getAllFlags();
@@ -463,7 +536,7 @@ bool QwOpt4048::getOverloadFlag()
     return true;
 }
 
-bool QwOpt4048::getConvReadyFlag()
+template <class TBus> bool QwOpt4048Driver<TBus>::getConvReadyFlag()
 {
     opt4048_reg_flags_t flagReg;
     flagReg = getAllFlags();
@@ -474,7 +547,7 @@ bool QwOpt4048::getConvReadyFlag()
     return true;
 }
 
-bool QwOpt4048::getTooBrightFlag()
+template <class TBus> bool QwOpt4048Driver<TBus>::getTooBrightFlag()
 {
     opt4048_reg_flags_t flagReg;
     flagReg = getAllFlags();
@@ -485,7 +558,7 @@ bool QwOpt4048::getTooBrightFlag()
     return true;
 }
 
-bool QwOpt4048::getTooDimFlag()
+template <class TBus> bool QwOpt4048Driver<TBus>::getTooDimFlag()
 {
     opt4048_reg_flags_t flagReg;
     flagReg = getAllFlags();
@@ -496,7 +569,7 @@ bool QwOpt4048::getTooDimFlag()
     return true;
 }
 
-bool QwOpt4048::setFaultCount(opt4048_fault_count_t count)
+template <class TBus> bool QwOpt4048Driver<TBus>::setFaultCount(opt4048_fault_count_t count)
 {
     uint8_t buff[2];
     int32_t retVal;
@@ -523,7 +596,7 @@ bool QwOpt4048::setFaultCount(opt4048_fault_count_t count)
     return true;
 }
 
-opt4048_fault_count_t QwOpt4048::getFaultCount()
+template <class TBus> opt4048_fault_count_t QwOpt4048Driver<TBus>::getFaultCount()
 {
     uint8_t buff[2];
     opt4048_reg_control_t controlReg;
@@ -537,7 +610,7 @@ opt4048_fault_count_t QwOpt4048::getFaultCount()
     return ((opt4048_fault_count_t)controlReg.fault_count);
 }
 
-bool QwOpt4048::setThresholdChannel(opt4048_threshold_channel_t channel)
+template <class TBus> bool QwOpt4048Driver<TBus>::setThresholdChannel(opt4048_threshold_channel_t channel)
 {
     uint8_t buff[2];
     int32_t retVal;
@@ -564,7 +637,7 @@ bool QwOpt4048::setThresholdChannel(opt4048_threshold_channel_t channel)
     return true;
 }
 
-opt4048_threshold_channel_t QwOpt4048::getThresholdChannel()
+template <class TBus> opt4048_threshold_channel_t QwOpt4048Driver<TBus>::getThresholdChannel()
 {
     uint8_t buff[2];
     opt4048_reg_int_control_t intReg;
@@ -577,7 +650,7 @@ opt4048_threshold_channel_t QwOpt4048::getThresholdChannel()
     return ((opt4048_threshold_channel_t)intReg.threshold_ch_sel);
 }
 
-bool QwOpt4048::setThresholdHigh(float thresh)
+template <class TBus> bool QwOpt4048Driver<TBus>::setThresholdHigh(float thresh)
 {
     if (thresh < 2.15 || thresh > 144000)
         return false;
@@ -594,7 +667,7 @@ bool QwOpt4048::setThresholdHigh(float thresh)
     return true;
 }
 
-uint16_t QwOpt4048::getThresholdHigh()
+template <class TBus> uint16_t QwOpt4048Driver<TBus>::getThresholdHigh()
 {
     uint8_t buff[2];
     opt4048_reg_thresh_exp_res_high_t threshReg;
@@ -610,7 +683,7 @@ uint16_t QwOpt4048::getThresholdHigh()
     return thresholdHigh;
 }
 
-bool QwOpt4048::setThresholdLow(float thresh)
+template <class TBus> bool QwOpt4048Driver<TBus>::setThresholdLow(float thresh)
 {
     if (thresh < 2.15 || thresh > 144000)
         return false;
@@ -627,7 +700,7 @@ bool QwOpt4048::setThresholdLow(float thresh)
     return true;
 }
 
-uint16_t QwOpt4048::getThresholdLow()
+template <class TBus> uint16_t QwOpt4048Driver<TBus>::getThresholdLow()
 {
     uint8_t buff[2];
     opt4048_reg_thresh_exp_res_low_t threshReg;
@@ -643,7 +716,7 @@ uint16_t QwOpt4048::getThresholdLow()
     return thresholdLow;
 }
 
-bool QwOpt4048::setI2CBurst(bool enable)
+template <class TBus> bool QwOpt4048Driver<TBus>::setI2CBurst(bool enable)
 {
     uint8_t buff[2];
     int32_t retVal;
@@ -670,7 +743,7 @@ bool QwOpt4048::setI2CBurst(bool enable)
     return true;
 }
 
-bool QwOpt4048::getI2CBurst()
+template <class TBus> bool QwOpt4048Driver<TBus>::getI2CBurst()
 {
     uint8_t buff[2];
     opt4048_reg_int_control_t intReg;
@@ -686,7 +759,7 @@ bool QwOpt4048::getI2CBurst()
     return true;
 }
 
-void QwOpt4048::setCRC(bool enable)
+template <class TBus> void QwOpt4048Driver<TBus>::setCRC(bool enable)
 {
     if (enable)
         crcEnabled = true;
@@ -694,7 +767,7 @@ void QwOpt4048::setCRC(bool enable)
         crcEnabled = false;
 }
 
-uint32_t QwOpt4048::getADCCh0()
+template <class TBus> uint32_t QwOpt4048Driver<TBus>::getADCCh0()
 {
     uint8_t buff[4];
     uint32_t adcCode;
@@ -717,7 +790,7 @@ uint32_t QwOpt4048::getADCCh0()
     return adcCode;
 }
 
-uint32_t QwOpt4048::getADCCh1()
+template <class TBus> uint32_t QwOpt4048Driver<TBus>::getADCCh1()
 {
 
     uint8_t buff[4];
@@ -740,7 +813,7 @@ uint32_t QwOpt4048::getADCCh1()
     return adcCode;
 }
 
-uint32_t QwOpt4048::getADCCh2()
+template <class TBus> uint32_t QwOpt4048Driver<TBus>::getADCCh2()
 {
 
     uint8_t buff[4];
@@ -764,7 +837,7 @@ uint32_t QwOpt4048::getADCCh2()
     return adcCode;
 }
 
-uint32_t QwOpt4048::getADCCh3()
+template <class TBus> uint32_t QwOpt4048Driver<TBus>::getADCCh3()
 {
 
     uint8_t buff[4];
@@ -788,7 +861,7 @@ uint32_t QwOpt4048::getADCCh3()
     return adcCode;
 }
 
-sfe_color_t QwOpt4048::getAllADC()
+template <class TBus> sfe_color_t QwOpt4048Driver<TBus>::getAllADC()
 {
 
     sfe_color_t color;
@@ -801,88 +874,77 @@ sfe_color_t QwOpt4048::getAllADC()
     return color;
 }
 
-bool QwOpt4048::getAllChannelData(sfe_color_t *color)
+template <class TBus> bool QwOpt4048Driver<TBus>::getChannelData(uint8_t channel, uint32_t *adcCode, uint8_t *counter)
+{
+    int32_t retVal;
+    uint8_t buff[4];
+    uint32_t mantissa;
+    uint8_t exponent;
+    uint8_t crc;
+
+    if (channel > 3)
+        return false;
+
+    retVal = readRegisterRegion(SFE_OPT4048_REGISTER_EXP_RES_CH0 + (channel * 2), buff, 4);
+
+    if (retVal != 0)
+        return false;
+
+    opt4048DecodeChannel(buff, &mantissa, &exponent, counter, &crc);
+
+    *adcCode = applyDarkOffset(channel, mantissa, exponent);
+
+    return true;
+}
+
+template <class TBus> bool QwOpt4048Driver<TBus>::getAllChannelData(sfe_color_t *color)
 {
     int32_t retVal;
     uint8_t buff[16];
-    uint32_t mantissaCh0;
-    uint32_t mantissaCh1;
-    uint32_t mantissaCh2;
-    uint32_t mantissaCh3;
-    uint32_t adcCodeCh0;
-    uint32_t adcCodeCh1;
-    uint32_t adcCodeCh2;
-    uint32_t adcCodeCh3;
-
-    opt4048_reg_exp_res_ch0_t adc0MSB;
-    opt4048_reg_res_cnt_crc_ch0_t adc0LSB;
-    opt4048_reg_exp_res_ch1_t adc1MSB;
-    opt4048_reg_res_cnt_crc_ch1_t adc1LSB;
-    opt4048_reg_exp_res_ch2_t adc2MSB;
-    opt4048_reg_res_cnt_crc_ch2_t adc2LSB;
-    opt4048_reg_exp_res_ch3_t adc3MSB;
-    opt4048_reg_res_cnt_crc_ch3_t adc3LSB;
 
     retVal = readRegisterRegion(SFE_OPT4048_REGISTER_EXP_RES_CH0, buff, 16);
 
     if (retVal != 0)
         return false;
 
-    adc0MSB.word = buff[0] << 8;
-    adc0MSB.word |= buff[1];
-    adc0LSB.word = buff[2] << 8;
-    adc0LSB.word |= buff[3];
-
-    adc1MSB.word = buff[4] << 8;
-    adc1MSB.word |= buff[5];
-    adc1LSB.word = buff[6] << 8;
-    adc1LSB.word |= buff[7];
+    decodeImage(buff, color);
 
-    adc2MSB.word = buff[8] << 8;
-    adc2MSB.word |= buff[9];
-    adc2LSB.word = buff[10] << 8;
-    adc2LSB.word |= buff[11];
+    return true;
+}
 
-    adc3MSB.word = buff[12] << 8;
-    adc3MSB.word |= buff[13];
-    adc3LSB.word = buff[14] << 8;
-    adc3LSB.word |= buff[15];
+template <class TBus> bool QwOpt4048Driver<TBus>::getTimedChannelData(sfe_opt4048_timed_sample_t *sample)
+{
+    uint8_t buff[16];
+    uint32_t start;
 
-    mantissaCh0 = (uint32_t)adc0MSB.result_msb_ch0 << 8;
-    mantissaCh0 |= adc0LSB.result_lsb_ch0;
-    adcCodeCh0 = mantissaCh0 << adc0MSB.exponent_ch0;
+    start = micros();
 
-    mantissaCh1 = (uint32_t)adc1MSB.result_msb_ch1 << 8;
-    mantissaCh1 |= adc1LSB.result_lsb_ch1;
-    adcCodeCh1 = mantissaCh1 << adc1MSB.exponent_ch1;
+    if (readRegisterRegion(SFE_OPT4048_REGISTER_EXP_RES_CH0, buff, 16) != 0)
+        return false;
 
-    mantissaCh2 = (uint32_t)adc2MSB.result_msb_ch2 << 8;
-    mantissaCh2 |= adc2LSB.result_lsb_ch2;
-    adcCodeCh2 = mantissaCh2 << adc2MSB.exponent_ch2;
+    sample->readMicros = start + (micros() - start) / 2;
+    sample->conversionTimeUs = getConversionTimeUs();
 
-    mantissaCh3 = (uint32_t)adc3MSB.result_msb_ch3 << 8;
-    mantissaCh3 |= adc3LSB.result_lsb_ch3;
-    adcCodeCh3 = mantissaCh3 << adc3MSB.exponent_ch3;
+    decodeImage(buff, &sample->color);
 
-    color->red = adcCodeCh0;
-    color->green = adcCodeCh1;
-    color->blue = adcCodeCh2;
-    color->white = adcCodeCh3;
+    if (_timingState == kTimingContinuous)
+    {
+        opt4048EstimateMidpoints(sample, true);
+        return true;
+    }
 
-    color->counterR = adc0LSB.counter_ch0;
-    color->counterG = adc1LSB.counter_ch1;
-    color->counterR = adc2LSB.counter_ch2;
-    color->counterR = adc3LSB.counter_ch3;
+    // One-shot: the set completed at the predicted time, unless it is read early.
+    uint32_t readMicros = sample->readMicros;
+    if ((int32_t)(readMicros - _sampleDueMicros) > 0)
+        sample->readMicros = _sampleDueMicros;
 
-    color->CRCR = adc0LSB.crc_ch0;
-    color->CRCG = adc1LSB.crc_ch1;
-    color->CRCB = adc2LSB.crc_ch2;
-    color->CRCW = adc3LSB.crc_ch3;
+    opt4048EstimateMidpoints(sample, false);
+    sample->readMicros = readMicros;
 
     return true;
 }
 
-bool QwOpt4048::calculateCRC(uint32_t mantissa, uint8_t expon, uint8_t crc)
+template <class TBus> bool QwOpt4048Driver<TBus>::calculateCRC(uint32_t mantissa, uint8_t expon, uint8_t crc)
 {
 
     if (!crcEnabled)
@@ -914,84 +976,292 @@ bool QwOpt4048::calculateCRC(uint32_t mantissa, uint8_t expon, uint8_t crc)
     return false;
 }
 
-uint32_t QwOpt4048::getLux()
+template <class TBus> uint32_t QwOpt4048Driver<TBus>::getLux()
 {
     uint32_t adcCh1;
-    uint32_t lux;
+    uint8_t counter;
 
-    adcCh1 = getADCCh1();
-    lux = adcCh1 * cieMatrix[1][3];
+    // Through getChannelData() so a dark table applies, like in the CIE functions.
+    if (!getChannelData(1, &adcCh1, &counter))
+        return 0;
 
-    return lux;
+    return opt4048CalculateLux(adcCh1);
 }
 
-double QwOpt4048::getCIEx()
+template <class TBus> double QwOpt4048Driver<TBus>::getCIEx()
 {
-    double x = 0;
-    double y = 0;
-    double z = 0;
-    double CIEx;
-    static sfe_color_t color;
+    sfe_color_t color;
+    sfe_cie_t cie;
 
     getAllChannelData(&color);
+    calculateCIE(&color, &cie);
 
-    x += color.red * cieMatrix[0][0];
-    x += color.green * cieMatrix[1][0];
-    x += color.blue * cieMatrix[2][0];
-
-    y += color.red * cieMatrix[0][1];
-    y += color.green * cieMatrix[1][1];
-    y += color.blue * cieMatrix[2][1];
+    return cie.CIEx;
+}
 
-    z += color.red * cieMatrix[0][2];
-    z += color.green * cieMatrix[1][2];
-    z += color.blue * cieMatrix[2][2];
+template <class TBus> double QwOpt4048Driver<TBus>::getCIEy()
+{
+    sfe_color_t color;
+    sfe_cie_t cie;
 
-    CIEx = x / (x + y + z);
+    getAllChannelData(&color);
+    calculateCIE(&color, &cie);
 
-    return CIEx;
+    return cie.CIEy;
 }
 
-double QwOpt4048::getCIEy()
+template <class TBus> double QwOpt4048Driver<TBus>::getCCT()
 {
-    double x = 0;
-    double y = 0;
-    double z = 0;
-    double CIEy;
     sfe_color_t color;
+    sfe_cie_t cie;
 
+    // One read so that x and y come from the same sample.
     getAllChannelData(&color);
+    calculateCIE(&color, &cie);
 
-    x += color.red * cieMatrix[0][0];
-    x += color.green * cieMatrix[1][0];
-    x += color.blue * cieMatrix[2][0];
+    return cie.CCT;
+}
 
-    y += color.red * cieMatrix[0][1];
-    y += color.green * cieMatrix[1][1];
-    y += color.blue * cieMatrix[2][1];
+template <class TBus> void QwOpt4048Driver<TBus>::setDarkTable(QwOpt4048DarkTable *table)
+{
+    _darkTable = table;
+}
 
-    z += color.red * cieMatrix[0][2];
-    z += color.green * cieMatrix[1][2];
-    z += color.blue * cieMatrix[2][2];
+template <class TBus> QwOpt4048DarkTable *QwOpt4048Driver<TBus>::getDarkTable()
+{
+    return _darkTable;
+}
+
+template <class TBus> void QwOpt4048Driver<TBus>::decodeImage(const uint8_t *image, sfe_color_t *color)
+{
+    uint32_t *channels[4] = {&color->red, &color->green, &color->blue, &color->white};
+    opt4048_reg_control_t controlReg;
+    uint16_t offset;
 
-    CIEy = y / (x + y + z);
+    opt4048DecodeImage(image, color);
 
-    return CIEy;
+    if (_darkTable == nullptr)
+        return;
+
+    controlReg.word = _control;
+
+    // The exponent is the range the channel converted in, which differs between channels in auto range.
+    for (uint8_t channel = 0; channel < 4; channel++)
+    {
+        offset = _darkTable->getOffset(channel, image[channel * 4] >> 4, controlReg.conversion_time);
+
+        *channels[channel] = *channels[channel] > offset ? *channels[channel] - offset : 0;
+    }
 }
 
-double QwOpt4048::getCCT()
+template <class TBus>
+uint32_t QwOpt4048Driver<TBus>::applyDarkOffset(uint8_t channel, uint32_t mantissa, uint8_t exponent)
 {
-    double CIEx;
-    double CIEy;
-    double CCT;
+    uint32_t adcCode = mantissa << exponent;
+    opt4048_reg_control_t controlReg;
+    uint16_t offset;
+
+    if (_darkTable == nullptr)
+        return adcCode;
 
-    CIEx = getCIEx();
-    CIEy = getCIEy();
+    controlReg.word = _control;
+    offset = _darkTable->getOffset(channel, exponent, controlReg.conversion_time);
 
-    double n = (CIEx - 0.3320) / (0.1858 - CIEy);
+    return adcCode > offset ? adcCode - offset : 0;
+}
 
-    // Formula can be found under the CCT section in the datasheet.
-    CCT = 437 * pow(n, 3) + 3601 * pow(n, 2) + 6861 * n + 5517;
+template <class TBus> void QwOpt4048Driver<TBus>::calculateCIE(const sfe_color_t *color, sfe_cie_t *cie)
+{
+    opt4048CalculateCIE(color, cie);
+}
 
-    return CCT;
+template <class TBus> double QwOpt4048Driver<TBus>::calculateCCT(double CIEx, double CIEy)
+{
+    return opt4048CalculateCCT(CIEx, CIEy);
 }
+
+// Offset of CONTROL and INT_CONTROL inside a configuration image.
+#define kConfigControl ((SFE_OPT4048_REGISTER_CONTROL - SFE_OPT4048_REGISTER_THRESH_L_EXP_RES) * 2)
+
+template <class TBus> bool QwOpt4048Driver<TBus>::saveConfiguration(sfe_opt4048_config_t *config)
+{
+    if (readRegisterRegion(SFE_OPT4048_REGISTER_THRESH_L_EXP_RES, config->regs, sizeof(config->regs)) != 0)
+        return false;
+
+    config->magic = OPT4048_CONFIG_MAGIC;
+    config->reserved = 0;
+    config->checksum = opt4048LogChecksum((const uint8_t *)config, offsetof(sfe_opt4048_config_t, checksum));
+
+    return true;
+}
+
+template <class TBus> bool QwOpt4048Driver<TBus>::restoreConfiguration(const sfe_opt4048_config_t *config)
+{
+    uint8_t buff[sizeof(config->regs)];
+
+    if (config->magic != OPT4048_CONFIG_MAGIC ||
+        config->checksum != opt4048LogChecksum((const uint8_t *)config, offsetof(sfe_opt4048_config_t, checksum)))
+        return false;
+
+    memcpy(buff, config->regs, sizeof(buff));
+
+    return writeRegisterRegion(SFE_OPT4048_REGISTER_THRESH_L_EXP_RES, buff, sizeof(buff)) == 0;
+}
+
+template <class TBus> bool QwOpt4048Driver<TBus>::wasReset(const sfe_opt4048_config_t *config)
+{
+    uint8_t buff[4];
+    uint16_t control;
+    uint16_t intControl;
+
+    if (readRegisterRegion(SFE_OPT4048_REGISTER_CONTROL, buff, 4) != 0)
+        return false;
+
+    control = (buff[0] << 8) | buff[1];
+    intControl = (buff[2] << 8) | buff[3];
+
+    if (control != OPT4048_CONTROL_DEFAULT || intControl != OPT4048_INT_CONTROL_DEFAULT)
+        return false;
+
+    return memcmp(buff, &config->regs[kConfigControl], 4) != 0;
+}
+
+template <class TBus> void QwOpt4048Driver<TBus>::updateControlShadow(const uint8_t *reg, bool written)
+{
+    opt4048_reg_control_t controlReg;
+
+    controlReg.word = reg[0] << 8;
+    controlReg.word |= reg[1];
+
+    _control = controlReg.word;
+
+    if (written)
+    {
+        if (controlReg.op_mode == OPERATION_MODE_POWER_DOWN)
+        {
+            _timingState = kTimingIdle;
+            return;
+        }
+
+        // Writing CONTROL in an active mode starts a new set of conversions.
+        _sampleDueMicros = micros() + getSamplePeriodUs();
+        _timingState = controlReg.op_mode == OPERATION_MODE_CONTINUOUS ? kTimingContinuous : kTimingOneShot;
+    }
+    else if (controlReg.op_mode == OPERATION_MODE_CONTINUOUS && _timingState != kTimingContinuous)
+    {
+        // Already running with an unknown phase, assume a full period.
+        _sampleDueMicros = micros() + getSamplePeriodUs();
+        _timingState = kTimingContinuous;
+    }
+}
+
+template <class TBus> uint16_t QwOpt4048Driver<TBus>::getControlShadow()
+{
+    return _control;
+}
+
+template <class TBus> uint32_t QwOpt4048Driver<TBus>::getConversionTimeUs()
+{
+    opt4048_reg_control_t controlReg;
+
+    controlReg.word = _control;
+
+    return opt4048ConversionTimeUs((opt4048_conversion_time_t)controlReg.conversion_time);
+}
+
+template <class TBus> uint32_t QwOpt4048Driver<TBus>::getSamplePeriodUs()
+{
+    return getConversionTimeUs() * 4;
+}
+
+template <class TBus> uint32_t QwOpt4048Driver<TBus>::getSampleDueMicros()
+{
+    return _sampleDueMicros;
+}
+
+static void sleepMicros(uint32_t us)
+{
+    if (us >= 1000)
+        delay(us / 1000);
+
+    delayMicroseconds(us % 1000);
+}
+
+template <class TBus> bool QwOpt4048Driver<TBus>::getSampleWait(uint32_t *waitUs)
+{
+    int32_t remaining;
+
+    if (_timingState == kTimingIdle)
+        return false;
+
+    // The internal oscillator may run a few percent slow, so wait 1/32 of a period past the nominal time.
+    remaining = (int32_t)(_sampleDueMicros + (getSamplePeriodUs() >> 5) - micros());
+
+    *waitUs = remaining > 0 ? remaining : 0;
+
+    return true;
+}
+
+template <class TBus> bool QwOpt4048Driver<TBus>::pollSample()
+{
+    uint32_t wait;
+
+    if (!getSampleWait(&wait) || wait > 0)
+        return false;
+
+    return confirmSample();
+}
+
+template <class TBus> bool QwOpt4048Driver<TBus>::waitForSample(uint32_t timeoutMs)
+{
+    uint32_t wait;
+
+    if (!getSampleWait(&wait))
+        return false;
+
+    if (wait > 0)
+    {
+        if (wait / 1000 >= timeoutMs)
+        {
+            sleepMicros(timeoutMs * 1000);
+            return false;
+        }
+
+        sleepMicros(wait);
+    }
+
+    return confirmSample();
+}
+
+template <class TBus> bool QwOpt4048Driver<TBus>::confirmSample()
+{
+    uint32_t period;
+    uint32_t now;
+
+    period = getSamplePeriodUs();
+
+    if (!getConvReadyFlag())
+    {
+        // Running late: back off so a retry doesn't turn into flag polling.
+        _sampleDueMicros = micros() + (period >> 4);
+        return false;
+    }
+
+    if (_timingState == kTimingOneShot)
+    {
+        _timingState = kTimingIdle;
+        return true;
+    }
+
+    // Continuous mode: step to the next completion, skipping any that were missed.
+    _sampleDueMicros += period;
+    now = micros();
+    if ((int32_t)(now - _sampleDueMicros) >= 0)
+        _sampleDueMicros += period * ((now - _sampleDueMicros) / period + 1);
+
+    return true;
+}
+
+// The bus bindings the driver is built for. A driver on another bus type needs its own instantiation.
+template class QwOpt4048Driver<sfe_OPT4048::QwDeviceBus>;
+template class QwOpt4048Driver<sfe_OPT4048::QwI2CDirect>;
@@ -39,26 +39,9 @@ data types for the color data.
 #pragma once
 #include "OPT4048_Registers.h"
 #include "sfe_bus.h"
+#include "sfe_opt4048_decode.h"
 #include <Wire.h>
 
-/// @brief Struct used to store the color data from the OPT4048.
-typedef struct
-{
-    uint32_t red;
-    uint32_t green;
-    uint32_t blue;
-    uint32_t white;
-    uint8_t counterR; // Sample counter
-    uint8_t counterG;
-    uint8_t counterB;
-    uint8_t counterW;
-    uint8_t CRCR;
-    uint8_t CRCG;
-    uint8_t CRCB;
-    uint8_t CRCW;
-
-} sfe_color_t;
-
 /// @brief  Union used to re-calculate the CRC for optional double check.
 typedef union {
     struct
@@ -111,15 +94,60 @@ typedef union {
     uint32_t word;
 } mantissaBits;
 
-class QwOpt4048
+/// @brief Marks a valid sfe_opt4048_config_t, so erased non-volatile memory is never restored.
+#define OPT4048_CONFIG_MAGIC 0xC4
+
+/// @brief Image of the writable register block: thresholds (0x08 - 0x09), CONTROL (0x0A), and
+///        INT_CONTROL (0x0B), kept in bus byte order so it can be written back in one burst. Plain data,
+///        so it can be stored as is in EEPROM or flash.
+typedef struct
+{
+    uint8_t magic;       // OPT4048_CONFIG_MAGIC
+    uint8_t reserved;
+    uint8_t regs[8];     // Registers 0x08 - 0x0B as read from the bus
+    uint16_t checksum;   // Fletcher-16 of the preceding 10 bytes
+
+} sfe_opt4048_config_t;
+
+/// @brief Per-instance RAM budget of QwOpt4048: the pointers and bytes of state the class may hold,
+///        rounded up to pointer alignment. That is 13 bytes on AVR and 20 bytes on 32 bit targets. Constant
+///        tables live in flash (see sfe_opt4048_progmem.h), never in the object. The budget is checked at
+///        compile time in sfe_opt4048.cpp; adding state to the class means raising it on purpose.
+#define OPT4048_INSTANCE_RAM_POINTERS 2
+#define OPT4048_INSTANCE_RAM_BYTES 9
+#define OPT4048_INSTANCE_RAM_BUDGET                                                                        \
+    ((OPT4048_INSTANCE_RAM_POINTERS * sizeof(void *) + OPT4048_INSTANCE_RAM_BYTES + alignof(void *) - 1) & \
+     ~(alignof(void *) - 1))
+
+class QwOpt4048DarkTable;
+
+/// @brief The OPT4048 driver, bound to the bus type TBus. QwOpt4048 binds it to the virtual QwDeviceBus
+///        interface, for buses chosen at run time and the layers stacked on them. QwOpt4048Direct binds it
+///        to QwI2CDirect, whose transfers are defined inline, so register accesses resolve at compile
+///        time and can be inlined, and no vtable is needed. The members are defined in sfe_opt4048.cpp
+///        and instantiated there for these two bus types.
+template <class TBus> class QwOpt4048Driver
 {
   public:
-    QwOpt4048() : _sfeBus(nullptr), _i2cAddress(0) {};
+    QwOpt4048Driver()
+        : _sfeBus(nullptr), _darkTable(nullptr), _sampleDueMicros(0), _control(OPT4048_CONTROL_DEFAULT),
+          _i2cAddress(0), _timingState(kTimingIdle) {};
 
     /// @brief Sets the struct that interfaces with STMicroelectronic's C Library.
     /// @return true on successful execution.
     bool init();
 
+    /// @brief Brings the device to its first conversion in the fewest transactions: CONTROL and
+    ///        INT_CONTROL are written in one burst, and with verification off that is the only
+    ///        transaction. Intended for known-good hardware that restarts often, e.g. after deep sleep.
+    /// @param control CONTROL register image, e.g. QwOpt4048Static<...>::kControl.
+    /// @param intControl INT_CONTROL register image, e.g. QwOpt4048Static<...>::kIntControl.
+    /// @param readyAtMicros Optional pointer to store the predicted completion time of the first sample
+    ///        in micros(); pass it to waitForSample() or compare against micros().
+    /// @param verify Pings the device and checks its ID first, two more transactions.
+    /// @return True on successful execution.
+    bool fastStart(uint16_t control, uint16_t intControl, uint32_t *readyAtMicros = nullptr, bool verify = false);
+
     /// @brief Checks that the bus is connected with the OPT4048 by checking
     /// it's unique ID.
     /// @return True on successful execution.
@@ -132,11 +160,19 @@ class QwOpt4048
     /// @brief Sets the pointer to the data bus for read and writes.
     /// @param theBus This parameter sets the the I2C hardware bus.
     /// @param i2cAddress The I2C address for the device.
-    void setCommunicationBus(sfe_OPT4048::QwDeviceBus &theBus, uint8_t i2cAddress);
+    void setCommunicationBus(TBus &theBus, uint8_t i2cAddress);
 
     /// @brief Sets the pointer to the data bus for read and writes.
     /// @param theBus This parameter sets the hardware bus.
-    void setCommunicationBus(sfe_OPT4048::QwDeviceBus &theBus);
+    void setCommunicationBus(TBus &theBus);
+
+    /// @brief Retrieves the data bus set with setCommunicationBus(), e.g. to insert a layer in front of it.
+    /// @return The bus, or nullptr if none is set.
+    TBus *getCommunicationBus();
+
+    /// @brief Retrieves the I2C address used to talk to the device.
+    /// @return The I2C address.
+    uint8_t getI2CAddress();
 
     /// @brief Writes to the data to the given register using the hardware data bus.
     /// @param  offset The register to write to.
@@ -152,6 +188,12 @@ class QwOpt4048
     /// @return The successful (0) or unsuccessful (-1) read of the given register.
     int32_t readRegisterRegion(uint8_t offset, uint8_t *data, uint16_t numBytes = 2);
 
+    /// @brief Queries the SMBus Alert Response Address on this sensor's bus. The answer comes from
+    ///        whichever device on the bus asserts ALERT, which need not be this sensor.
+    /// @param address Pointer to store the 7 bit address of the answering device.
+    /// @return The successful (0) or unsuccessful (-1) query; -1 also means no device asserts ALERT.
+    int32_t readAlertResponse(uint8_t *address);
+
     ///////////////////////////////////////////////////////////////////Device Settings
 
     /// @brief Sets the minimum of settings to get the board running.
@@ -289,7 +331,8 @@ class QwOpt4048
 
     ///////////////////////////////////////////////////////////////////Interrupt Settings
     /// @brief Changes the behavior of the interrupt pin to be an INPUT to trigger single shot.
-    /// @param set True to enable, false to disable.
+    /// @param set True for an input, false for the power-on output that signals conversions and
+    ///        thresholds.
     /// @return True on successful execution.
     bool setIntInput(bool enable = true);
 
@@ -336,6 +379,9 @@ class QwOpt4048
     bool getTooDimFlag();
 
     ///////////////////////////////////////////////////////////////////Color Information
+    // The getADCChN() functions return raw codes; a dark table applies through getChannelData() and
+    // getAllChannelData().
+
     /// @brief Reads Channel Zero (Red)
     /// @return Returns the ADC value of Channel Zero
     uint32_t getADCCh0();
@@ -356,6 +402,13 @@ class QwOpt4048
     /// @return Returns the ADC values of the channels.
     sfe_color_t getAllADC();
 
+    /// @brief Reads a single channel together with its sample counter in one 4 byte transaction.
+    /// @param channel The channel to read: 0 (Red), 1 (Green), 2 (Blue), or 3 (White).
+    /// @param adcCode Pointer to store the ADC value of the channel.
+    /// @param counter Pointer to store the sample counter of the channel.
+    /// @return Returns true on successful execution, false otherwise.
+    bool getChannelData(uint8_t channel, uint32_t *adcCode, uint8_t *counter);
+
     /// @brief Retrieves all ADC values for all channels: Red, Green, Blue, and White, as well as the sample counter,
     /// and
     ///        the CRC value.
@@ -363,6 +416,36 @@ class QwOpt4048
     /// @return Returns true on successful execution, false otherwise.
     bool getAllChannelData(sfe_color_t *color);
 
+    /// @brief Retrieves all channels like getAllChannelData() and timestamps the sample. The conversion
+    ///        midpoint of every channel is estimated from the read time, the conversion time, and the
+    ///        counter fields, without extra bus reads; see opt4048EstimateMidpoints().
+    /// @param sample Pointer to the struct to be populated.
+    /// @return Returns true on successful execution, false otherwise.
+    bool getTimedChannelData(sfe_opt4048_timed_sample_t *sample);
+
+    /// @brief Sets a dark-offset table that is subtracted from every sample read through getChannelData(),
+    ///        getAllChannelData(), getTimedChannelData(), and the optional components. The raw getADCChN()
+    ///        and getAllADC() reads are not corrected.
+    /// @param table The table, or nullptr to read uncorrected samples. It must outlive the sensor's use.
+    void setDarkTable(QwOpt4048DarkTable *table);
+
+    /// @brief Retrieves the dark-offset table.
+    /// @return The table, or nullptr if none is set.
+    QwOpt4048DarkTable *getDarkTable();
+
+    /// @brief Decodes a register image of channel data read from this sensor, like opt4048DecodeImage(),
+    ///        and subtracts the dark offsets of the channels' ranges and the current conversion time.
+    /// @param image The register bytes of 0x00 to 0x07 as read from the bus.
+    /// @param color Pointer to the color struct to be populated.
+    void decodeImage(const uint8_t *image, sfe_color_t *color);
+
+    /// @brief Calculates the ADC code of one channel and subtracts its dark offset.
+    /// @param channel The channel, 0 to 3.
+    /// @param mantissa The 20 bit mantissa.
+    /// @param exponent The 4 bit exponent, which is also the range of the conversion.
+    /// @return The corrected ADC code, clamped at zero.
+    uint32_t applyDarkOffset(uint8_t channel, uint32_t mantissa, uint8_t exponent);
+
     /// @brief  Calculates the CRC for the OPT4048. Note that the OPT4048 does this already
     ///         but this is a way to double check the value.
     /// @param mantissa The mantissa value of the ADC
@@ -371,8 +454,8 @@ class QwOpt4048
     /// @return Returns the calculated CRC value.
     bool calculateCRC(uint32_t manitssa, uint8_t expon, uint8_t crc);
 
-    /// @brief Retrieves the Lux value.
-    /// @return Returns the Lux value of the sensor
+    /// @brief Retrieves the Lux value, corrected by the dark table if one is set.
+    /// @return Returns the Lux value of the sensor, 0 on a bus error
     uint32_t getLux();
 
     /// @brief  Retrieves the CIE X value of the sensor.
@@ -387,16 +470,103 @@ class QwOpt4048
     /// @return Returns the CCT of the sensor in Kelvin
     double getCCT();
 
+    /// @brief Calculates CIE x, CIE y, lux, and CCT from a sample that has already been read, e.g. one
+    ///        that was passed through a QwOpt4048FilterPipeline. No bus access takes place.
+    /// @param color Pointer to the sample to convert.
+    /// @param cie Pointer to the struct to be populated with the calculated values.
+    void calculateCIE(const sfe_color_t *color, sfe_cie_t *cie);
+
+    /// @brief Calculates the Correlated Color Temperature (CCT) from CIE x and y values.
+    /// @param CIEx The CIE x value.
+    /// @param CIEy The CIE y value.
+    /// @return Returns the CCT in Kelvin
+    double calculateCCT(double CIEx, double CIEy);
+
+    ///////////////////////////////////////////////////////////////////Configuration Snapshot
+
+    /// @brief Captures thresholds, CONTROL, and INT_CONTROL with one 8 byte read.
+    /// @param config Pointer to the image to populate.
+    /// @return True on successful execution.
+    bool saveConfiguration(sfe_opt4048_config_t *config);
+
+    /// @brief Writes a captured image back with one 8 byte burst.
+    /// @param config The image from saveConfiguration(), e.g. loaded from EEPROM.
+    /// @return True on success, false if the image is not valid or on a bus error.
+    bool restoreConfiguration(const sfe_opt4048_config_t *config);
+
+    /// @brief Checks for a reset since the image was captured, e.g. after a brown-out: CONTROL and
+    ///        INT_CONTROL are back at their power-on values but the image holds other values. One 4
+    ///        byte read.
+    /// @param config The captured image.
+    /// @return True if the device was reset, false if not or on a bus error.
+    bool wasReset(const sfe_opt4048_config_t *config);
+
+    ///////////////////////////////////////////////////////////////////Conversion Timing
+
+    /// @brief Retrieves the last CONTROL value written to or read from the device, e.g. to record or restore
+    ///        the configuration. No bus access takes place.
+    /// @return The CONTROL register value.
+    uint16_t getControlShadow();
+
+    /// @brief Retrieves the conversion time of a single channel for the current setting. Uses the
+    ///        last CONTROL value written or read, no bus access takes place.
+    /// @return The conversion time in microseconds.
+    uint32_t getConversionTimeUs();
+
+    /// @brief Retrieves the time for a full sample of all four channels, which are converted in turn.
+    /// @return The sample period in microseconds.
+    uint32_t getSamplePeriodUs();
+
+    /// @brief Retrieves the predicted completion time of the next sample. Writing CONTROL with an active
+    ///        operation mode, e.g. through setOperationMode(), starts the prediction.
+    /// @return The predicted completion time in micros().
+    uint32_t getSampleDueMicros();
+
+    /// @brief Sleeps until the next sample is predicted to complete and confirms it with one read of the
+    ///        conversion ready flag. Replaces fixed delays and flag polling.
+    /// @param timeoutMs Maximum time to wait in milliseconds.
+    /// @return True if a new sample is ready, false on timeout, when the device is powered down, or if
+    ///         the flag was not set yet; in that case the next call waits a little longer.
+    bool waitForSample(uint32_t timeoutMs = 1000);
+
+    /// @brief Retrieves how long waitForSample() would sleep before it reads the conversion ready flag.
+    ///        For event loops that wait on their own and then call pollSample().
+    /// @param waitUs Pointer to store the time in microseconds, 0 if the sample is due.
+    /// @return False if no conversion is running, e.g. after power down or a completed one-shot.
+    bool getSampleWait(uint32_t *waitUs);
+
+    /// @brief The non-blocking half of waitForSample(): confirms a due sample with one read of the
+    ///        conversion ready flag. Before the sample is due there is no bus access.
+    /// @return True if a new sample is ready. False if it is not due yet, no conversion is running, or
+    ///         the flag was not set yet; in that case the sample is due again a little later.
+    bool pollSample();
+
   private:
-    sfe_OPT4048::QwDeviceBus *_sfeBus;
+    // Reads the conversion ready flag for a due sample and predicts the next one.
+    bool confirmSample();
+
+    // Keeps the CONTROL shadow and the sample prediction in step with a CONTROL value that was just
+    // written to or read from the device.
+    void updateControlShadow(const uint8_t *reg, bool written);
+
+    enum
+    {
+        kTimingIdle = 0,
+        kTimingOneShot,
+        kTimingContinuous
+    };
+
+    TBus *_sfeBus;
+    QwOpt4048DarkTable *_darkTable;
+    uint32_t _sampleDueMicros;
+    uint16_t _control;
     uint8_t _i2cAddress;
+    uint8_t _timingState;
     bool crcEnabled = false;
-
-    static constexpr uint8_t kOPTMatrixRows = 4;
-    static constexpr uint8_t kOPTMatrixCols = 4;
-    // Table in 9.2.4 of Datasheet for calculating CIE x and y, and Lux.
-    const double cieMatrix[kOPTMatrixRows][kOPTMatrixCols] = {{.000234892992, -.0000189652390, .0000120811684, 0},
-                                                              {.0000407467441, .000198958202, -.0000158848115, .00215},
-                                                              {.0000928619404, -.0000169739553, .000674021520, 0},
-                                                              {0, 0, 0, 0}};
 };
+
+/// @brief The driver on the virtual bus interface, used by the rest of the library.
+typedef QwOpt4048Driver<sfe_OPT4048::QwDeviceBus> QwOpt4048;
+
+/// @brief The driver bound to the I2C bus at compile time.
+typedef QwOpt4048Driver<sfe_OPT4048::QwI2CDirect> QwOpt4048Direct;
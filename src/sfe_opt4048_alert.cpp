@@ -0,0 +1,177 @@
+/*
+sfe_opt4048_alert.cpp
+
+SparkFun Tristimulus Color Sensor - OPT4048
+
+Qwiic 1x1
+* https://www.sparkfun.com/products/
+Qwiic Mini
+* https://www.sparkfun.com/products/
+
+Repository:
+* https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+The MIT License (MIT)
+
+Copyright (c) 2022 SparkFun Electronics
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions: The
+above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED
+"AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+License(http://opensource.org/licenses/MIT).
+
+The following functions implement the SMBus alert group declared in
+sfe_opt4048_alert.h.
+
+*/
+#include "sfe_opt4048_alert.h"
+
+bool QwOpt4048AlertGroup::addSensor(QwOpt4048Events &events)
+{
+    QwOpt4048 *sensor = events.getSensor();
+
+    if (_numSensors >= kMaxSensors || sensor == nullptr)
+        return false;
+
+    uint8_t address = sensor->getI2CAddress();
+
+    for (uint8_t i = 0; i < _numSensors; i++)
+    {
+        if (_addresses[i] == address)
+            return false;
+    }
+
+    _events[_numSensors] = &events;
+    _addresses[_numSensors] = address;
+    _numSensors++;
+
+    return true;
+}
+
+bool QwOpt4048AlertGroup::begin()
+{
+    bool success = true;
+
+    _hasAlertPin = false;
+    _pending = false;
+    _alertsServiced = 0;
+    _unknownAlerts = 0;
+
+    for (uint8_t i = 0; i < _numSensors; i++)
+    {
+        QwOpt4048 *sensor = _events[i]->getSensor();
+
+        success &= sensor->setIntInput(false);
+        success &= sensor->setIntActiveHigh(false);
+        success &= sensor->setIntLatch(true);
+        success &= sensor->setIntMechanism(INT_SMBUS_ALERT);
+
+        // A pin left as an input never pulls ALERT low, so the group would never find the device.
+        uint8_t buff[2];
+        opt4048_reg_int_control_t intReg;
+
+        if (sensor->readRegisterRegion(SFE_OPT4048_REGISTER_INT_CONTROL, buff) != 0)
+        {
+            success = false;
+            continue;
+        }
+
+        intReg.word = buff[0] << 8;
+        intReg.word |= buff[1];
+
+        success &= intReg.int_dir == 1 && intReg.int_cfg == INT_SMBUS_ALERT;
+    }
+
+    return success;
+}
+
+bool QwOpt4048AlertGroup::begin(uint8_t alertPin)
+{
+    bool success = begin();
+
+    _alertPin = alertPin;
+    _hasAlertPin = true;
+
+    return success;
+}
+
+void QwOpt4048AlertGroup::notify()
+{
+    _pending = true;
+}
+
+uint8_t QwOpt4048AlertGroup::service()
+{
+    if (!_pending)
+        return 0;
+
+    _pending = false;
+
+    return serviceAlert();
+}
+
+uint8_t QwOpt4048AlertGroup::serviceAlert()
+{
+    uint8_t address;
+    uint8_t serviced = 0;
+
+    if (_numSensors == 0)
+        return 0;
+
+    // Every sensor shares the bus, so any of them can query the Alert Response Address. Each answer
+    // releases one sensor, so there are at most as many rounds as sensors (plus one unknown device).
+    for (uint8_t round = 0; round <= _numSensors; round++)
+    {
+        if (_hasAlertPin && digitalRead(_alertPin) != LOW)
+            break;
+
+        if (_events[0]->getSensor()->readAlertResponse(&address) != 0)
+            break;
+
+        uint8_t i = 0;
+
+        while (i < _numSensors && _addresses[i] != address)
+            i++;
+
+        if (i == _numSensors)
+        {
+            _unknownAlerts++;
+            continue;
+        }
+
+        // Reading FLAGS in the burst clears the latched flags of the sensor.
+        if (_events[i]->serviceInterrupt())
+        {
+            _alertsServiced++;
+            serviced++;
+        }
+    }
+
+    return serviced;
+}
+
+uint8_t QwOpt4048AlertGroup::getNumSensors()
+{
+    return _numSensors;
+}
+
+uint32_t QwOpt4048AlertGroup::getAlertsServiced()
+{
+    return _alertsServiced;
+}
+
+uint32_t QwOpt4048AlertGroup::getUnknownAlerts()
+{
+    return _unknownAlerts;
+}
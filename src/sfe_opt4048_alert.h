@@ -0,0 +1,105 @@
+/*
+sfe_opt4048_alert.h
+
+SparkFun Tristimulus Color Sensor - OPT4048
+
+Qwiic 1x1
+* https://www.sparkfun.com/products/
+Qwiic Mini
+* https://www.sparkfun.com/products/
+
+Repository:
+* https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+The MIT License (MIT)
+
+Copyright (c) 2022 SparkFun Electronics
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions: The
+above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED
+"AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+License(http://opensource.org/licenses/MIT).
+
+The following class services several OPT4048 sensors that share one I2C bus
+and one wired-OR ALERT line, with the INT pins configured for SMBus alert.
+Instead of reading the flags of every sensor to find the one that interrupted,
+the SMBus Alert Response Address is queried: the alerting sensor answers with
+its address and releases ALERT, and only that sensor is serviced through its
+QwOpt4048Events handlers. An interrupt costs two transactions however many
+sensors share the line.
+
+*/
+#pragma once
+#include "sfe_opt4048_events.h"
+#include <stdint.h>
+
+class QwOpt4048AlertGroup
+{
+  public:
+    QwOpt4048AlertGroup()
+        : _numSensors(0), _alertPin(0), _hasAlertPin(false), _pending(false), _alertsServiced(0), _unknownAlerts(0) {};
+
+    /// @brief Adds a sensor to the group. The handlers must already be attached to a started sensor with
+    ///        QwOpt4048Events::begin(), and all sensors in the group must share one bus.
+    /// @param events The handlers of the sensor. They must outlive the group.
+    /// @return True on success, false if the group is full, no sensor is attached, or the address is
+    ///         already in the group.
+    bool addSensor(QwOpt4048Events &events);
+
+    /// @brief Switches the INT pin of every sensor to a latched, active low SMBus alert output.
+    /// @return True if every sensor was configured and reads back INT as an SMBus alert output.
+    bool begin();
+
+    /// @brief As begin(), and reads the ALERT line before each query so servicing stops as soon as the
+    ///        line is released, without a final query that nobody answers.
+    /// @param alertPin The GPIO wired to the ALERT line.
+    /// @return True if every sensor was configured.
+    bool begin(uint8_t alertPin);
+
+    /// @brief Marks an alert as pending. Safe to call from an ISR attached to the ALERT line, since no
+    ///        bus access takes place.
+    void notify();
+
+    /// @brief Services a pending alert marked with notify(). Call this from loop().
+    /// @return The number of sensors serviced.
+    uint8_t service();
+
+    /// @brief Queries the Alert Response Address and services the sensor that answers, until ALERT is
+    ///        released. Sensors alerting at the same time answer one after the other, lowest address
+    ///        first.
+    /// @return The number of sensors serviced.
+    uint8_t serviceAlert();
+
+    /// @brief Retrieves the number of sensors in the group.
+    uint8_t getNumSensors();
+
+    /// @brief Retrieves the number of alerts serviced since begin().
+    uint32_t getAlertsServiced();
+
+    /// @brief Retrieves the number of alert responses from addresses that are not in the group.
+    uint32_t getUnknownAlerts();
+
+    /// @brief Maximum number of sensors in a group.
+    static constexpr uint8_t kMaxSensors = 4;
+
+  private:
+    QwOpt4048Events *_events[kMaxSensors];
+    uint8_t _addresses[kMaxSensors];
+    uint8_t _numSensors;
+    uint8_t _alertPin;
+    bool _hasAlertPin;
+    volatile bool _pending;
+    uint32_t _alertsServiced;
+    uint32_t _unknownAlerts;
+};
@@ -0,0 +1,425 @@
+/*
+sfe_opt4048_color.cpp
+
+SparkFun Tristimulus Color Sensor - OPT4048
+
+Qwiic 1x1
+* https://www.sparkfun.com/products/
+Qwiic Mini
+* https://www.sparkfun.com/products/
+
+Repository:
+* https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+The MIT License (MIT)
+
+Copyright (c) 2022 SparkFun Electronics
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions: The
+above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED
+"AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+License(http://opensource.org/licenses/MIT).
+
+The following functions implement the color space conversions declared in
+sfe_opt4048_color.h.
+
+*/
+#include "sfe_opt4048_color.h"
+#include "sfe_opt4048_progmem.h"
+#include <math.h>
+
+// The CIE matrix of 9.2.4 of the datasheet, transposed to one row per output (X, Y, Z) and scaled by
+// 2^40. XYZ is always normalized to a white afterwards, so only the ratios of the entries matter.
+static const int32_t xyzMatrix[3][3] OPT4048_PROGMEM = {{258267576, 44801519, 102102783},
+                                                        {-20852501, 218756857, -18663061},
+                                                        {13283385, -17465535, 741094499}};
+
+// Linear sRGB from XYZ (IEC 61966-2-1), Q20. Saturated colors reach X and Z of several times the white,
+// so the entries need more precision than the result.
+static const int32_t rgbMatrix[3][3] OPT4048_PROGMEM = {
+    {3398015, -1611871, -522820}, {-1015965, 1966919, 43516}, {58406, -213910, 1108345}};
+
+// sRGB gamma encoding of linear values from 2^-9 to 1, Q16 with 65535 as one. Each octave of the input
+// has 16 entries, so the steep part of the curve near black is covered as finely as the rest.
+static const uint16_t gammaTable[] OPT4048_PROGMEM = {
+    1654, 1757, 1860, 1964, 2067, 2171, 2274, 2377, 2481, 2584, 2687, 2786,
+    2884, 2979, 3073, 3165, 3255, 3431, 3600, 3764, 3923, 4078, 4228, 4375,
+    4518, 4657, 4793, 4926, 5056, 5184, 5309, 5432, 5552, 5786, 6012, 6232,
+    6444, 6650, 6851, 7047, 7237, 7423, 7605, 7783, 7956, 8127, 8294, 8457,
+    8618, 8930, 9233, 9525, 9809, 10084, 10352, 10613, 10867, 11116, 11358, 11595,
+    11827, 12055, 12277, 12496, 12710, 13128, 13531, 13921, 14300, 14668, 15025, 15374,
+    15713, 16044, 16368, 16685, 16995, 17298, 17595, 17887, 18173, 18730, 19269, 19790,
+    20295, 20786, 21263, 21728, 22181, 22624, 23056, 23478, 23892, 24297, 24694, 25083,
+    25465, 26209, 26927, 27623, 28298, 28953, 29590, 30210, 30815, 31406, 31983, 32547,
+    33099, 33639, 34169, 34689, 35199, 36191, 37151, 38079, 38980, 39854, 40705, 41533,
+    42341, 43129, 43899, 44652, 45388, 46110, 46817, 47511, 48192, 49517, 50797, 52036,
+    53238, 54406, 55541, 56647, 57725, 58777, 59805, 60810, 61793, 62757, 63701, 64626,
+    65535};
+
+// Cube root minus one half of 16/128 to 128/128 in steps of 1/128, Q16.
+static const uint16_t cbrtTable[] OPT4048_PROGMEM = {
+    0, 669, 1312, 1932, 2530, 3109, 3670, 4214, 4742, 5256, 5756, 6244,
+    6720, 7184, 7638, 8082, 8517, 8943, 9360, 9769, 10170, 10564, 10951, 11331,
+    11705, 12073, 12434, 12790, 13141, 13486, 13826, 14161, 14492, 14818, 15139, 15456,
+    15770, 16079, 16384, 16686, 16983, 17278, 17569, 17856, 18141, 18422, 18700, 18976,
+    19248, 19517, 19784, 20048, 20310, 20569, 20825, 21079, 21331, 21580, 21827, 22072,
+    22315, 22555, 22794, 23030, 23264, 23497, 23728, 23956, 24183, 24408, 24632, 24853,
+    25073, 25291, 25508, 25723, 25937, 26149, 26359, 26568, 26775, 26981, 27186, 27389,
+    27591, 27792, 27991, 28189, 28385, 28581, 28775, 28968, 29160, 29350, 29540, 29728,
+    29915, 30101, 30286, 30470, 30652, 30834, 31015, 31195, 31373, 31551, 31728, 31903,
+    32078, 32252, 32425, 32597, 32768};
+
+// Below this linear value (0.0031308) the sRGB curve is a straight line of slope 12.92 (Q8).
+static constexpr int32_t kGammaLinearLimit = 205;
+static constexpr int32_t kGammaSlope = 3308;
+
+// D65 white point: reciprocals of Xn and Zn (Yn is one), Q16.
+static constexpr int64_t kInvWhiteX = 68951;
+static constexpr int64_t kInvWhiteZ = 60189;
+
+// CIELAB f(t) is a straight line below (6/29)^3: slope 7.787 and offset 16/116, both Q16.
+static constexpr int32_t kLabLinearLimit = 580;
+static constexpr int32_t kLabSlope = 510329;
+static constexpr int32_t kLabOffset = 9039;
+
+// u' and v' of the D65 white point, Q16.
+static constexpr int64_t kWhiteU = 12966;
+static constexpr int64_t kWhiteV = 30693;
+
+static int32_t roundShift(int64_t value, uint8_t shift)
+{
+    return (int32_t)((value + ((int64_t)1 << (shift - 1))) >> shift);
+}
+
+static int32_t saturate(int64_t value)
+{
+    if (value > INT32_MAX)
+        return INT32_MAX;
+
+    if (value < INT32_MIN)
+        return INT32_MIN;
+
+    return (int32_t)value;
+}
+
+static void rawXYZ(const sfe_color_t *color, int64_t *xyz)
+{
+    for (uint8_t i = 0; i < 3; i++)
+    {
+        xyz[i] = (int64_t)color->red * opt4048ReadProgmem(&xyzMatrix[i][0]);
+        xyz[i] += (int64_t)color->green * opt4048ReadProgmem(&xyzMatrix[i][1]);
+        xyz[i] += (int64_t)color->blue * opt4048ReadProgmem(&xyzMatrix[i][2]);
+    }
+}
+
+// value / white in Q16. Both are shifted down together until the scaled value fits in 64 bits.
+static int32_t normalize(int64_t value, int64_t white)
+{
+    while (value > ((int64_t)1 << 46) || value < -((int64_t)1 << 46))
+    {
+        value >>= 1;
+        white >>= 1;
+    }
+
+    if (white <= 0)
+        return value < 0 ? INT32_MIN : INT32_MAX;
+
+    return saturate(value * OPT4048_XYZ_ONE / white);
+}
+
+// Gamma encodes a linear value, Q16. Returns Q16 with 65535 as one.
+static uint16_t gammaEncode(int32_t linear)
+{
+    if (linear <= 0)
+        return 0;
+
+    if (linear >= OPT4048_XYZ_ONE)
+        return 65535;
+
+    if (linear < kGammaLinearLimit)
+        return (linear * kGammaSlope + 128) >> 8;
+
+    // Octave 0 starts at 2^7 (2^-9 in Q16); the 16 entries of an octave are 2^(octave + 3) apart.
+    uint8_t octave = 0;
+
+    while (linear >> (8 + octave))
+        octave++;
+
+    uint8_t step = octave + 3;
+    int32_t offset = linear - ((int32_t)1 << (octave + 7));
+    uint8_t index = octave * 16 + (offset >> step);
+    int32_t low = opt4048ReadProgmem(&gammaTable[index]);
+    int32_t high = opt4048ReadProgmem(&gammaTable[index + 1]);
+
+    return low + (((high - low) * (offset & ((1 << step) - 1))) >> step);
+}
+
+static uint8_t to8Bit(uint16_t value)
+{
+    return ((uint32_t)value * 255 + 32767) / 65535;
+}
+
+// Cube root of a positive Q16 value. The value is scaled by powers of 8 into [1/8, 1), where the table
+// holds the cube root, and the result is scaled back by the matching power of 2. Values above one are
+// scaled by a shift that is only applied to the table index, so no bits are lost for the interpolation.
+static int32_t cbrtQ16(uint32_t value)
+{
+    int8_t exponent = 0;
+    uint8_t shift = 0;
+
+    while ((value >> shift) >= OPT4048_XYZ_ONE)
+    {
+        shift += 3;
+        exponent++;
+    }
+
+    while (value < OPT4048_XYZ_ONE / 8)
+    {
+        value <<= 3;
+        exponent--;
+    }
+
+    uint8_t index = (value >> (9 + shift)) - 16;
+    int64_t fraction = value & (((uint32_t)512 << shift) - 1);
+    int32_t low = opt4048ReadProgmem(&cbrtTable[index]);
+    int32_t high = opt4048ReadProgmem(&cbrtTable[index + 1]);
+    int32_t root = OPT4048_XYZ_ONE / 2 + low + roundShift((high - low) * fraction, 9 + shift);
+
+    return exponent >= 0 ? root << exponent : root >> -exponent;
+}
+
+// CIELAB f(t), Q16 in and out.
+static int32_t labF(int64_t t)
+{
+    if (t > INT32_MAX)
+        t = INT32_MAX;
+
+    if (t <= kLabLinearLimit)
+        return roundShift(t * kLabSlope, 16) + kLabOffset;
+
+    return cbrtQ16((uint32_t)t);
+}
+
+// L* in Q8 from f(Y / Yn).
+static int32_t lightness(int32_t fy)
+{
+    return roundShift((int64_t)fy * 116, 8) - 16 * OPT4048_LAB_ONE;
+}
+
+static void xyzToLuv(const sfe_opt4048_xyz_t *xyz, int32_t L, sfe_opt4048_luv_t *luv)
+{
+    int64_t denominator = (int64_t)xyz->X + 15 * (int64_t)xyz->Y + 3 * (int64_t)xyz->Z;
+
+    luv->L = L;
+
+    if (denominator <= 0)
+    {
+        luv->u = 0;
+        luv->v = 0;
+        return;
+    }
+
+    int64_t uPrime = (int64_t)xyz->X * 4 * OPT4048_XYZ_ONE / denominator;
+    int64_t vPrime = (int64_t)xyz->Y * 9 * OPT4048_XYZ_ONE / denominator;
+
+    luv->u = roundShift(13 * (int64_t)L * (uPrime - kWhiteU), 16);
+    luv->v = roundShift(13 * (int64_t)L * (vPrime - kWhiteV), 16);
+}
+
+void opt4048CalculateXYZ(const sfe_color_t *color, const sfe_color_t *white, sfe_opt4048_xyz_t *xyz)
+{
+    int64_t sample[3];
+    int64_t reference[3];
+
+    rawXYZ(color, sample);
+
+    if (white != nullptr)
+        rawXYZ(white, reference);
+    else
+        reference[1] = sample[1];
+
+    if (reference[1] <= 0)
+    {
+        xyz->X = 0;
+        xyz->Y = 0;
+        xyz->Z = 0;
+        return;
+    }
+
+    xyz->X = normalize(sample[0], reference[1]);
+    xyz->Y = normalize(sample[1], reference[1]);
+    xyz->Z = normalize(sample[2], reference[1]);
+}
+
+void opt4048XYZToRGB(const sfe_opt4048_xyz_t *xyz, sfe_opt4048_rgb_t *rgb)
+{
+    int32_t linear[3];
+
+    for (uint8_t i = 0; i < 3; i++)
+    {
+        int64_t sum = (int64_t)xyz->X * opt4048ReadProgmem(&rgbMatrix[i][0]);
+        sum += (int64_t)xyz->Y * opt4048ReadProgmem(&rgbMatrix[i][1]);
+        sum += (int64_t)xyz->Z * opt4048ReadProgmem(&rgbMatrix[i][2]);
+
+        linear[i] = saturate((sum + (1 << 19)) >> 20);
+    }
+
+    rgb->red = to8Bit(gammaEncode(linear[0]));
+    rgb->green = to8Bit(gammaEncode(linear[1]));
+    rgb->blue = to8Bit(gammaEncode(linear[2]));
+}
+
+void opt4048XYZToLab(const sfe_opt4048_xyz_t *xyz, sfe_opt4048_lab_t *lab)
+{
+    int32_t fx = labF(roundShift((int64_t)xyz->X * kInvWhiteX, 16));
+    int32_t fy = labF(xyz->Y);
+    int32_t fz = labF(roundShift((int64_t)xyz->Z * kInvWhiteZ, 16));
+
+    lab->L = lightness(fy);
+    lab->a = roundShift((int64_t)(fx - fy) * 500, 8);
+    lab->b = roundShift((int64_t)(fy - fz) * 200, 8);
+}
+
+void opt4048XYZToLuv(const sfe_opt4048_xyz_t *xyz, sfe_opt4048_luv_t *luv)
+{
+    xyzToLuv(xyz, lightness(labF(xyz->Y)), luv);
+}
+
+void opt4048CalculateColorSpaces(const sfe_color_t *color, const sfe_color_t *white,
+                                 sfe_opt4048_color_spaces_t *spaces)
+{
+    opt4048CalculateXYZ(color, white, &spaces->xyz);
+    opt4048XYZToRGB(&spaces->xyz, &spaces->rgb);
+    opt4048XYZToLab(&spaces->xyz, &spaces->lab);
+    xyzToLuv(&spaces->xyz, spaces->lab.L, &spaces->luv);
+}
+
+static uint32_t isqrt64(uint64_t value)
+{
+    uint64_t root = 0;
+    uint64_t bit = (uint64_t)1 << 62;
+
+    while (bit > value)
+        bit >>= 2;
+
+    while (bit)
+    {
+        if (value >= root + bit)
+        {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else
+            root >>= 1;
+
+        bit >>= 2;
+    }
+
+    return (uint32_t)root;
+}
+
+int32_t opt4048DeltaE76(const sfe_opt4048_lab_t *lab1, const sfe_opt4048_lab_t *lab2)
+{
+    int64_t dL = lab1->L - lab2->L;
+    int64_t da = lab1->a - lab2->a;
+    int64_t db = lab1->b - lab2->b;
+
+    return isqrt64(dL * dL + da * da + db * db);
+}
+
+// Hue angle in radians, 0 to 2 pi.
+static float hueAngle(float b, float a)
+{
+    if (a == 0 && b == 0)
+        return 0;
+
+    float h = atan2f(b, a);
+
+    return h < 0 ? h + 2 * (float)M_PI : h;
+}
+
+int32_t opt4048DeltaE2000(const sfe_opt4048_lab_t *lab1, const sfe_opt4048_lab_t *lab2)
+{
+    // Sharma, Wu, and Dalal, "The CIEDE2000 Color-Difference Formula", 2005.
+    const float kPi = (float)M_PI;
+    const float kDegree = kPi / 180;
+    const float kPow25To7 = 6103515625.0f;
+
+    float L1 = lab1->L / (float)OPT4048_LAB_ONE;
+    float a1 = lab1->a / (float)OPT4048_LAB_ONE;
+    float b1 = lab1->b / (float)OPT4048_LAB_ONE;
+    float L2 = lab2->L / (float)OPT4048_LAB_ONE;
+    float a2 = lab2->a / (float)OPT4048_LAB_ONE;
+    float b2 = lab2->b / (float)OPT4048_LAB_ONE;
+
+    float Cbar = (sqrtf(a1 * a1 + b1 * b1) + sqrtf(a2 * a2 + b2 * b2)) / 2;
+    float Cbar7 = Cbar * Cbar * Cbar * Cbar * Cbar * Cbar * Cbar;
+    float G = 0.5f * (1 - sqrtf(Cbar7 / (Cbar7 + kPow25To7)));
+
+    float a1p = (1 + G) * a1;
+    float a2p = (1 + G) * a2;
+    float C1p = sqrtf(a1p * a1p + b1 * b1);
+    float C2p = sqrtf(a2p * a2p + b2 * b2);
+    float h1p = hueAngle(b1, a1p);
+    float h2p = hueAngle(b2, a2p);
+
+    float dLp = L2 - L1;
+    float dCp = C2p - C1p;
+    float dhp = 0;
+
+    if (C1p * C2p != 0)
+    {
+        dhp = h2p - h1p;
+
+        if (dhp > kPi)
+            dhp -= 2 * kPi;
+        else if (dhp < -kPi)
+            dhp += 2 * kPi;
+    }
+
+    float dHp = 2 * sqrtf(C1p * C2p) * sinf(dhp / 2);
+
+    float Lbarp = (L1 + L2) / 2;
+    float Cbarp = (C1p + C2p) / 2;
+    float hbarp = h1p + h2p;
+
+    if (C1p * C2p != 0)
+    {
+        if (fabsf(h1p - h2p) <= kPi)
+            hbarp /= 2;
+        else if (hbarp < 2 * kPi)
+            hbarp = (hbarp + 2 * kPi) / 2;
+        else
+            hbarp = (hbarp - 2 * kPi) / 2;
+    }
+
+    float T = 1 - 0.17f * cosf(hbarp - 30 * kDegree) + 0.24f * cosf(2 * hbarp) +
+              0.32f * cosf(3 * hbarp + 6 * kDegree) - 0.20f * cosf(4 * hbarp - 63 * kDegree);
+
+    float hueOffset = (hbarp / kDegree - 275) / 25;
+    float dTheta = 30 * kDegree * expf(-hueOffset * hueOffset);
+    float Cbarp7 = Cbarp * Cbarp * Cbarp * Cbarp * Cbarp * Cbarp * Cbarp;
+    float RC = 2 * sqrtf(Cbarp7 / (Cbarp7 + kPow25To7));
+    float Lm50 = (Lbarp - 50) * (Lbarp - 50);
+    float SL = 1 + 0.015f * Lm50 / sqrtf(20 + Lm50);
+    float SC = 1 + 0.045f * Cbarp;
+    float SH = 1 + 0.015f * Cbarp * T;
+    float RT = -sinf(2 * dTheta) * RC;
+
+    float tL = dLp / SL;
+    float tC = dCp / SC;
+    float tH = dHp / SH;
+
+    return (int32_t)(sqrtf(tL * tL + tC * tC + tH * tH + RT * tC * tH) * OPT4048_LAB_ONE + 0.5f);
+}
@@ -0,0 +1,148 @@
+/*
+sfe_opt4048_color.h
+
+SparkFun Tristimulus Color Sensor - OPT4048
+
+Qwiic 1x1
+* https://www.sparkfun.com/products/
+Qwiic Mini
+* https://www.sparkfun.com/products/
+
+Repository:
+* https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+The MIT License (MIT)
+
+Copyright (c) 2022 SparkFun Electronics
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions: The
+above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED
+"AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+License(http://opensource.org/licenses/MIT).
+
+The following functions convert a raw OPT4048 sample to CIE XYZ, sRGB, CIELAB,
+and CIELUV, and calculate the color differences Delta E 1976 and Delta E 2000.
+The conversions use integer arithmetic only: fixed-point matrices, a lookup
+table for the sRGB gamma curve, and a table based cube root for CIELAB, so
+they run fast on parts without a double precision FPU. Delta E 2000 needs
+trigonometry and is calculated in single precision float.
+
+Error bounds against a double precision reference, for samples up to the
+luminance of the reference white:
+    sRGB            within 0.6 of a code of the exact value
+    CIELAB, CIELUV  L*, a*, b*, u*, v* within 0.1, mostly from the resolution
+                    of XYZ near black
+    Delta E 1976    within 0.004 of the exact difference of the same colors
+    Delta E 2000    within 0.0025 of the exact difference of the same colors
+Samples up to eight times brighter than the white stay within 0.2 for CIELAB
+and CIELUV. extras/opt4048_checks/color_check measures these bounds.
+
+*/
+#pragma once
+#include "sfe_opt4048_decode.h"
+#include <stdint.h>
+
+/// @brief One in the Q16 format of sfe_opt4048_xyz_t.
+#define OPT4048_XYZ_ONE 65536
+
+/// @brief One in the Q8 format of sfe_opt4048_lab_t, sfe_opt4048_luv_t, and Delta E.
+#define OPT4048_LAB_ONE 256
+
+/// @brief CIE XYZ relative to a reference white, Q16: a Y of OPT4048_XYZ_ONE is the luminance of the white.
+typedef struct
+{
+    int32_t X;
+    int32_t Y;
+    int32_t Z;
+
+} sfe_opt4048_xyz_t;
+
+/// @brief Gamma encoded 8 bit sRGB.
+typedef struct
+{
+    uint8_t red;
+    uint8_t green;
+    uint8_t blue;
+
+} sfe_opt4048_rgb_t;
+
+/// @brief CIELAB under a D65 white, Q8: divide by OPT4048_LAB_ONE for L*, a*, b*.
+typedef struct
+{
+    int32_t L;
+    int32_t a;
+    int32_t b;
+
+} sfe_opt4048_lab_t;
+
+/// @brief CIELUV under a D65 white, Q8: divide by OPT4048_LAB_ONE for L*, u*, v*.
+typedef struct
+{
+    int32_t L;
+    int32_t u;
+    int32_t v;
+
+} sfe_opt4048_luv_t;
+
+/// @brief All color spaces of one sample, see opt4048CalculateColorSpaces().
+typedef struct
+{
+    sfe_opt4048_xyz_t xyz;
+    sfe_opt4048_rgb_t rgb;
+    sfe_opt4048_lab_t lab;
+    sfe_opt4048_luv_t luv;
+
+} sfe_opt4048_color_spaces_t;
+
+/// @brief Calculates CIE XYZ from a decoded sample with the matrix in 9.2.4 of the datasheet.
+/// @param color Pointer to the decoded sample.
+/// @param white Pointer to a sample of the reference white, e.g. the light source measured directly.
+///        Pass nullptr to scale the sample to a Y of one, which keeps only its chromaticity.
+/// @param xyz Pointer to the struct to be populated.
+void opt4048CalculateXYZ(const sfe_color_t *color, const sfe_color_t *white, sfe_opt4048_xyz_t *xyz);
+
+/// @brief Converts XYZ to gamma encoded sRGB. Colors outside the sRGB gamut are clipped per channel.
+/// @param xyz Pointer to the XYZ values.
+/// @param rgb Pointer to the struct to be populated.
+void opt4048XYZToRGB(const sfe_opt4048_xyz_t *xyz, sfe_opt4048_rgb_t *rgb);
+
+/// @brief Converts XYZ to CIELAB with a D65 white point.
+/// @param xyz Pointer to the XYZ values.
+/// @param lab Pointer to the struct to be populated.
+void opt4048XYZToLab(const sfe_opt4048_xyz_t *xyz, sfe_opt4048_lab_t *lab);
+
+/// @brief Converts XYZ to CIELUV with a D65 white point.
+/// @param xyz Pointer to the XYZ values.
+/// @param luv Pointer to the struct to be populated.
+void opt4048XYZToLuv(const sfe_opt4048_xyz_t *xyz, sfe_opt4048_luv_t *luv);
+
+/// @brief Calculates XYZ, sRGB, CIELAB, and CIELUV from a single decoded sample, sharing the XYZ
+///        matrix and the lightness between them.
+/// @param color Pointer to the decoded sample.
+/// @param white Pointer to a sample of the reference white, or nullptr. See opt4048CalculateXYZ().
+/// @param spaces Pointer to the struct to be populated.
+void opt4048CalculateColorSpaces(const sfe_color_t *color, const sfe_color_t *white,
+                                 sfe_opt4048_color_spaces_t *spaces);
+
+/// @brief Calculates the CIE 1976 color difference, the distance between two CIELAB colors.
+/// @param lab1 Pointer to the first color.
+/// @param lab2 Pointer to the second color.
+/// @return Delta E 1976, Q8.
+int32_t opt4048DeltaE76(const sfe_opt4048_lab_t *lab1, const sfe_opt4048_lab_t *lab2);
+
+/// @brief Calculates the CIEDE2000 color difference, with the weighting factors kL, kC, and kH at one.
+/// @param lab1 Pointer to the first color.
+/// @param lab2 Pointer to the second color.
+/// @return Delta E 2000, Q8.
+int32_t opt4048DeltaE2000(const sfe_opt4048_lab_t *lab1, const sfe_opt4048_lab_t *lab2);
@@ -0,0 +1,180 @@
+/*
+sfe_opt4048_dark.cpp
+
+SparkFun Tristimulus Color Sensor - OPT4048
+
+Qwiic 1x1
+* https://www.sparkfun.com/products/
+Qwiic Mini
+* https://www.sparkfun.com/products/
+
+Repository:
+* https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+The MIT License (MIT)
+
+Copyright (c) 2022 SparkFun Electronics
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions: The
+above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED
+"AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+License(http://opensource.org/licenses/MIT).
+
+The following functions implement the dark-offset table declared in
+sfe_opt4048_dark.h.
+
+*/
+#include "sfe_opt4048_dark.h"
+
+#define kDarkSetting(range, time) ((uint8_t)(((range) << 4) | ((time) & 0x0F)))
+
+bool QwOpt4048DarkTable::calibrate(QwOpt4048 &sensor, opt4048_range_t range, opt4048_conversion_time_t time,
+                                   uint8_t numSamples)
+{
+    uint8_t saved[2];
+    uint8_t buff[16];
+    uint32_t sums[4] = {0, 0, 0, 0};
+    uint32_t timeoutMs;
+    uint16_t offsets[4];
+    sfe_color_t color;
+    opt4048_reg_control_t controlReg;
+    bool success = true;
+
+    if (range > RANGE_144LUX || time > CONVERSION_TIME_800MS || numSamples == 0)
+        return false;
+
+    if (sensor.readRegisterRegion(SFE_OPT4048_REGISTER_CONTROL, saved) != 0)
+        return false;
+
+    controlReg.word = saved[0] << 8;
+    controlReg.word |= saved[1];
+    controlReg.range = range;
+    controlReg.conversion_time = time;
+    controlReg.op_mode = OPERATION_MODE_CONTINUOUS;
+
+    buff[0] = controlReg.word >> 8;
+    buff[1] = controlReg.word;
+
+    if (sensor.writeRegisterRegion(SFE_OPT4048_REGISTER_CONTROL, buff) != 0)
+        return false;
+
+    // Two sample periods before a sample counts as missed.
+    timeoutMs = sensor.getSamplePeriodUs() / 500 + 10;
+
+    // The first sample is dropped. The raw image is read, so an offset already in use doesn't count.
+    for (uint16_t i = 0; i <= numSamples && success; i++)
+    {
+        if (!sensor.waitForSample(timeoutMs) && !sensor.waitForSample(timeoutMs))
+            success = false;
+        else if (sensor.readRegisterRegion(SFE_OPT4048_REGISTER_EXP_RES_CH0, buff, 16) != 0)
+            success = false;
+        else if (i > 0)
+        {
+            opt4048DecodeImage(buff, &color);
+
+            sums[0] += color.red < 0xFFFF ? color.red : 0xFFFF;
+            sums[1] += color.green < 0xFFFF ? color.green : 0xFFFF;
+            sums[2] += color.blue < 0xFFFF ? color.blue : 0xFFFF;
+            sums[3] += color.white < 0xFFFF ? color.white : 0xFFFF;
+        }
+    }
+
+    if (sensor.writeRegisterRegion(SFE_OPT4048_REGISTER_CONTROL, saved) != 0 || !success)
+        return false;
+
+    for (uint8_t channel = 0; channel < 4; channel++)
+        offsets[channel] = (sums[channel] + numSamples / 2) / numSamples;
+
+    if (!setOffsets(range, time, offsets))
+        return false;
+
+    _entries[_last].samples = numSamples;
+
+    return true;
+}
+
+bool QwOpt4048DarkTable::setOffsets(opt4048_range_t range, opt4048_conversion_time_t time, const uint16_t *offsets)
+{
+    sfe_opt4048_dark_entry_t *entry;
+
+    if (range > RANGE_144LUX || time > CONVERSION_TIME_800MS)
+        return false;
+
+    entry = store(kDarkSetting(range, time));
+
+    if (entry == nullptr)
+        return false;
+
+    entry->samples = 0;
+
+    for (uint8_t channel = 0; channel < 4; channel++)
+        entry->offsets[channel] = offsets[channel];
+
+    return true;
+}
+
+sfe_opt4048_dark_entry_t *QwOpt4048DarkTable::store(uint8_t setting)
+{
+    for (uint8_t i = 0; i < _count; i++)
+    {
+        if (_entries[i].setting == setting)
+        {
+            _last = i;
+            return &_entries[i];
+        }
+    }
+
+    if (_count >= _capacity)
+        return nullptr;
+
+    _last = _count++;
+    _entries[_last].setting = setting;
+
+    return &_entries[_last];
+}
+
+uint16_t QwOpt4048DarkTable::getOffset(uint8_t channel, uint8_t range, uint8_t time)
+{
+    uint8_t setting = kDarkSetting(range, time);
+
+    if (channel > 3 || _count == 0)
+        return 0;
+
+    // All channels of a sample usually share a range, so the last entry is the likely one.
+    if (_entries[_last].setting != setting)
+    {
+        uint8_t i;
+
+        for (i = 0; i < _count && _entries[i].setting != setting; i++)
+            ;
+
+        if (i == _count)
+            return 0;
+
+        _last = i;
+    }
+
+    return _entries[_last].offsets[channel];
+}
+
+void QwOpt4048DarkTable::clear()
+{
+    _count = 0;
+    _last = 0;
+}
+
+uint8_t QwOpt4048DarkTable::getCount()
+{
+    return _count;
+}
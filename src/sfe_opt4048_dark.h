@@ -0,0 +1,104 @@
+/*
+sfe_opt4048_dark.h
+
+SparkFun Tristimulus Color Sensor - OPT4048
+
+Qwiic 1x1
+* https://www.sparkfun.com/products/
+Qwiic Mini
+* https://www.sparkfun.com/products/
+
+Repository:
+* https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+The MIT License (MIT)
+
+Copyright (c) 2022 SparkFun Electronics
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions: The
+above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED
+"AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+License(http://opensource.org/licenses/MIT).
+
+The following class holds the dark offsets of a sensor: the ADC codes each
+channel reads with no light, e.g. from light leaking into the enclosure. The
+offsets are measured per range and conversion time and stored as a compact
+table of 10 byte entries in memory provided by the caller. Once the table is
+set with QwOpt4048::setDarkTable(), the offsets are subtracted in integer
+arithmetic from every sample as it is decoded, before any CIE calculation.
+The entries are plain data and can be saved to EEPROM and loaded again.
+
+*/
+#pragma once
+#include "sfe_opt4048.h"
+#include <stdint.h>
+
+/// @brief The dark offsets of one range and conversion time.
+typedef struct
+{
+    uint8_t setting;     // Range in the upper four bits, conversion time in the lower four
+    uint8_t samples;     // Dark samples averaged, 0 if the offsets were set directly
+    uint16_t offsets[4]; // Dark ADC codes of Channel Zero to Three
+
+} sfe_opt4048_dark_entry_t;
+
+class QwOpt4048DarkTable
+{
+  public:
+    /// @brief Creates a table in an array of entries provided by the caller.
+    /// @param entries The memory for the entries.
+    /// @param capacity Number of entries the array holds, e.g. one per range used.
+    QwOpt4048DarkTable(sfe_opt4048_dark_entry_t *entries, uint8_t capacity)
+        : _entries(entries), _capacity(capacity), _count(0), _last(0) {};
+
+    /// @brief Measures the dark offsets of a range and conversion time. The sensor must be covered.
+    ///        It runs in continuous mode for numSamples + 1 samples, and its CONTROL register is
+    ///        restored afterwards.
+    /// @param sensor The sensor, already started with begin().
+    /// @param range The range, RANGE_2KLUX2 to RANGE_144LUX.
+    /// @param time The conversion time.
+    /// @param numSamples Dark samples to average, 1 to 255.
+    /// @return True on success, false on a bad argument, a bus error, a missed sample, or a full table.
+    bool calibrate(QwOpt4048 &sensor, opt4048_range_t range, opt4048_conversion_time_t time,
+                   uint8_t numSamples = 8);
+
+    /// @brief Sets the dark offsets of a range and conversion time, e.g. from a factory calibration.
+    ///        An existing entry of the same setting is replaced.
+    /// @param range The range, RANGE_2KLUX2 to RANGE_144LUX.
+    /// @param time The conversion time.
+    /// @param offsets The dark ADC codes of Channel Zero to Three.
+    /// @return True on success, false on a bad argument or a full table.
+    bool setOffsets(opt4048_range_t range, opt4048_conversion_time_t time, const uint16_t *offsets);
+
+    /// @brief Retrieves the dark offset of one channel.
+    /// @param channel The channel, 0 to 3.
+    /// @param range The range of the conversion, i.e. the exponent of the result.
+    /// @param time The conversion time.
+    /// @return The dark ADC code, 0 if the setting was not calibrated.
+    uint16_t getOffset(uint8_t channel, uint8_t range, uint8_t time);
+
+    /// @brief Removes all entries.
+    void clear();
+
+    /// @brief Retrieves the number of entries.
+    uint8_t getCount();
+
+  private:
+    sfe_opt4048_dark_entry_t *store(uint8_t setting);
+
+    sfe_opt4048_dark_entry_t *_entries;
+    uint8_t _capacity;
+    uint8_t _count;
+    uint8_t _last; // Entry of the last lookup, tried first
+};
@@ -0,0 +1,255 @@
+/*
+sfe_opt4048_decode.cpp
+
+SparkFun Tristimulus Color Sensor - OPT4048
+
+Qwiic 1x1
+* https://www.sparkfun.com/products/
+Qwiic Mini
+* https://www.sparkfun.com/products/
+
+Repository:
+* https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+The MIT License (MIT)
+
+Copyright (c) 2022 SparkFun Electronics
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions: The
+above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED
+"AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+License(http://opensource.org/licenses/MIT).
+
+The following functions implement the register decoding and color
+calculations declared in sfe_opt4048_decode.h.
+
+*/
+#include "sfe_opt4048_decode.h"
+#include "OPT4048_Registers.h"
+#include "sfe_opt4048_progmem.h"
+#include <math.h>
+
+static constexpr uint8_t kOPTMatrixRows = 4;
+static constexpr uint8_t kOPTMatrixCols = 4;
+// Table in 9.2.4 of Datasheet for calculating CIE x and y, and Lux.
+static const double cieMatrix[kOPTMatrixRows][kOPTMatrixCols] OPT4048_PROGMEM = {
+    {.000234892992, -.0000189652390, .0000120811684, 0},
+    {.0000407467441, .000198958202, -.0000158848115, .00215},
+    {.0000928619404, -.0000169739553, .000674021520, 0},
+    {0, 0, 0, 0}};
+
+// Conversion time of a single channel, indexed by opt4048_conversion_time_t.
+static const uint32_t conversionTimeUs[] OPT4048_PROGMEM = {600,   1000,   1800,   3400,   6500,   12700,
+                                                            25000, 50000, 100000, 200000, 400000, 800000};
+
+// Full scale of Channel One in lux, indexed by opt4048_range_t.
+static const uint32_t rangeFullScaleLux[] OPT4048_PROGMEM = {2254, 4509, 9018, 18036, 36071, 72142, 144284};
+
+static inline double cieCoefficient(uint8_t row, uint8_t col)
+{
+    return opt4048ReadProgmem(&cieMatrix[row][col]);
+}
+
+void opt4048DecodeChannel(const uint8_t *regs, uint32_t *mantissa, uint8_t *exponent, uint8_t *counter, uint8_t *crc)
+{
+    // All four channels share the same register layout.
+    opt4048_reg_exp_res_ch0_t adcMSB;
+    opt4048_reg_res_cnt_crc_ch0_t adcLSB;
+
+    adcMSB.word = regs[0] << 8;
+    adcMSB.word |= regs[1];
+    adcLSB.word = regs[2] << 8;
+    adcLSB.word |= regs[3];
+
+    *mantissa = (uint32_t)adcMSB.result_msb_ch0 << 8;
+    *mantissa |= adcLSB.result_lsb_ch0;
+    *exponent = adcMSB.exponent_ch0;
+    *counter = adcLSB.counter_ch0;
+    *crc = adcLSB.crc_ch0;
+}
+
+void opt4048DecodeImage(const uint8_t *image, sfe_color_t *color)
+{
+    uint32_t mantissa;
+    uint8_t exponent;
+
+    opt4048DecodeChannel(&image[0], &mantissa, &exponent, &color->counterR, &color->CRCR);
+    color->red = mantissa << exponent;
+
+    opt4048DecodeChannel(&image[4], &mantissa, &exponent, &color->counterG, &color->CRCG);
+    color->green = mantissa << exponent;
+
+    opt4048DecodeChannel(&image[8], &mantissa, &exponent, &color->counterB, &color->CRCB);
+    color->blue = mantissa << exponent;
+
+    opt4048DecodeChannel(&image[12], &mantissa, &exponent, &color->counterW, &color->CRCW);
+    color->white = mantissa << exponent;
+}
+
+static uint8_t parity(uint32_t value)
+{
+    value ^= value >> 16;
+    value ^= value >> 8;
+    value ^= value >> 4;
+    value ^= value >> 2;
+    value ^= value >> 1;
+
+    return value & 0x01;
+}
+
+uint8_t opt4048CalculateCRC(uint32_t mantissa, uint8_t exponent, uint8_t counter)
+{
+    uint8_t crc;
+
+    // CRC equations from the output register section of the datasheet, written as parities over bit masks.
+    // X[0]: all bits of E, R, and C.
+    crc = parity(exponent ^ mantissa ^ counter);
+    // X[1]: C[1], C[3], the odd bits of R, E[1], E[3].
+    crc |= parity((counter & 0x0A) ^ (mantissa & 0xAAAAA) ^ (exponent & 0x0A)) << 1;
+    // X[2]: C[3], R[3], R[7], R[11], R[15], R[19], E[3].
+    crc |= parity((counter & 0x08) ^ (mantissa & 0x88888) ^ (exponent & 0x08)) << 2;
+    // X[3]: R[3], R[11], R[19].
+    crc |= parity(mantissa & 0x80808) << 3;
+
+    return crc;
+}
+
+uint8_t opt4048CheckImageCRC(const uint8_t *image)
+{
+    uint32_t mantissa;
+    uint8_t exponent;
+    uint8_t counter;
+    uint8_t crc;
+    uint8_t errors = 0;
+
+    for (uint8_t ch = 0; ch < 4; ch++)
+    {
+        opt4048DecodeChannel(&image[ch * 4], &mantissa, &exponent, &counter, &crc);
+
+        if (opt4048CalculateCRC(mantissa, exponent, counter) != crc)
+            errors |= 1 << ch;
+    }
+
+    return errors;
+}
+
+void opt4048CalculateCIE(const sfe_color_t *color, sfe_cie_t *cie)
+{
+    double x = 0;
+    double y = 0;
+    double z = 0;
+    double sum;
+
+    x += color->red * cieCoefficient(0, 0);
+    x += color->green * cieCoefficient(1, 0);
+    x += color->blue * cieCoefficient(2, 0);
+
+    y += color->red * cieCoefficient(0, 1);
+    y += color->green * cieCoefficient(1, 1);
+    y += color->blue * cieCoefficient(2, 1);
+
+    z += color->red * cieCoefficient(0, 2);
+    z += color->green * cieCoefficient(1, 2);
+    z += color->blue * cieCoefficient(2, 2);
+
+    sum = x + y + z;
+
+    cie->CIEx = x / sum;
+    cie->CIEy = y / sum;
+    cie->lux = opt4048CalculateLux(color->green);
+    cie->CCT = opt4048CalculateCCT(cie->CIEx, cie->CIEy);
+}
+
+double opt4048CalculateLux(uint32_t green)
+{
+    return green * cieCoefficient(1, 3);
+}
+
+double opt4048CalculateCCT(double CIEx, double CIEy)
+{
+    double n = (CIEx - 0.3320) / (0.1858 - CIEy);
+
+    // Formula can be found under the CCT section in the datasheet.
+    return 437 * pow(n, 3) + 3601 * pow(n, 2) + 6861 * n + 5517;
+}
+
+uint32_t opt4048ConversionTimeUs(opt4048_conversion_time_t time)
+{
+    if (time > CONVERSION_TIME_800MS)
+        time = CONVERSION_TIME_800MS;
+
+    return opt4048ReadProgmem(&conversionTimeUs[time]);
+}
+
+uint32_t opt4048RangeFullScaleLux(opt4048_range_t range)
+{
+    // Auto range can reach the largest range.
+    if (range > RANGE_144LUX)
+        range = RANGE_144LUX;
+
+    return opt4048ReadProgmem(&rangeFullScaleLux[range]);
+}
+
+uint8_t opt4048ConvertingChannel(const sfe_color_t *color)
+{
+    const uint8_t counters[4] = {color->counterR, color->counterG, color->counterB, color->counterW};
+    uint8_t channel;
+
+    for (channel = 1; channel < 4 && counters[channel] == counters[0]; channel++)
+        ;
+
+    // All equal: Channel Zero of the next set is converting.
+    if (channel == 4)
+        return 0;
+
+    // Counters that don't fit, e.g. after a missed set, are treated the same way.
+    for (uint8_t ch = channel; ch < 4; ch++)
+    {
+        if (counters[ch] != ((counters[0] - 1) & 0x0F))
+            return 0;
+    }
+
+    return channel;
+}
+
+void opt4048EstimateMidpoints(sfe_opt4048_timed_sample_t *sample, bool continuous)
+{
+    const int32_t conv = (int32_t)sample->conversionTimeUs;
+    uint8_t phase = 4;
+    int32_t setStart;
+    int32_t offset;
+    int32_t sum = 0;
+
+    if (continuous)
+    {
+        // Channels 0 to phase - 1 hold the current set, phase to 3 the previous one.
+        phase = opt4048ConvertingChannel(&sample->color);
+        setStart = -(phase * conv + conv / 2);
+    }
+    else
+        setStart = -4 * conv;
+
+    for (uint8_t ch = 0; ch < 4; ch++)
+    {
+        offset = setStart + ch * conv + conv / 2;
+
+        if (ch >= phase)
+            offset -= 4 * conv;
+
+        sample->channelMidpointMicros[ch] = sample->readMicros + offset;
+        sum += offset;
+    }
+
+    sample->midpointMicros = sample->readMicros + sum / 4;
+}
@@ -0,0 +1,149 @@
+/*
+sfe_opt4048_decode.h
+
+SparkFun Tristimulus Color Sensor - OPT4048
+
+Qwiic 1x1
+* https://www.sparkfun.com/products/
+Qwiic Mini
+* https://www.sparkfun.com/products/
+
+Repository:
+* https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+The MIT License (MIT)
+
+Copyright (c) 2022 SparkFun Electronics
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions: The
+above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED
+"AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+License(http://opensource.org/licenses/MIT).
+
+The following functions turn raw OPT4048 register contents into ADC codes and
+CIE color values. They do not touch the bus and have no Arduino dependencies,
+so the same code is used by the QwOpt4048 class and by host side tools that
+decode logged register images.
+
+*/
+#pragma once
+#include "OPT4048_Registers.h"
+#include <stdint.h>
+
+/// @brief Struct used to store the color data from the OPT4048.
+typedef struct
+{
+    uint32_t red;
+    uint32_t green;
+    uint32_t blue;
+    uint32_t white;
+    uint8_t counterR; // Sample counter
+    uint8_t counterG;
+    uint8_t counterB;
+    uint8_t counterW;
+    uint8_t CRCR;
+    uint8_t CRCG;
+    uint8_t CRCB;
+    uint8_t CRCW;
+
+} sfe_color_t;
+
+/// @brief Struct used to store the color values calculated from a single sample.
+typedef struct
+{
+    double CIEx;
+    double CIEy;
+    double lux;
+    double CCT;
+
+} sfe_cie_t;
+
+/// @brief Struct used to store a sample together with its timing.
+typedef struct
+{
+    sfe_color_t color;
+    uint32_t readMicros;                // micros() in the middle of the read transaction
+    uint32_t midpointMicros;            // Estimated mean conversion midpoint of the four channels
+    uint32_t channelMidpointMicros[4];  // Estimated conversion midpoint of each channel
+    uint32_t conversionTimeUs;          // Conversion time of a single channel
+
+} sfe_opt4048_timed_sample_t;
+
+/// @brief Decodes the two registers of one channel.
+/// @param regs The four bytes of the channel's register pair as read from the bus.
+/// @param mantissa Pointer to store the 20 bit mantissa.
+/// @param exponent Pointer to store the 4 bit exponent.
+/// @param counter Pointer to store the 4 bit sample counter.
+/// @param crc Pointer to store the 4 bit CRC.
+void opt4048DecodeChannel(const uint8_t *regs, uint32_t *mantissa, uint8_t *exponent, uint8_t *counter, uint8_t *crc);
+
+/// @brief Decodes the 16 byte image of registers 0x00 to 0x07 into ADC codes, counters, and CRCs.
+/// @param image The register bytes as read from the bus.
+/// @param color Pointer to the color struct to be populated.
+void opt4048DecodeImage(const uint8_t *image, sfe_color_t *color);
+
+/// @brief Calculates the 4 bit CRC the OPT4048 attaches to every channel result.
+/// @param mantissa The 20 bit mantissa.
+/// @param exponent The 4 bit exponent.
+/// @param counter The 4 bit sample counter.
+/// @return The expected CRC.
+uint8_t opt4048CalculateCRC(uint32_t mantissa, uint8_t exponent, uint8_t counter);
+
+/// @brief Checks the CRC of every channel in a 16 byte register image.
+/// @param image The register bytes as read from the bus.
+/// @return Bit mask of the channels with a CRC mismatch, bit 0 for Channel Zero. 0 if all are valid.
+uint8_t opt4048CheckImageCRC(const uint8_t *image);
+
+/// @brief Calculates CIE x, CIE y, lux, and CCT from a decoded sample.
+/// @param color Pointer to the decoded sample.
+/// @param cie Pointer to the struct to be populated.
+void opt4048CalculateCIE(const sfe_color_t *color, sfe_cie_t *cie);
+
+/// @brief Calculates lux from the Channel One ADC code.
+/// @param green The Channel One ADC code.
+/// @return The illuminance in lux.
+double opt4048CalculateLux(uint32_t green);
+
+/// @brief Calculates the Correlated Color Temperature (CCT) from CIE x and y values.
+/// @param CIEx The CIE x value.
+/// @param CIEy The CIE y value.
+/// @return Returns the CCT in Kelvin
+double opt4048CalculateCCT(double CIEx, double CIEy);
+
+/// @brief Retrieves the conversion time of a single channel. A full Red, Green, Blue, and White
+///        sample takes four of these.
+/// @param time The conversion time setting.
+/// @return The conversion time in microseconds.
+uint32_t opt4048ConversionTimeUs(opt4048_conversion_time_t time);
+
+/// @brief Retrieves the full scale illuminance of a range setting.
+/// @param range The range setting. RANGE_AUTO returns the largest range.
+/// @return The full scale of Channel One in lux.
+uint32_t opt4048RangeFullScaleLux(opt4048_range_t range);
+
+/// @brief Finds the channel that was converting when a continuous mode sample was read. The channels
+///        convert in turn: the ones before it already hold the current set, and the ones after it still
+///        hold the previous set and are one count behind.
+/// @param color The decoded sample.
+/// @return The converting channel, 0 to 3. 0 if all counters are equal or don't fit the pattern.
+uint8_t opt4048ConvertingChannel(const sfe_color_t *color);
+
+/// @brief Estimates the conversion midpoint of every channel of a timed sample. In continuous mode
+///        the converting channel is located with opt4048ConvertingChannel(), and the read is assumed
+///        to be in the middle of its conversion, which bounds the error to half a conversion time.
+/// @param sample The sample, with color, readMicros, and conversionTimeUs filled in. The midpoints
+///        are written.
+/// @param continuous True in continuous mode. Otherwise readMicros is taken as the completion time of
+///        a one-shot set.
+void opt4048EstimateMidpoints(sfe_opt4048_timed_sample_t *sample, bool continuous);
@@ -0,0 +1,127 @@
+/*
+sfe_opt4048_events.cpp
+
+SparkFun Tristimulus Color Sensor - OPT4048
+
+Qwiic 1x1
+* https://www.sparkfun.com/products/
+Qwiic Mini
+* https://www.sparkfun.com/products/
+
+Repository:
+* https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+The MIT License (MIT)
+
+Copyright (c) 2022 SparkFun Electronics
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions: The
+above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED
+"AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+License(http://opensource.org/licenses/MIT).
+
+The following functions implement the interrupt dispatch declared in
+sfe_opt4048_events.h.
+
+*/
+#include "sfe_opt4048_events.h"
+
+// Channel data (0x00 - 0x07), thresholds, CONTROL, INT_CONTROL, and FLAGS: 13 registers.
+#define kEventReadBytes ((SFE_OPT4048_REGISTER_FLAGS + 1) * 2)
+
+void QwOpt4048Events::begin(QwOpt4048 &sensor)
+{
+    _sensor = &sensor;
+    _pending = false;
+}
+
+QwOpt4048 *QwOpt4048Events::getSensor()
+{
+    return _sensor;
+}
+
+void QwOpt4048Events::onSample(sfe_opt4048_event_callback_t callback)
+{
+    _onSample = callback;
+}
+
+void QwOpt4048Events::onTooBright(sfe_opt4048_event_callback_t callback)
+{
+    _onTooBright = callback;
+}
+
+void QwOpt4048Events::onTooDim(sfe_opt4048_event_callback_t callback)
+{
+    _onTooDim = callback;
+}
+
+void QwOpt4048Events::onOverload(sfe_opt4048_event_callback_t callback)
+{
+    _onOverload = callback;
+}
+
+void QwOpt4048Events::notify()
+{
+    _pending = true;
+}
+
+bool QwOpt4048Events::service()
+{
+    if (!_pending)
+        return false;
+
+    _pending = false;
+
+    return serviceInterrupt();
+}
+
+bool QwOpt4048Events::serviceInterrupt()
+{
+    uint8_t buff[kEventReadBytes];
+
+    if (_sensor == nullptr)
+        return false;
+
+    if (_sensor->readRegisterRegion(SFE_OPT4048_REGISTER_EXP_RES_CH0, buff, kEventReadBytes) != 0)
+        return false;
+
+    _sensor->decodeImage(buff, &_color);
+
+    _flags.word = buff[SFE_OPT4048_REGISTER_FLAGS * 2] << 8;
+    _flags.word |= buff[SFE_OPT4048_REGISTER_FLAGS * 2 + 1];
+
+    if (_flags.overload_flag && _onOverload)
+        _onOverload(&_color);
+
+    if (_flags.flag_high && _onTooBright)
+        _onTooBright(&_color);
+
+    if (_flags.flag_low && _onTooDim)
+        _onTooDim(&_color);
+
+    if (_flags.conv_ready_flag && _onSample)
+        _onSample(&_color);
+
+    return true;
+}
+
+opt4048_reg_flags_t QwOpt4048Events::getLastFlags()
+{
+    return _flags;
+}
+
+void QwOpt4048Events::getLastSample(sfe_color_t *color)
+{
+    *color = _color;
+}
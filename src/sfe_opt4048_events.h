@@ -0,0 +1,115 @@
+/*
+sfe_opt4048_events.h
+
+SparkFun Tristimulus Color Sensor - OPT4048
+
+Qwiic 1x1
+* https://www.sparkfun.com/products/
+Qwiic Mini
+* https://www.sparkfun.com/products/
+
+Repository:
+* https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+The MIT License (MIT)
+
+Copyright (c) 2022 SparkFun Electronics
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions: The
+above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED
+"AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+License(http://opensource.org/licenses/MIT).
+
+The following class dispatches OPT4048 interrupts to registered callbacks.
+Each INT assertion is serviced with a single burst read of the channel data
+and the FLAGS register, and every handler receives the sample that was read
+with the flags, so no further bus access is needed to react to an event.
+
+*/
+#pragma once
+#include "sfe_opt4048.h"
+#include <stdint.h>
+
+/// @brief Event handler. Receives the sample read in the same transaction as the flags.
+typedef void (*sfe_opt4048_event_callback_t)(const sfe_color_t *color);
+
+class QwOpt4048Events
+{
+  public:
+    QwOpt4048Events()
+        : _sensor(nullptr), _onSample(nullptr), _onTooBright(nullptr), _onTooDim(nullptr), _onOverload(nullptr),
+          _pending(false)
+    {
+        _flags.word = 0;
+    };
+
+    /// @brief Attaches the sensor. Configure the interrupt mechanism, thresholds, and fault count on the
+    ///        sensor as usual; latched interrupts are recommended so that no event is lost.
+    /// @param sensor The sensor to service.
+    void begin(QwOpt4048 &sensor);
+
+    /// @brief Retrieves the sensor attached with begin().
+    /// @return The sensor, or nullptr if none is attached.
+    QwOpt4048 *getSensor();
+
+    /// @brief Registers the handler for a completed conversion (conversion ready flag).
+    /// @param callback The handler, or nullptr to remove it.
+    void onSample(sfe_opt4048_event_callback_t callback);
+
+    /// @brief Registers the handler for the threshold channel rising above the high threshold.
+    /// @param callback The handler, or nullptr to remove it.
+    void onTooBright(sfe_opt4048_event_callback_t callback);
+
+    /// @brief Registers the handler for the threshold channel falling below the low threshold.
+    /// @param callback The handler, or nullptr to remove it.
+    void onTooDim(sfe_opt4048_event_callback_t callback);
+
+    /// @brief Registers the handler for an overflow of the light measurement.
+    /// @param callback The handler, or nullptr to remove it.
+    void onOverload(sfe_opt4048_event_callback_t callback);
+
+    /// @brief Marks an interrupt as pending. Safe to call from an ISR attached to the INT pin, since
+    ///        no bus access takes place.
+    void notify();
+
+    /// @brief Services a pending interrupt marked with notify(). Call this from loop().
+    /// @return True if an interrupt was serviced.
+    bool service();
+
+    /// @brief Reads registers 0x00 to 0x0C in one burst, decodes the sample and the flags, and calls
+    ///        the handlers of every flag that is set: overload first, then too bright and too dim, then
+    ///        sample. Reading FLAGS clears latched flags and releases the INT pin.
+    /// @return True on successful execution.
+    bool serviceInterrupt();
+
+    /// @brief Retrieves the flags read by the last serviceInterrupt().
+    /// @return The flags.
+    opt4048_reg_flags_t getLastFlags();
+
+    /// @brief Retrieves the sample read by the last serviceInterrupt().
+    /// @param color Pointer to the struct to be populated.
+    void getLastSample(sfe_color_t *color);
+
+  private:
+    QwOpt4048 *_sensor;
+
+    sfe_opt4048_event_callback_t _onSample;
+    sfe_opt4048_event_callback_t _onTooBright;
+    sfe_opt4048_event_callback_t _onTooDim;
+    sfe_opt4048_event_callback_t _onOverload;
+
+    sfe_color_t _color;
+    opt4048_reg_flags_t _flags;
+    volatile bool _pending;
+};
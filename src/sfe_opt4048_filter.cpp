@@ -0,0 +1,117 @@
+/*
+sfe_opt4048_filter.cpp
+
+SparkFun Tristimulus Color Sensor - OPT4048
+
+Qwiic 1x1
+* https://www.sparkfun.com/products/
+Qwiic Mini
+* https://www.sparkfun.com/products/
+
+Repository:
+* https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+The MIT License (MIT)
+
+Copyright (c) 2022 SparkFun Electronics
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions: The
+above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED
+"AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+License(http://opensource.org/licenses/MIT).
+
+The following functions implement the integer filter stages declared in
+sfe_opt4048_filter.h.
+
+*/
+#include "sfe_opt4048_filter.h"
+
+void QwOpt4048EmaFilter::setShift(uint8_t shift)
+{
+    // Shifting a 32 bit value by 32 or more is undefined.
+    if (shift > kMaxShift)
+        shift = kMaxShift;
+
+    _shift = shift;
+}
+
+void QwOpt4048EmaFilter::update(uint32_t *codes)
+{
+    uint32_t step;
+
+    if (!_primed)
+    {
+        for (uint8_t ch = 0; ch < OPT4048_NUM_CHANNELS; ch++)
+            _state[ch] = codes[ch];
+
+        _primed = true;
+        return;
+    }
+
+    // state += (code - state) / 2^shift. A step of at least one code is taken whenever the
+    // input differs, so the state settles exactly on a constant input instead of stalling short of it.
+    for (uint8_t ch = 0; ch < OPT4048_NUM_CHANNELS; ch++)
+    {
+        if (codes[ch] >= _state[ch])
+        {
+            step = (codes[ch] - _state[ch]) >> _shift;
+            if (step == 0 && codes[ch] != _state[ch])
+                step = 1;
+            _state[ch] += step;
+        }
+        else
+        {
+            step = (_state[ch] - codes[ch]) >> _shift;
+            if (step == 0)
+                step = 1;
+            _state[ch] -= step;
+        }
+
+        codes[ch] = _state[ch];
+    }
+}
+
+void QwOpt4048EmaFilter::reset()
+{
+    _primed = false;
+}
+
+bool QwOpt4048FilterPipeline::addStage(QwOpt4048Filter &stage)
+{
+    if (_numStages >= kMaxStages)
+        return false;
+
+    _stages[_numStages++] = &stage;
+
+    return true;
+}
+
+void QwOpt4048FilterPipeline::update(sfe_color_t *color)
+{
+    uint32_t codes[OPT4048_NUM_CHANNELS] = {color->red, color->green, color->blue, color->white};
+
+    for (uint8_t i = 0; i < _numStages; i++)
+        _stages[i]->update(codes);
+
+    color->red = codes[0];
+    color->green = codes[1];
+    color->blue = codes[2];
+    color->white = codes[3];
+}
+
+void QwOpt4048FilterPipeline::reset()
+{
+    for (uint8_t i = 0; i < _numStages; i++)
+        _stages[i]->reset();
+}
@@ -0,0 +1,241 @@
+/*
+sfe_opt4048_filter.h
+
+SparkFun Tristimulus Color Sensor - OPT4048
+
+Qwiic 1x1
+* https://www.sparkfun.com/products/
+Qwiic Mini
+* https://www.sparkfun.com/products/
+
+Repository:
+* https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+The MIT License (MIT)
+
+Copyright (c) 2022 SparkFun Electronics
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions: The
+above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED
+"AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+License(http://opensource.org/licenses/MIT).
+
+The following classes implement integer smoothing filters that operate on the
+raw ADC codes of the four OPT4048 channels. Stages can be chained together with
+QwOpt4048FilterPipeline. No stage allocates memory; all state is held inside the
+object.
+
+*/
+#pragma once
+#include "sfe_opt4048.h"
+#include <stdint.h>
+#include <string.h>
+
+/// @brief Number of channels (Red, Green, Blue, White) handled by every filter stage.
+#define OPT4048_NUM_CHANNELS 4
+
+/// @brief Abstract interface for a single filter stage.
+class QwOpt4048Filter
+{
+  public:
+    /// @brief Pushes one sample through the stage. The codes are filtered in place.
+    /// @param codes Array of OPT4048_NUM_CHANNELS raw ADC codes (Red, Green, Blue, White).
+    virtual void update(uint32_t *codes) = 0;
+
+    /// @brief Discards the filter history.
+    virtual void reset() = 0;
+
+    virtual ~QwOpt4048Filter() {};
+};
+
+/// @brief Exponential moving average with alpha = 1 / 2^shift.
+class QwOpt4048EmaFilter : public QwOpt4048Filter
+{
+  public:
+    /// @brief Creates the filter.
+    /// @param shift Alpha expressed as a power of two, e.g. 3 gives alpha = 1/8.
+    QwOpt4048EmaFilter(uint8_t shift = 3) : _primed(false)
+    {
+        setShift(shift);
+    };
+
+    /// @brief Sets the smoothing factor. Larger values smooth more.
+    /// @param shift Alpha expressed as a power of two, limited to kMaxShift.
+    void setShift(uint8_t shift);
+
+    /// @brief Largest shift: a 32 bit value can't be shifted further.
+    static constexpr uint8_t kMaxShift = 31;
+
+    void update(uint32_t *codes);
+
+    void reset();
+
+  private:
+    uint8_t _shift;
+    bool _primed;
+    uint32_t _state[OPT4048_NUM_CHANNELS];
+};
+
+/// @brief Running boxcar (moving average) over the last N samples, O(1) per sample.
+/// @tparam N Window length. Limited to 16 so that the running sum of 28 bit codes fits in 32 bits.
+template <uint8_t N> class QwOpt4048BoxcarFilter : public QwOpt4048Filter
+{
+    static_assert(N > 0 && N <= 16, "Boxcar window must be between 1 and 16 samples");
+
+  public:
+    QwOpt4048BoxcarFilter()
+    {
+        reset();
+    };
+
+    void update(uint32_t *codes)
+    {
+        for (uint8_t ch = 0; ch < OPT4048_NUM_CHANNELS; ch++)
+        {
+            _sum[ch] -= _window[ch][_index];
+            _window[ch][_index] = codes[ch];
+            _sum[ch] += codes[ch];
+        }
+
+        if (_count < N)
+            _count++;
+
+        _index = (_index + 1) % N;
+
+        for (uint8_t ch = 0; ch < OPT4048_NUM_CHANNELS; ch++)
+            codes[ch] = (_sum[ch] + (_count >> 1)) / _count;
+    }
+
+    void reset()
+    {
+        memset(_window, 0, sizeof(_window));
+        memset(_sum, 0, sizeof(_sum));
+        _index = 0;
+        _count = 0;
+    }
+
+  private:
+    uint32_t _window[OPT4048_NUM_CHANNELS][N];
+    uint32_t _sum[OPT4048_NUM_CHANNELS];
+    uint8_t _index;
+    uint8_t _count;
+};
+
+/// @brief Running median over the last N samples, evaluated with a sorting network.
+/// @tparam N Window length, either 3 or 5.
+template <uint8_t N> class QwOpt4048MedianFilter : public QwOpt4048Filter
+{
+    static_assert(N == 3 || N == 5, "Median window must be 3 or 5 samples");
+
+  public:
+    QwOpt4048MedianFilter()
+    {
+        reset();
+    };
+
+    void update(uint32_t *codes)
+    {
+        uint32_t sorted[N];
+
+        // Until the window is full, repeat the newest sample so the output is still a valid code.
+        for (uint8_t ch = 0; ch < OPT4048_NUM_CHANNELS; ch++)
+        {
+            if (_count == 0)
+            {
+                for (uint8_t i = 0; i < N; i++)
+                    _window[ch][i] = codes[ch];
+            }
+            else
+                _window[ch][_index] = codes[ch];
+
+            memcpy(sorted, _window[ch], sizeof(sorted));
+            codes[ch] = median(sorted);
+        }
+
+        if (_count < N)
+            _count++;
+
+        _index = (_index + 1) % N;
+    }
+
+    void reset()
+    {
+        memset(_window, 0, sizeof(_window));
+        _index = 0;
+        _count = 0;
+    }
+
+  private:
+    static inline void sort2(uint32_t &a, uint32_t &b)
+    {
+        if (a > b)
+        {
+            uint32_t t = a;
+            a = b;
+            b = t;
+        }
+    }
+
+    // Optimal median networks: 3 compare-swaps for N = 3, 7 for N = 5.
+    static uint32_t median(uint32_t *v)
+    {
+        if (N == 3)
+        {
+            sort2(v[0], v[1]);
+            sort2(v[1], v[2]);
+            sort2(v[0], v[1]);
+            return v[1];
+        }
+
+        sort2(v[0], v[1]);
+        sort2(v[3], v[4]);
+        sort2(v[0], v[3]);
+        sort2(v[1], v[4]);
+        sort2(v[1], v[2]);
+        sort2(v[2], v[3]);
+        sort2(v[1], v[2]);
+        return v[2];
+    }
+
+    uint32_t _window[OPT4048_NUM_CHANNELS][N];
+    uint8_t _index;
+    uint8_t _count;
+};
+
+/// @brief Chains filter stages. Each sample is passed through the stages in the order they were added.
+class QwOpt4048FilterPipeline
+{
+  public:
+    QwOpt4048FilterPipeline() : _numStages(0) {};
+
+    /// @brief Appends a stage to the end of the pipeline. The stage object must outlive the pipeline.
+    /// @param stage The filter stage to add.
+    /// @return True on success, false if the pipeline is full.
+    bool addStage(QwOpt4048Filter &stage);
+
+    /// @brief Filters the Red, Green, Blue, and White codes of a sample in place. Counter and CRC
+    ///        fields are left untouched.
+    /// @param color Pointer to the sample retrieved with getAllChannelData().
+    void update(sfe_color_t *color);
+
+    /// @brief Resets every stage in the pipeline.
+    void reset();
+
+    /// @brief Maximum number of stages a pipeline can hold.
+    static constexpr uint8_t kMaxStages = 4;
+
+  private:
+    QwOpt4048Filter *_stages[kMaxStages];
+    uint8_t _numStages;
+};
@@ -0,0 +1,293 @@
+/*
+sfe_opt4048_flicker.cpp
+
+SparkFun Tristimulus Color Sensor - OPT4048
+
+Qwiic 1x1
+* https://www.sparkfun.com/products/
+Qwiic Mini
+* https://www.sparkfun.com/products/
+
+Repository:
+* https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+The MIT License (MIT)
+
+Copyright (c) 2022 SparkFun Electronics
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions: The
+above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED
+"AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+License(http://opensource.org/licenses/MIT).
+
+The following functions implement the flicker analysis mode declared in
+sfe_opt4048_flicker.h.
+
+*/
+#include "sfe_opt4048_flicker.h"
+#include <math.h>
+
+// Channel One is converted once every four channel conversions of 600us.
+static const float kNominalSampleRate = 1000000.0 / (4 * 600);
+
+// Goertzel coefficients are bounded by 2, anything larger marks a disabled bin.
+static const float kBinDisabled = 3.0;
+
+bool QwOpt4048Flicker::begin(QwOpt4048 &sensor)
+{
+    _sensor = &sensor;
+
+    if (!_sensor->setConversionTime(CONVERSION_TIME_600US))
+        return false;
+
+    if (!_sensor->setOperationMode(OPERATION_MODE_CONTINUOUS))
+        return false;
+
+    _sampleRate = kNominalSampleRate;
+    _primed = false;
+    _ready = false;
+    _haveLast = false;
+    _missedSamples = 0;
+
+    updateCoefficients();
+    resetBlock();
+
+    return true;
+}
+
+bool QwOpt4048Flicker::addFrequency(uint16_t frequency)
+{
+    if (_numBins >= kMaxBins)
+        return false;
+
+    _binFrequency[_numBins] = frequency;
+    _binAmplitude[_numBins] = 0;
+    _numBins++;
+
+    updateCoefficients();
+
+    return true;
+}
+
+bool QwOpt4048Flicker::update()
+{
+    uint32_t adcCode;
+    uint8_t counter;
+    uint8_t missed;
+    uint32_t now;
+    uint32_t period;
+    bool result = false;
+
+    if (!_sensor)
+        return false;
+
+    if (!_sensor->getChannelData(1, &adcCode, &counter))
+        return false;
+
+    now = micros();
+
+    if (_haveLast)
+    {
+        if (counter == _lastCounter)
+            return false;
+
+        // The counter is four bits wide and increments once per conversion of the channel.
+        missed = ((counter - _lastCounter) & 0x0F) - 1;
+        _missedSamples += missed;
+
+        // Missed samples are spaced one sample period apart, ending one period before this one.
+        period = _sensor->getSamplePeriodUs();
+
+        while (missed)
+        {
+            result |= addSample(_lastCode, now - missed * period);
+            missed--;
+        }
+    }
+
+    _lastCounter = counter;
+    _lastCode = adcCode;
+    _haveLast = true;
+
+    result |= addSample(adcCode, now);
+
+    return result;
+}
+
+bool QwOpt4048Flicker::addSample(uint32_t adcCode, uint32_t timestampUs)
+{
+    float centered;
+    float s0;
+
+    if (_blockCount == 0)
+    {
+        _blockStartUs = timestampUs;
+
+        // Without a previous block the first sample is the best guess of the mean.
+        if (!_primed)
+            _prevMean = adcCode;
+    }
+
+    if (adcCode < _blockMin)
+        _blockMin = adcCode;
+    if (adcCode > _blockMax)
+        _blockMax = adcCode;
+
+    // Sums of codes up to 2^28 over a block need more than the 24 bit mantissa of a float.
+    _blockSum += adcCode;
+
+    // The mean of the previous block is used so the flicker index and the Goertzel filters can be
+    // updated one sample at a time without storing the block.
+    if (adcCode > _prevMean)
+        _blockAbove += adcCode - _prevMean;
+
+    centered = (float)((int32_t)(adcCode - _prevMean));
+
+    for (uint8_t i = 0; i < _numBins; i++)
+    {
+        if (_binCoeff[i] > 2)
+            continue;
+
+        s0 = centered + _binCoeff[i] * _binS1[i] - _binS2[i];
+        _binS2[i] = _binS1[i];
+        _binS1[i] = s0;
+    }
+
+    _lastTimeUs = timestampUs;
+    _blockCount++;
+
+    if (_blockCount < kBlockSize)
+        return false;
+
+    finishBlock();
+
+    return _ready;
+}
+
+void QwOpt4048Flicker::finishBlock()
+{
+    uint32_t mean = (_blockSum + _blockCount / 2) / _blockCount;
+    float power;
+    float best = 0;
+
+    if (_blockMax + _blockMin > 0)
+        _percentFlicker = 100.0 * (float)(_blockMax - _blockMin) / (float)(_blockMax + _blockMin);
+    else
+        _percentFlicker = 0;
+
+    _flickerIndex = (_blockSum > 0) ? (float)_blockAbove / (float)_blockSum : 0;
+
+    _dominantFrequency = 0;
+
+    for (uint8_t i = 0; i < _numBins; i++)
+    {
+        if (_binCoeff[i] > 2 || mean == 0)
+        {
+            _binAmplitude[i] = 0;
+            continue;
+        }
+
+        power = _binS1[i] * _binS1[i] + _binS2[i] * _binS2[i] - _binCoeff[i] * _binS1[i] * _binS2[i];
+        if (power < 0)
+            power = 0;
+
+        // Amplitude of the sine component, relative to the mean level.
+        _binAmplitude[i] = 2.0 * sqrt(power) / _blockCount / (float)mean;
+
+        if (_binAmplitude[i] > best)
+        {
+            best = _binAmplitude[i];
+            _dominantFrequency = _binFrequency[i];
+        }
+    }
+
+    if (_lastTimeUs != _blockStartUs)
+        _sampleRate = (_blockCount - 1) * 1000000.0 / (float)(_lastTimeUs - _blockStartUs);
+
+    _prevMean = mean;
+    _ready = _primed;
+    _primed = true;
+
+    // The next block uses coefficients for the rate that was just measured.
+    updateCoefficients();
+    resetBlock();
+}
+
+void QwOpt4048Flicker::updateCoefficients()
+{
+    float rate = (_sampleRate > 0) ? _sampleRate : kNominalSampleRate;
+
+    for (uint8_t i = 0; i < _numBins; i++)
+    {
+        if (_binFrequency[i] * 2 >= rate)
+            _binCoeff[i] = kBinDisabled;
+        else
+            _binCoeff[i] = 2.0 * cos(2.0 * M_PI * _binFrequency[i] / rate);
+    }
+}
+
+void QwOpt4048Flicker::resetBlock()
+{
+    _blockCount = 0;
+    _blockMin = 0xFFFFFFFF;
+    _blockMax = 0;
+    _blockSum = 0;
+    _blockAbove = 0;
+    _blockStartUs = 0;
+
+    for (uint8_t i = 0; i < kMaxBins; i++)
+    {
+        _binS1[i] = 0;
+        _binS2[i] = 0;
+    }
+}
+
+bool QwOpt4048Flicker::available()
+{
+    return _ready;
+}
+
+float QwOpt4048Flicker::getPercentFlicker()
+{
+    _ready = false;
+    return _percentFlicker;
+}
+
+float QwOpt4048Flicker::getFlickerIndex()
+{
+    return _flickerIndex;
+}
+
+uint16_t QwOpt4048Flicker::getDominantFrequency()
+{
+    return _dominantFrequency;
+}
+
+float QwOpt4048Flicker::getBinAmplitude(uint8_t bin)
+{
+    if (bin >= _numBins)
+        return 0;
+
+    return _binAmplitude[bin];
+}
+
+float QwOpt4048Flicker::getSampleRate()
+{
+    return _sampleRate;
+}
+
+uint32_t QwOpt4048Flicker::getMissedSamples()
+{
+    return _missedSamples;
+}
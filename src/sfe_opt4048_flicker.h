@@ -0,0 +1,154 @@
+/*
+sfe_opt4048_flicker.h
+
+SparkFun Tristimulus Color Sensor - OPT4048
+
+Qwiic 1x1
+* https://www.sparkfun.com/products/
+Qwiic Mini
+* https://www.sparkfun.com/products/
+
+Repository:
+* https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+The MIT License (MIT)
+
+Copyright (c) 2022 SparkFun Electronics
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions: The
+above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED
+"AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+License(http://opensource.org/licenses/MIT).
+
+The following class implements a flicker analysis mode for the OPT4048. Channel
+One is streamed at the fastest conversion time and percent flicker, flicker
+index, and the dominant flicker frequency are calculated block by block with
+Goertzel filters. All state lives in a fixed size object; no sample history is
+stored.
+
+*/
+#pragma once
+#include "sfe_opt4048.h"
+#include <stdint.h>
+
+class QwOpt4048Flicker
+{
+  public:
+    QwOpt4048Flicker()
+        : _sensor(nullptr), _numBins(0), _sampleRate(0), _prevMean(0), _primed(false), _ready(false),
+          _percentFlicker(0), _flickerIndex(0), _dominantFrequency(0), _lastTimeUs(0), _lastCounter(0),
+          _lastCode(0), _haveLast(false), _missedSamples(0)
+    {
+        resetBlock();
+    };
+
+    /// @brief Attaches the sensor and configures it for the fastest continuous conversion. The
+    ///        OPT4048 converts its four channels in turn, so Channel One is refreshed every
+    ///        4 x 600us = 2.4ms, which gives a sample rate of about 416Hz.
+    /// @param sensor The sensor to stream from. The range setting is left as is.
+    /// @return True on successful execution.
+    bool begin(QwOpt4048 &sensor);
+
+    /// @brief Adds a frequency to be tracked with its own Goertzel filter, e.g. 100 or 120 for mains
+    ///        flicker. Frequencies at or above half the sample rate are ignored.
+    /// @param frequency The frequency in Hz.
+    /// @return True on success, false if all bins are in use.
+    bool addFrequency(uint16_t frequency);
+
+    /// @brief Polls Channel One once. Call this as often as possible from loop(); each call is a single
+    ///        4 byte read, and a new sample is only taken when the channel counter has advanced.
+    /// @return True when a block has completed and new results are available.
+    bool update();
+
+    /// @brief Feeds one Channel One sample into the analysis. Used by update(), but can also be called
+    ///        directly with codes acquired elsewhere.
+    /// @param adcCode The Channel One ADC code.
+    /// @param timestampUs The time the sample was taken, in microseconds.
+    /// @return True when a block has completed and new results are available.
+    bool addSample(uint32_t adcCode, uint32_t timestampUs);
+
+    /// @brief Checks if results are available. Results are cleared by reading the percent flicker.
+    /// @return True if a block has completed since the last call to getPercentFlicker().
+    bool available();
+
+    /// @brief Retrieves the percent flicker (modulation depth) of the last block: 100 * (max - min) / (max + min).
+    /// @return Percent flicker, 0 to 100.
+    float getPercentFlicker();
+
+    /// @brief Retrieves the flicker index of the last block: the area above the mean divided by the total area.
+    /// @return Flicker index, 0 to 1.
+    float getFlickerIndex();
+
+    /// @brief Retrieves the tracked frequency with the largest amplitude in the last block.
+    /// @return The dominant frequency in Hz, 0 if no frequencies are tracked.
+    uint16_t getDominantFrequency();
+
+    /// @brief Retrieves the amplitude of a tracked frequency relative to the mean light level.
+    /// @param bin Index of the frequency, in the order it was added.
+    /// @return The relative amplitude, e.g. 0.1 for a 10% sine modulation.
+    float getBinAmplitude(uint8_t bin);
+
+    /// @brief Retrieves the sample rate measured from the timestamps of the last block.
+    /// @return The sample rate in Hz.
+    float getSampleRate();
+
+    /// @brief Retrieves the number of samples that were missed because update() was not called often enough.
+    ///        Missed samples are filled with the previous value, one sample period apart, to keep the sample
+    ///        spacing uniform.
+    /// @return Number of samples missed since begin().
+    uint32_t getMissedSamples();
+
+    /// @brief Number of samples in each analysis block. At 416Hz this is about 0.6 seconds, or 1.6Hz resolution.
+    static constexpr uint16_t kBlockSize = 256;
+
+    /// @brief Maximum number of frequencies that can be tracked.
+    static constexpr uint8_t kMaxBins = 6;
+
+  private:
+    void resetBlock();
+    void finishBlock();
+    void updateCoefficients();
+
+    QwOpt4048 *_sensor;
+
+    uint16_t _binFrequency[kMaxBins];
+    float _binCoeff[kMaxBins];
+    float _binS1[kMaxBins];
+    float _binS2[kMaxBins];
+    float _binAmplitude[kMaxBins];
+    uint8_t _numBins;
+
+    // Running block state
+    uint16_t _blockCount;
+    uint32_t _blockMin;
+    uint32_t _blockMax;
+    uint64_t _blockSum;
+    uint64_t _blockAbove;
+    uint32_t _blockStartUs;
+
+    float _sampleRate;
+    uint32_t _prevMean;
+    bool _primed;
+    bool _ready;
+
+    float _percentFlicker;
+    float _flickerIndex;
+    uint16_t _dominantFrequency;
+
+    uint32_t _lastTimeUs;
+    uint8_t _lastCounter;
+    uint32_t _lastCode;
+    bool _haveLast;
+    uint32_t _missedSamples;
+};
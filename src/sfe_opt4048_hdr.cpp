@@ -0,0 +1,249 @@
+/*
+sfe_opt4048_hdr.cpp
+
+SparkFun Tristimulus Color Sensor - OPT4048
+
+Qwiic 1x1
+* https://www.sparkfun.com/products/
+Qwiic Mini
+* https://www.sparkfun.com/products/
+
+Repository:
+* https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+The MIT License (MIT)
+
+Copyright (c) 2022 SparkFun Electronics
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions: The
+above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED
+"AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+License(http://opensource.org/licenses/MIT).
+
+The following functions implement the bracketed acquisition declared in
+sfe_opt4048_hdr.h.
+
+*/
+#include "sfe_opt4048_hdr.h"
+
+// Channel data (0x00 - 0x07) through FLAGS (0x0C): 13 registers.
+#define kHdrReadBytes ((SFE_OPT4048_REGISTER_FLAGS + 1) * 2)
+
+// Reads of a conversion that is not ready yet, before the reading is given up.
+#define kHdrReadAttempts 4
+
+// A mantissa of 2^20 is full scale. Readings within kHdrTaperSteps << kHdrTaperShift codes of it are
+// weighted down step by step, and the last step counts as saturated.
+#define kHdrFullScale 0x100000UL
+#define kHdrTaperShift 12
+#define kHdrTaperSteps 16
+
+// Exponents above this get the lowest weight. Each exponent step doubles the quantization step, so
+// the weight, the inverse of the quantization variance, falls by four.
+#define kHdrMaxExponent 8
+
+bool QwOpt4048Hdr::begin(QwOpt4048 &sensor, const opt4048_range_t *ranges, uint8_t numRanges)
+{
+    uint8_t buff[2];
+
+    if (numRanges == 0 || numRanges > kMaxRanges)
+        return false;
+
+    for (uint8_t i = 0; i < numRanges; i++)
+    {
+        if (ranges[i] > RANGE_144LUX)
+            return false;
+
+        _ranges[i] = ranges[i];
+    }
+
+    // Brings the sensor's CONTROL shadow in step with the device. Readings keep the other settings
+    // of the shadow, so every reading is a single write.
+    if (sensor.readRegisterRegion(SFE_OPT4048_REGISTER_CONTROL, buff) != 0)
+        return false;
+
+    _sensor = &sensor;
+    _numRanges = numRanges;
+    _startControl = buff[0] << 8;
+    _startControl |= buff[1];
+
+    return true;
+}
+
+bool QwOpt4048Hdr::end()
+{
+    uint8_t buff[2];
+    opt4048_reg_control_t controlReg;
+    opt4048_reg_control_t startReg;
+
+    if (_sensor == nullptr)
+        return false;
+
+    controlReg.word = _sensor->getControlShadow();
+    startReg.word = _startControl;
+    controlReg.range = startReg.range;
+    controlReg.op_mode = startReg.op_mode;
+
+    buff[0] = controlReg.word >> 8;
+    buff[1] = controlReg.word;
+
+    return _sensor->writeRegisterRegion(SFE_OPT4048_REGISTER_CONTROL, buff) == 0;
+}
+
+bool QwOpt4048Hdr::read(uint8_t range, uint8_t *image)
+{
+    uint8_t buff[2];
+    uint32_t period;
+    uint32_t due;
+    int32_t remaining;
+    opt4048_reg_control_t controlReg;
+    opt4048_reg_flags_t flagReg;
+
+    controlReg.word = _sensor->getControlShadow();
+    controlReg.range = range;
+    controlReg.op_mode = OPERATION_MODE_ONE_SHOT;
+
+    buff[0] = controlReg.word >> 8;
+    buff[1] = controlReg.word;
+
+    // Selects the range and starts the conversion.
+    if (_sensor->writeRegisterRegion(SFE_OPT4048_REGISTER_CONTROL, buff) != 0)
+        return false;
+
+    // 1/32 of a period of margin for a slow oscillator, as in waitForSample().
+    period = _sensor->getSamplePeriodUs();
+    due = _sensor->getSampleDueMicros() + (period >> 5);
+
+    for (uint8_t attempt = 0; attempt < kHdrReadAttempts; attempt++)
+    {
+        remaining = (int32_t)(due - micros());
+
+        if (remaining > 0)
+        {
+            if (remaining >= 1000)
+                delay(remaining / 1000);
+
+            delayMicroseconds(remaining % 1000);
+        }
+
+        if (_sensor->readRegisterRegion(SFE_OPT4048_REGISTER_EXP_RES_CH0, image, kHdrReadBytes) != 0)
+            return false;
+
+        flagReg.word = image[SFE_OPT4048_REGISTER_FLAGS * 2] << 8;
+        flagReg.word |= image[SFE_OPT4048_REGISTER_FLAGS * 2 + 1];
+
+        if (flagReg.conv_ready_flag)
+            return true;
+
+        due = micros() + (period >> 4);
+    }
+
+    return false;
+}
+
+bool QwOpt4048Hdr::capture(sfe_opt4048_hdr_sample_t *sample)
+{
+    uint8_t image[kHdrReadBytes];
+    uint64_t sums[4] = {0, 0, 0, 0};
+    uint32_t weights[4] = {0, 0, 0, 0};
+    uint32_t fallback[4] = {0, 0, 0, 0};
+    uint8_t fallbackExponent[4] = {0, 0, 0, 0};
+    uint32_t *channels[4] = {&sample->color.red, &sample->color.green, &sample->color.blue, &sample->color.white};
+    uint32_t mantissa;
+    uint32_t code;
+    uint32_t taper;
+    uint32_t weight;
+    uint8_t exponent;
+    uint8_t counter;
+    uint8_t crc;
+
+    if (_sensor == nullptr)
+        return false;
+
+    sample->readings = 0;
+
+    for (uint8_t i = 0; i < _numRanges; i++)
+    {
+        if (!read(_ranges[i], image))
+            continue;
+
+        for (uint8_t channel = 0; channel < 4; channel++)
+        {
+            opt4048DecodeChannel(&image[channel * 4], &mantissa, &exponent, &counter, &crc);
+
+            code = _sensor->applyDarkOffset(channel, mantissa, exponent);
+
+            taper = (kHdrFullScale - mantissa) >> kHdrTaperShift;
+            if (taper > kHdrTaperSteps)
+                taper = kHdrTaperSteps;
+
+            if (exponent > kHdrMaxExponent)
+                exponent = kHdrMaxExponent;
+
+            weight = taper << (2 * (kHdrMaxExponent - exponent));
+
+            sums[channel] += (uint64_t)code * weight;
+            weights[channel] += weight;
+
+            // Used if the channel saturates in every range.
+            if (sample->readings == 0 || exponent >= fallbackExponent[channel])
+            {
+                fallback[channel] = code;
+                fallbackExponent[channel] = exponent;
+            }
+        }
+
+        sample->readings++;
+    }
+
+    if (sample->readings == 0)
+        return false;
+
+    sample->saturated = 0;
+
+    for (uint8_t channel = 0; channel < 4; channel++)
+    {
+        if (weights[channel] == 0)
+        {
+            *channels[channel] = fallback[channel];
+            sample->saturated |= 1 << channel;
+        }
+        else
+            *channels[channel] = (uint32_t)((sums[channel] + weights[channel] / 2) / weights[channel]);
+    }
+
+    sample->color.counterR = 0;
+    sample->color.counterG = 0;
+    sample->color.counterB = 0;
+    sample->color.counterW = 0;
+    sample->color.CRCR = 0;
+    sample->color.CRCG = 0;
+    sample->color.CRCB = 0;
+    sample->color.CRCW = 0;
+
+    return true;
+}
+
+uint8_t QwOpt4048Hdr::getNumRanges()
+{
+    return _numRanges;
+}
+
+uint32_t QwOpt4048Hdr::getBracketPeriodUs()
+{
+    if (_sensor == nullptr)
+        return 0;
+
+    return _numRanges * _sensor->getSamplePeriodUs();
+}
@@ -0,0 +1,100 @@
+/*
+sfe_opt4048_hdr.h
+
+SparkFun Tristimulus Color Sensor - OPT4048
+
+Qwiic 1x1
+* https://www.sparkfun.com/products/
+Qwiic Mini
+* https://www.sparkfun.com/products/
+
+Repository:
+* https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+The MIT License (MIT)
+
+Copyright (c) 2022 SparkFun Electronics
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions: The
+above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED
+"AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+License(http://opensource.org/licenses/MIT).
+
+The following class extends the dynamic range of the OPT4048 beyond a single
+range setting. It takes a bracket of one-shot readings in a fixed set of
+ranges and merges them into one value per channel, weighting each reading by
+the resolution of its exponent and tapering it off as its mantissa approaches
+full scale. Unlike RANGE_AUTO, every merged value is built from the same
+ranges, so consecutive values are comparable. Each reading costs one CONTROL
+write, which selects the range and starts the conversion, and one burst read
+of the results and flags.
+
+*/
+#pragma once
+#include "sfe_opt4048.h"
+#include <stdint.h>
+
+/// @brief A merged bracket.
+typedef struct
+{
+    sfe_color_t color; // Merged ADC codes, on the common scale of all ranges. Counters and CRCs are zero.
+    uint8_t saturated; // Bit mask of channels saturated in every range, bit 0 for Channel Zero
+    uint8_t readings;  // Readings merged, getNumRanges() unless a conversion was missed
+
+} sfe_opt4048_hdr_sample_t;
+
+class QwOpt4048Hdr
+{
+  public:
+    QwOpt4048Hdr() : _sensor(nullptr), _numRanges(0), _startControl(0) {};
+
+    /// @brief Sets up bracketed acquisition. The sensor's INT pin must not be configured as an input.
+    ///        Readings keep the sensor's other CONTROL settings as last written, so they can be changed
+    ///        between brackets.
+    /// @param sensor The sensor, already started with begin(). It must outlive this object.
+    /// @param ranges The ranges of a bracket, in the order they are taken. RANGE_AUTO is not allowed.
+    /// @param numRanges Number of ranges, 1 to kMaxRanges.
+    /// @return True on success, false on a bad argument or bus error.
+    bool begin(QwOpt4048 &sensor, const opt4048_range_t *ranges, uint8_t numRanges);
+
+    /// @brief Takes one reading in every range of the bracket and merges them. Blocks for about
+    ///        getBracketPeriodUs(). Afterwards the sensor is powered down in the last range of the
+    ///        bracket; see end().
+    /// @param sample Pointer to the struct to be populated.
+    /// @return True on success, false if no reading of the bracket succeeded.
+    bool capture(sfe_opt4048_hdr_sample_t *sample);
+
+    /// @brief Restores the range and operation mode the sensor had at begin(), e.g. to resume
+    ///        continuous conversions. Other CONTROL settings changed since are kept.
+    /// @return True on success, false on a bus error or without begin().
+    bool end();
+
+    /// @brief Retrieves the number of ranges in a bracket.
+    uint8_t getNumRanges();
+
+    /// @brief Retrieves the nominal duration of a bracket, without bus transfers.
+    /// @return The duration in microseconds.
+    uint32_t getBracketPeriodUs();
+
+    /// @brief Maximum number of ranges in a bracket.
+    static constexpr uint8_t kMaxRanges = 7;
+
+  private:
+    bool read(uint8_t range, uint8_t *image);
+
+    QwOpt4048 *_sensor;
+    opt4048_range_t _ranges[kMaxRanges];
+    uint8_t _numRanges;
+    uint16_t _startControl;
+};
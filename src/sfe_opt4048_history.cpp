@@ -0,0 +1,281 @@
+/*
+sfe_opt4048_history.cpp
+
+SparkFun Tristimulus Color Sensor - OPT4048
+
+Qwiic 1x1
+* https://www.sparkfun.com/products/
+Qwiic Mini
+* https://www.sparkfun.com/products/
+
+Repository:
+* https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+The MIT License (MIT)
+
+Copyright (c) 2022 SparkFun Electronics
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions: The
+above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED
+"AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+License(http://opensource.org/licenses/MIT).
+
+The following functions implement the delta encoded sample history declared
+in sfe_opt4048_history.h.
+
+Encoded sample layout:
+    byte 0      bit 7 exponents follow, bits 6:5 delta width, bits 3:0 Channel Zero counter
+    exponents   only if bit 7 is set: low nibble is a mask of the channels whose exponent changed,
+                high nibble and any following bytes hold the new exponents, two per byte
+    deltas      the zig-zag encoded mantissa change of each channel, in the width given by bits 6:5:
+                0 - all zero, no bytes, 1 - four nibbles in two bytes, 2 - one byte each,
+                3 - varints, 7 bits per byte, low bits first, up to 5 bytes for a 32 bit change
+
+*/
+#include "sfe_opt4048_history.h"
+#include <string.h>
+
+void QwOpt4048History::split(uint32_t code, uint32_t *mantissa, uint8_t *exponent)
+{
+    uint8_t expon = 0;
+
+    // The smallest exponent that fits the mantissa in 20 bits, but only while the shifted out bits are
+    // zero. A raw code, mantissa << exponent, splits back into its register fields; a code from a filter
+    // or after dark subtraction keeps its low bits in a wider mantissa, so every code is stored exactly.
+    while (code >= (1UL << 20) && !(code & 1))
+    {
+        code >>= 1;
+        expon++;
+    }
+
+    *mantissa = code;
+    *exponent = expon;
+}
+
+bool QwOpt4048History::add(const sfe_color_t *color)
+{
+    uint8_t sample[kMaxSampleSize];
+    uint8_t length = 1;
+    uint32_t codes[4] = {color->red, color->green, color->blue, color->white};
+    uint32_t mantissa[4];
+    uint8_t exponent[4];
+    uint32_t zigzag[4];
+    uint32_t largest = 0;
+    uint8_t changed = 0;
+    uint8_t nibble = 1;
+    uint8_t width;
+    int32_t delta;
+
+    for (uint8_t ch = 0; ch < 4; ch++)
+    {
+        split(codes[ch], &mantissa[ch], &exponent[ch]);
+
+        if (exponent[ch] != _writeState.exponent[ch])
+            changed |= 1 << ch;
+
+        delta = (int32_t)(mantissa[ch] - _writeState.mantissa[ch]);
+        zigzag[ch] = ((uint32_t)delta << 1) ^ (uint32_t)(delta >> 31);
+
+        if (zigzag[ch] > largest)
+            largest = zigzag[ch];
+    }
+
+    if (changed)
+    {
+        // The mask takes the low nibble of the first byte, exponents fill the nibbles after it.
+        sample[length] = changed;
+
+        for (uint8_t ch = 0; ch < 4; ch++)
+        {
+            if (!(changed & (1 << ch)))
+                continue;
+
+            if (nibble & 1)
+                sample[length++] |= exponent[ch] << 4;
+            else
+                sample[length] = exponent[ch];
+            nibble++;
+        }
+
+        if (nibble & 1)
+            length++;
+    }
+
+    if (largest == 0)
+        width = kDeltaZero;
+    else if (largest < 0x10)
+        width = kDeltaNibble;
+    else if (largest < 0x100)
+        width = kDeltaByte;
+    else
+        width = kDeltaVarint;
+
+    sample[0] = (changed ? 0x80 : 0) | (width << 5) | (color->counterR & 0x0F);
+
+    for (uint8_t ch = 0; ch < 4; ch++)
+    {
+        if (width == kDeltaNibble)
+        {
+            if (ch & 1)
+                sample[length++] |= zigzag[ch] << 4;
+            else
+                sample[length] = zigzag[ch];
+        }
+        else if (width == kDeltaByte)
+            sample[length++] = zigzag[ch];
+        else if (width == kDeltaVarint)
+        {
+            while (zigzag[ch] >= 0x80)
+            {
+                sample[length++] = (zigzag[ch] & 0x7F) | 0x80;
+                zigzag[ch] >>= 7;
+            }
+            sample[length++] = zigzag[ch];
+        }
+    }
+
+    if (_used + length > _size)
+        return false;
+
+    memcpy(&_buffer[_used], sample, length);
+    _used += length;
+    _count++;
+
+    memcpy(_writeState.mantissa, mantissa, sizeof(mantissa));
+    memcpy(_writeState.exponent, exponent, sizeof(exponent));
+
+    return true;
+}
+
+void QwOpt4048History::rewind()
+{
+    _readPos = 0;
+    _readCount = 0;
+    memset(&_readState, 0, sizeof(_readState));
+}
+
+bool QwOpt4048History::next(sfe_color_t *color)
+{
+    uint8_t header;
+    uint8_t changed;
+    uint8_t nibble = 1;
+    uint8_t width;
+    uint32_t zigzag;
+    uint8_t shift;
+    uint8_t byte;
+    uint32_t codes[4];
+
+    if (_readCount >= _count)
+        return false;
+
+    header = _buffer[_readPos++];
+
+    if (header & 0x80)
+    {
+        changed = _buffer[_readPos] & 0x0F;
+
+        for (uint8_t ch = 0; ch < 4; ch++)
+        {
+            if (!(changed & (1 << ch)))
+                continue;
+
+            if (nibble & 1)
+                _readState.exponent[ch] = _buffer[_readPos++] >> 4;
+            else
+                _readState.exponent[ch] = _buffer[_readPos] & 0x0F;
+            nibble++;
+        }
+
+        if (nibble & 1)
+            _readPos++;
+    }
+
+    width = (header >> 5) & 0x03;
+
+    for (uint8_t ch = 0; ch < 4; ch++)
+    {
+        zigzag = 0;
+
+        if (width == kDeltaNibble)
+        {
+            if (ch & 1)
+                zigzag = _buffer[_readPos++] >> 4;
+            else
+                zigzag = _buffer[_readPos] & 0x0F;
+        }
+        else if (width == kDeltaByte)
+            zigzag = _buffer[_readPos++];
+        else if (width == kDeltaVarint)
+        {
+            shift = 0;
+
+            do
+            {
+                byte = _buffer[_readPos++];
+                zigzag |= (uint32_t)(byte & 0x7F) << shift;
+                shift += 7;
+            } while (byte & 0x80);
+        }
+
+        _readState.mantissa[ch] += (zigzag >> 1) ^ (0 - (zigzag & 1));
+        codes[ch] = _readState.mantissa[ch] << _readState.exponent[ch];
+    }
+
+    memset(color, 0, sizeof(*color));
+    color->red = codes[0];
+    color->green = codes[1];
+    color->blue = codes[2];
+    color->white = codes[3];
+    color->counterR = header & 0x0F;
+
+    _readCount++;
+
+    return true;
+}
+
+void QwOpt4048History::clear()
+{
+    _used = 0;
+    _count = 0;
+    memset(&_writeState, 0, sizeof(_writeState));
+    rewind();
+}
+
+bool QwOpt4048History::isFull()
+{
+    return (_size - _used) < kMaxSampleSize;
+}
+
+uint16_t QwOpt4048History::getCount()
+{
+    return _count;
+}
+
+uint16_t QwOpt4048History::getBytesUsed()
+{
+    return _used;
+}
+
+uint16_t QwOpt4048History::getCapacity()
+{
+    return _size;
+}
+
+float QwOpt4048History::getCompressionRatio()
+{
+    if (_used == 0)
+        return 0;
+
+    return (float)_count * sizeof(sfe_color_t) / _used;
+}
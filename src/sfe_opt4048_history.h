@@ -0,0 +1,132 @@
+/*
+sfe_opt4048_history.h
+
+SparkFun Tristimulus Color Sensor - OPT4048
+
+Qwiic 1x1
+* https://www.sparkfun.com/products/
+Qwiic Mini
+* https://www.sparkfun.com/products/
+
+Repository:
+* https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+The MIT License (MIT)
+
+Copyright (c) 2022 SparkFun Electronics
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions: The
+above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED
+"AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+License(http://opensource.org/licenses/MIT).
+
+The following class stores a history of samples in a fixed number of bytes
+by encoding each sample as the change from the one before it. Each channel is
+split into its 20 bit mantissa and 4 bit exponent; codes that are not a
+mantissa shifted left, e.g. from the filters or after dark subtraction, keep
+their low bits in a wider mantissa, so every code is stored exactly. Exponents
+are only stored when they change, and the four mantissa changes are zig-zag
+encoded in the narrowest width that fits all of them: nothing, a nibble, a
+byte, or a varint. A steady light with a few codes of noise takes 3 bytes per
+sample instead of the 24 of sfe_color_t.
+
+*/
+#pragma once
+#include "sfe_opt4048_decode.h"
+#include <stdint.h>
+
+class QwOpt4048History
+{
+  public:
+    /// @brief Creates a history in a buffer provided by the caller.
+    /// @param buffer The memory to store the encoded samples in.
+    /// @param size Size of the buffer in bytes.
+    QwOpt4048History(uint8_t *buffer, uint16_t size) : _buffer(buffer), _size(size)
+    {
+        clear();
+    };
+
+    /// @brief Appends a sample. Only the Red, Green, Blue, and White values and the Channel Zero
+    ///        counter are kept.
+    /// @param color Pointer to the sample to store.
+    /// @return True on success, false if the sample does not fit in the remaining space.
+    bool add(const sfe_color_t *color);
+
+    /// @brief Restarts sequential reading at the oldest sample.
+    void rewind();
+
+    /// @brief Decodes the next sample. Counters other than counterR, and the CRC fields, are set to zero.
+    /// @param color Pointer to the struct to be populated.
+    /// @return True if a sample was read, false when all samples have been read.
+    bool next(sfe_color_t *color);
+
+    /// @brief Discards all samples.
+    void clear();
+
+    /// @brief Checks if the history is full. A sample needs between 1 and 24 bytes.
+    /// @return True if fewer than the maximum size of one sample remain.
+    bool isFull();
+
+    /// @brief Retrieves the number of stored samples.
+    uint16_t getCount();
+
+    /// @brief Retrieves the number of bytes used.
+    uint16_t getBytesUsed();
+
+    /// @brief Retrieves the size of the buffer in bytes.
+    uint16_t getCapacity();
+
+    /// @brief Retrieves the compression ratio, the size of the samples as sfe_color_t structs
+    ///        divided by the bytes used.
+    /// @return The compression ratio, 0 if the history is empty.
+    float getCompressionRatio();
+
+    /// @brief Largest encoded size of one sample: header, three exponent bytes, and four 5 byte varints.
+    static constexpr uint8_t kMaxSampleSize = 24;
+
+  private:
+    // Width of the mantissa deltas, bits 6:5 of the sample header.
+    static constexpr uint8_t kDeltaZero = 0;
+    static constexpr uint8_t kDeltaNibble = 1;
+    static constexpr uint8_t kDeltaByte = 2;
+    static constexpr uint8_t kDeltaVarint = 3;
+
+    // Encoder and decoder each keep the previous sample to apply deltas against.
+    struct ChannelState
+    {
+        uint32_t mantissa[4];
+        uint8_t exponent[4];
+    };
+
+    static void split(uint32_t code, uint32_t *mantissa, uint8_t *exponent);
+
+    uint8_t *_buffer;
+    uint16_t _size;
+    uint16_t _used;
+    uint16_t _count;
+    uint16_t _readPos;
+    uint16_t _readCount;
+    ChannelState _writeState;
+    ChannelState _readState;
+};
+
+/// @brief QwOpt4048History with its own storage of N bytes.
+template <uint16_t N> class QwOpt4048HistoryBuffer : public QwOpt4048History
+{
+  public:
+    QwOpt4048HistoryBuffer() : QwOpt4048History(_storage, N) {};
+
+  private:
+    uint8_t _storage[N];
+};
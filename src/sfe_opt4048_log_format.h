@@ -0,0 +1,114 @@
+/*
+sfe_opt4048_log_format.h
+
+SparkFun Tristimulus Color Sensor - OPT4048
+
+Qwiic 1x1
+* https://www.sparkfun.com/products/
+Qwiic Mini
+* https://www.sparkfun.com/products/
+
+Repository:
+* https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+The MIT License (MIT)
+
+Copyright (c) 2022 SparkFun Electronics
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions: The
+above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED
+"AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+License(http://opensource.org/licenses/MIT).
+
+The following file defines the binary sample log format written by
+QwOpt4048Logger. It has no Arduino dependencies so that host side tools can
+include it directly.
+
+A log starts with one 512 byte header sector followed by 512 byte sectors of
+sixteen 32 byte records. Multi-byte fields are little-endian. The register
+image holds the bytes of registers 0x00 to 0x07 exactly as read from the bus
+(big-endian, two bytes per register).
+
+*/
+#pragma once
+#include <stdint.h>
+
+#define OPT4048_LOG_MAGIC "OPT4048L"
+#define OPT4048_LOG_VERSION 1
+#define OPT4048_LOG_SECTOR_SIZE 512
+#define OPT4048_LOG_RECORD_SIZE 32
+#define OPT4048_LOG_RECORDS_PER_SECTOR (OPT4048_LOG_SECTOR_SIZE / OPT4048_LOG_RECORD_SIZE)
+
+/// @brief Marker of a valid record. Padding records written by a final flush are all zeros.
+#define OPT4048_LOG_RECORD_MARKER 0x4F
+
+/// @brief Status bits that can be attached to a record.
+#define OPT4048_LOG_STATUS_CRC_ERROR 0x01
+
+/// @brief Header sector at the start of every log.
+typedef struct
+{
+    char magic[8];          // OPT4048_LOG_MAGIC, not null terminated
+    uint16_t version;       // OPT4048_LOG_VERSION
+    uint16_t headerSize;    // OPT4048_LOG_SECTOR_SIZE
+    uint16_t recordSize;    // OPT4048_LOG_RECORD_SIZE
+    uint16_t deviceId;      // Device ID read at start of logging
+    uint8_t i2cAddress;     // I2C address of the sensor
+    uint8_t reserved0;
+    uint16_t control;       // CONTROL register (0x0A) at start of logging
+    uint16_t intControl;    // INT_CONTROL register (0x0B) at start of logging
+    uint16_t reserved1;
+    uint32_t startMicros;   // micros() when the header was written
+    uint32_t startMillis;   // millis() when the header was written
+    uint8_t reserved2[478];
+    uint16_t checksum;      // opt4048LogChecksum() of the preceding 510 bytes
+
+} sfe_opt4048_log_header_t;
+
+/// @brief One logged sample.
+typedef struct
+{
+    uint32_t timestampUs;   // micros() when the sample was read, wraps every ~71 minutes
+    uint8_t image[16];      // Registers 0x00 - 0x07 as read from the bus
+    uint16_t control;       // CONTROL register (0x0A) when the sample was read
+    uint16_t flags;         // FLAGS register (0x0C) when the sample was read
+    uint16_t sequence;      // Incremented for every sample, including samples dropped on overrun
+    uint8_t marker;         // OPT4048_LOG_RECORD_MARKER
+    uint8_t status;         // OPT4048_LOG_STATUS_* bits
+    uint16_t reserved;
+    uint16_t checksum;      // opt4048LogChecksum() of the preceding 30 bytes
+
+} sfe_opt4048_log_record_t;
+
+static_assert(sizeof(sfe_opt4048_log_header_t) == OPT4048_LOG_SECTOR_SIZE, "Log header must fill one sector");
+static_assert(sizeof(sfe_opt4048_log_record_t) == OPT4048_LOG_RECORD_SIZE, "Unexpected log record size");
+
+/// @brief Fletcher-16 checksum used for log headers and records. The modulo is deferred to the end,
+///        which is exact for lengths up to 5802 bytes and keeps the per-byte cost to two additions.
+/// @param data Pointer to the bytes to check.
+/// @param length Number of bytes, at most 5802.
+/// @return The checksum.
+static inline uint16_t opt4048LogChecksum(const uint8_t *data, uint16_t length)
+{
+    uint32_t sum1 = 0;
+    uint32_t sum2 = 0;
+
+    while (length--)
+    {
+        sum1 += *data++;
+        sum2 += sum1;
+    }
+
+    return (uint16_t)(((sum2 % 255) << 8) | (sum1 % 255));
+}
@@ -0,0 +1,212 @@
+/*
+sfe_opt4048_logger.cpp
+
+SparkFun Tristimulus Color Sensor - OPT4048
+
+Qwiic 1x1
+* https://www.sparkfun.com/products/
+Qwiic Mini
+* https://www.sparkfun.com/products/
+
+Repository:
+* https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+The MIT License (MIT)
+
+Copyright (c) 2022 SparkFun Electronics
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions: The
+above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED
+"AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+License(http://opensource.org/licenses/MIT).
+
+The following functions implement the binary sample logger declared in
+sfe_opt4048_logger.h.
+
+*/
+#include "sfe_opt4048_logger.h"
+#include <string.h>
+
+bool QwOpt4048Logger::begin(QwOpt4048 &sensor, Print &output)
+{
+    sfe_opt4048_log_header_t header;
+    uint8_t buff[4];
+
+    _sensor = &sensor;
+    _output = &output;
+
+    _fillBuffer = 0;
+    _fillCount = 0;
+    _flushBuffer = 0;
+    _pending[0] = false;
+    _pending[1] = false;
+    _sequence = 0;
+    _recordsLogged = 0;
+    _overruns = 0;
+    _sectorsWritten = 0;
+    _writeErrors = 0;
+
+    // CONTROL and INT_CONTROL are adjacent, read both at once.
+    if (_sensor->readRegisterRegion(SFE_OPT4048_REGISTER_CONTROL, buff, 4) != 0)
+        return false;
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, OPT4048_LOG_MAGIC, sizeof(header.magic));
+    header.version = OPT4048_LOG_VERSION;
+    header.headerSize = OPT4048_LOG_SECTOR_SIZE;
+    header.recordSize = OPT4048_LOG_RECORD_SIZE;
+    header.deviceId = _sensor->getDeviceID();
+    header.i2cAddress = _sensor->getI2CAddress();
+    header.control = buff[0] << 8 | buff[1];
+    header.intControl = buff[2] << 8 | buff[3];
+    header.startMicros = micros();
+    header.startMillis = millis();
+    header.checksum = opt4048LogChecksum((const uint8_t *)&header, sizeof(header) - sizeof(header.checksum));
+
+    if (_output->write((const uint8_t *)&header, sizeof(header)) != sizeof(header))
+    {
+        _writeErrors++;
+        return false;
+    }
+
+    return true;
+}
+
+bool QwOpt4048Logger::logSample()
+{
+    // Channel data (0x00 - 0x07); CONTROL comes from the sensor's shadow.
+    uint8_t buff[16];
+    uint8_t flags[2];
+
+    if (!_sensor)
+        return false;
+
+    if (_sensor->readRegisterRegion(SFE_OPT4048_REGISTER_EXP_RES_CH0, buff, sizeof(buff)) != 0)
+        return false;
+
+    if (_sensor->readRegisterRegion(SFE_OPT4048_REGISTER_FLAGS, flags) != 0)
+        return false;
+
+    return addRecord(buff, _sensor->getControlShadow(), flags[0] << 8 | flags[1], micros());
+}
+
+bool QwOpt4048Logger::addRecord(const uint8_t *image, uint16_t control, uint16_t flags, uint32_t timestampUs,
+                                uint8_t status)
+{
+    sfe_opt4048_log_record_t *record;
+    uint8_t buffer = _fillBuffer;
+
+    // The sector being filled has not been written yet, so there is nowhere to put the sample.
+    if (_fillCount == 0 && _pending[buffer])
+    {
+        _sequence++;
+        _overruns++;
+        return false;
+    }
+
+    record = (sfe_opt4048_log_record_t *)&_buffer[buffer][_fillCount * OPT4048_LOG_RECORD_SIZE];
+
+    record->timestampUs = timestampUs;
+    memcpy(record->image, image, sizeof(record->image));
+    record->control = control;
+    record->flags = flags;
+    record->sequence = _sequence++;
+    record->marker = OPT4048_LOG_RECORD_MARKER;
+    record->status = status;
+    record->reserved = 0;
+    record->checksum = opt4048LogChecksum((const uint8_t *)record, OPT4048_LOG_RECORD_SIZE - sizeof(record->checksum));
+
+    _recordsLogged++;
+
+    if (++_fillCount == OPT4048_LOG_RECORDS_PER_SECTOR)
+    {
+        _pending[buffer] = true;
+        _fillBuffer = buffer ^ 1;
+        _fillCount = 0;
+    }
+
+    return true;
+}
+
+bool QwOpt4048Logger::service()
+{
+    bool wrote = false;
+
+    // Sectors are written in the order they were filled.
+    while (_pending[_flushBuffer])
+    {
+        writeSector(_buffer[_flushBuffer]);
+        _pending[_flushBuffer] = false;
+        _flushBuffer ^= 1;
+        wrote = true;
+    }
+
+    return wrote;
+}
+
+bool QwOpt4048Logger::flush()
+{
+    uint8_t buffer = _fillBuffer;
+    uint32_t errors = _writeErrors;
+
+    if (!_output)
+        return false;
+
+    if (_fillCount > 0)
+    {
+        memset(&_buffer[buffer][_fillCount * OPT4048_LOG_RECORD_SIZE], 0,
+               OPT4048_LOG_SECTOR_SIZE - (_fillCount * OPT4048_LOG_RECORD_SIZE));
+        _pending[buffer] = true;
+        _fillBuffer = buffer ^ 1;
+        _fillCount = 0;
+    }
+
+    service();
+    _output->flush();
+
+    return errors == _writeErrors;
+}
+
+bool QwOpt4048Logger::writeSector(const uint8_t *sector)
+{
+    if (_output->write(sector, OPT4048_LOG_SECTOR_SIZE) != OPT4048_LOG_SECTOR_SIZE)
+    {
+        _writeErrors++;
+        return false;
+    }
+
+    _sectorsWritten++;
+
+    return true;
+}
+
+uint32_t QwOpt4048Logger::getRecordsLogged()
+{
+    return _recordsLogged;
+}
+
+uint32_t QwOpt4048Logger::getOverruns()
+{
+    return _overruns;
+}
+
+uint32_t QwOpt4048Logger::getSectorsWritten()
+{
+    return _sectorsWritten;
+}
+
+uint32_t QwOpt4048Logger::getWriteErrors()
+{
+    return _writeErrors;
+}
@@ -0,0 +1,121 @@
+/*
+sfe_opt4048_logger.h
+
+SparkFun Tristimulus Color Sensor - OPT4048
+
+Qwiic 1x1
+* https://www.sparkfun.com/products/
+Qwiic Mini
+* https://www.sparkfun.com/products/
+
+Repository:
+* https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+The MIT License (MIT)
+
+Copyright (c) 2022 SparkFun Electronics
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions: The
+above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED
+"AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+License(http://opensource.org/licenses/MIT).
+
+The following class logs OPT4048 samples in the compact binary format defined
+in sfe_opt4048_log_format.h. Records are collected in a double buffer of two
+512 byte sectors; a sector is only handed to the output once it is full, so
+every write to the card is a whole, sector aligned block.
+
+*/
+#pragma once
+#include "sfe_opt4048.h"
+#include "sfe_opt4048_log_format.h"
+#include <Arduino.h>
+#include <stdint.h>
+
+class QwOpt4048Logger
+{
+  public:
+    QwOpt4048Logger()
+        : _sensor(nullptr), _output(nullptr), _fillBuffer(0), _fillCount(0), _flushBuffer(0), _sequence(0),
+          _recordsLogged(0), _overruns(0), _sectorsWritten(0), _writeErrors(0)
+    {
+        _pending[0] = false;
+        _pending[1] = false;
+    };
+
+    /// @brief Starts a log and writes the header sector describing the sensor configuration.
+    /// @param sensor The sensor to log from.
+    /// @param output Where the log is written, usually an open SD card File. For the best throughput the
+    ///        file should be freshly created (or pre-allocated) so the header starts on a sector boundary.
+    /// @return True on successful execution.
+    bool begin(QwOpt4048 &sensor, Print &output);
+
+    /// @brief Reads the channel registers 0x00 to 0x07 and FLAGS, and queues the sample with the CONTROL
+    ///        value the sensor last wrote or read, so the thresholds and CONTROL are not read each time.
+    ///        Only memory is touched apart from the bus reads, so this can run at the sample rate while
+    ///        service() writes the previous sector. Note that reading the FLAGS register clears latched
+    ///        flags.
+    /// @return True if the sample was queued, false on a read error or buffer overrun.
+    bool logSample();
+
+    /// @brief Queues a sample that has already been read.
+    /// @param image The 16 bytes of registers 0x00 to 0x07 as read from the bus.
+    /// @param control The CONTROL register value.
+    /// @param flags The FLAGS register value.
+    /// @param timestampUs The time the sample was read, in microseconds.
+    /// @param status OPT4048_LOG_STATUS_* bits to attach to the record.
+    /// @return True if the sample was queued, false if both sectors are waiting to be written.
+    bool addRecord(const uint8_t *image, uint16_t control, uint16_t flags, uint32_t timestampUs,
+                   uint8_t status = 0);
+
+    /// @brief Writes any full sector to the output. Call this from loop().
+    /// @return True if a sector was written.
+    bool service();
+
+    /// @brief Pads the partially filled sector with empty records and writes everything that is queued.
+    ///        Call this before closing the file.
+    /// @return True on successful execution.
+    bool flush();
+
+    /// @brief Retrieves the number of samples queued since begin().
+    uint32_t getRecordsLogged();
+
+    /// @brief Retrieves the number of samples dropped because both sectors were waiting to be written.
+    uint32_t getOverruns();
+
+    /// @brief Retrieves the number of sectors written to the output, not counting the header.
+    uint32_t getSectorsWritten();
+
+    /// @brief Retrieves the number of sector writes that the output did not fully accept.
+    uint32_t getWriteErrors();
+
+  private:
+    bool writeSector(const uint8_t *sector);
+
+    QwOpt4048 *_sensor;
+    Print *_output;
+
+    // Two sectors: one is filled while the other waits to be written.
+    uint8_t _buffer[2][OPT4048_LOG_SECTOR_SIZE] __attribute__((aligned(4)));
+    volatile bool _pending[2];
+    volatile uint8_t _fillBuffer;
+    volatile uint8_t _fillCount;
+    uint8_t _flushBuffer;
+
+    uint16_t _sequence;
+    uint32_t _recordsLogged;
+    uint32_t _overruns;
+    uint32_t _sectorsWritten;
+    uint32_t _writeErrors;
+};
@@ -0,0 +1,268 @@
+/*
+sfe_opt4048_palette.cpp
+
+SparkFun Tristimulus Color Sensor - OPT4048
+
+Qwiic 1x1
+* https://www.sparkfun.com/products/
+Qwiic Mini
+* https://www.sparkfun.com/products/
+
+Repository:
+* https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+The MIT License (MIT)
+
+Copyright (c) 2022 SparkFun Electronics
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions: The
+above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED
+"AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+License(http://opensource.org/licenses/MIT).
+
+The following functions implement the palette classifier declared in
+sfe_opt4048_palette.h.
+
+*/
+#include "sfe_opt4048_palette.h"
+#include <math.h>
+
+static int32_t component(const sfe_opt4048_lab_t *lab, uint8_t axis)
+{
+    if (axis == 0)
+        return lab->L;
+
+    return axis == 1 ? lab->a : lab->b;
+}
+
+static int64_t distance2(const sfe_opt4048_lab_t *lab1, const sfe_opt4048_lab_t *lab2)
+{
+    int64_t dL = lab1->L - lab2->L;
+    int64_t da = lab1->a - lab2->a;
+    int64_t db = lab1->b - lab2->b;
+
+    return dL * dL + da * da + db * db;
+}
+
+// Inverse sRGB gamma, only used when entries are added.
+static float linearize(uint8_t value)
+{
+    float v = value / 255.0f;
+
+    return v <= 0.04045f ? v / 12.92f : powf((v + 0.055f) / 1.055f, 2.4f);
+}
+
+bool QwOpt4048Palette::addEntry(const sfe_opt4048_lab_t *lab, uint16_t id)
+{
+    if (_count >= _capacity)
+        return false;
+
+    _entries[_count].lab = *lab;
+    _entries[_count].id = id;
+    _entries[_count].axis = 0;
+    _count++;
+    _built = false;
+
+    return true;
+}
+
+bool QwOpt4048Palette::addEntry(uint8_t red, uint8_t green, uint8_t blue, uint16_t id)
+{
+    sfe_opt4048_xyz_t xyz;
+    sfe_opt4048_lab_t lab;
+
+    float r = linearize(red);
+    float g = linearize(green);
+    float b = linearize(blue);
+
+    // XYZ from linear sRGB (IEC 61966-2-1).
+    xyz.X = (int32_t)((0.4124f * r + 0.3576f * g + 0.1805f * b) * OPT4048_XYZ_ONE + 0.5f);
+    xyz.Y = (int32_t)((0.2126f * r + 0.7152f * g + 0.0722f * b) * OPT4048_XYZ_ONE + 0.5f);
+    xyz.Z = (int32_t)((0.0193f * r + 0.1192f * g + 0.9505f * b) * OPT4048_XYZ_ONE + 0.5f);
+
+    opt4048XYZToLab(&xyz, &lab);
+
+    return addEntry(&lab, id);
+}
+
+bool QwOpt4048Palette::addEntry(const sfe_color_t *color, const sfe_color_t *white, uint16_t id)
+{
+    sfe_opt4048_xyz_t xyz;
+    sfe_opt4048_lab_t lab;
+
+    opt4048CalculateXYZ(color, white, &xyz);
+    opt4048XYZToLab(&xyz, &lab);
+
+    return addEntry(&lab, id);
+}
+
+void QwOpt4048Palette::build()
+{
+    buildRange(0, _count);
+    _built = true;
+}
+
+// The median of [low, high) becomes the node, split on the axis with the largest spread; the entries
+// before it form the lower subtree and the entries after it the upper one.
+void QwOpt4048Palette::buildRange(uint16_t low, uint16_t high)
+{
+    if (high - low < 1)
+        return;
+
+    uint8_t axis = 0;
+    int32_t widest = -1;
+
+    for (uint8_t i = 0; i < 3; i++)
+    {
+        int32_t minimum = component(&_entries[low].lab, i);
+        int32_t maximum = minimum;
+
+        for (uint16_t j = low + 1; j < high; j++)
+        {
+            int32_t value = component(&_entries[j].lab, i);
+
+            if (value < minimum)
+                minimum = value;
+            if (value > maximum)
+                maximum = value;
+        }
+
+        if (maximum - minimum > widest)
+        {
+            widest = maximum - minimum;
+            axis = i;
+        }
+    }
+
+    // Quickselect the median on the axis.
+    uint16_t mid = low + (high - low) / 2;
+    uint16_t left = low;
+    uint16_t right = high - 1;
+
+    while (left < right)
+    {
+        int32_t pivot = component(&_entries[mid].lab, axis);
+        uint16_t i = left;
+        uint16_t j = right;
+
+        while (i <= j)
+        {
+            while (component(&_entries[i].lab, axis) < pivot)
+                i++;
+            while (component(&_entries[j].lab, axis) > pivot)
+                j--;
+
+            if (i <= j)
+            {
+                sfe_opt4048_palette_entry_t swap = _entries[i];
+                _entries[i] = _entries[j];
+                _entries[j] = swap;
+
+                i++;
+                if (j == 0)
+                    break;
+                j--;
+            }
+        }
+
+        if (mid <= j)
+            right = j;
+        else if (mid >= i)
+            left = i;
+        else
+            break;
+    }
+
+    _entries[mid].axis = axis;
+
+    buildRange(low, mid);
+    buildRange(mid + 1, high);
+}
+
+void QwOpt4048Palette::setMaxVisits(uint16_t maxVisits)
+{
+    _maxVisits = maxVisits;
+}
+
+void QwOpt4048Palette::search(uint16_t low, uint16_t high)
+{
+    if (low >= high || (_maxVisits && _visited >= _maxVisits))
+        return;
+
+    uint16_t mid = low + (high - low) / 2;
+    const sfe_opt4048_palette_entry_t *node = &_entries[mid];
+
+    int64_t d = distance2(_query, &node->lab);
+    _visited++;
+
+    if (d < _bestDistance)
+    {
+        _bestDistance = d;
+        _bestIndex = mid;
+    }
+
+    int64_t diff = (int64_t)component(_query, node->axis) - component(&node->lab, node->axis);
+
+    // The side of the split holding the query first; the other side only if the splitting plane is
+    // closer than the best match so far.
+    if (diff < 0)
+    {
+        search(low, mid);
+        if (diff * diff < _bestDistance)
+            search(mid + 1, high);
+    }
+    else
+    {
+        search(mid + 1, high);
+        if (diff * diff < _bestDistance)
+            search(low, mid);
+    }
+}
+
+bool QwOpt4048Palette::classify(const sfe_opt4048_lab_t *lab, sfe_opt4048_palette_match_t *match)
+{
+    if (_count == 0 || !_built)
+        return false;
+
+    _query = lab;
+    _bestDistance = INT64_MAX;
+    _bestIndex = 0;
+    _visited = 0;
+
+    search(0, _count);
+
+    match->id = _entries[_bestIndex].id;
+    match->distance = (int32_t)(sqrt((double)_bestDistance) + 0.5);
+    match->visited = _visited;
+    match->exact = _maxVisits == 0 || _visited < _maxVisits;
+
+    return true;
+}
+
+bool QwOpt4048Palette::classify(const sfe_color_t *color, const sfe_color_t *white,
+                                sfe_opt4048_palette_match_t *match)
+{
+    sfe_opt4048_xyz_t xyz;
+    sfe_opt4048_lab_t lab;
+
+    opt4048CalculateXYZ(color, white, &xyz);
+    opt4048XYZToLab(&xyz, &lab);
+
+    return classify(&lab, match);
+}
+
+uint16_t QwOpt4048Palette::getCount()
+{
+    return _count;
+}
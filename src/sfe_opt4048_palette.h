@@ -0,0 +1,136 @@
+/*
+sfe_opt4048_palette.h
+
+SparkFun Tristimulus Color Sensor - OPT4048
+
+Qwiic 1x1
+* https://www.sparkfun.com/products/
+Qwiic Mini
+* https://www.sparkfun.com/products/
+
+Repository:
+* https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+The MIT License (MIT)
+
+Copyright (c) 2022 SparkFun Electronics
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions: The
+above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED
+"AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+License(http://opensource.org/licenses/MIT).
+
+The following class classifies samples against a palette of named colors. The
+palette entries are converted to CIELAB once when they are added, and build()
+arranges them in place into a k-d tree, so finding the nearest entry to a
+sample takes about log2(n) distance calculations instead of n. The search
+can be capped at a number of visited entries to bound its time.
+
+*/
+#pragma once
+#include "sfe_opt4048_color.h"
+#include <stdint.h>
+
+/// @brief A palette entry. The array of entries is provided by the caller and reordered by build().
+typedef struct
+{
+    sfe_opt4048_lab_t lab; // The color, converted when the entry is added
+    uint16_t id;           // Caller's tag, e.g. an index into a table of names
+    uint8_t axis;          // Split axis of the entry in the k-d tree: 0 for L*, 1 for a*, 2 for b*
+
+} sfe_opt4048_palette_entry_t;
+
+/// @brief Result of a classification.
+typedef struct
+{
+    uint16_t id;      // Tag of the nearest entry
+    int32_t distance; // Delta E 1976 to the nearest entry, Q8
+    uint16_t visited; // Entries compared during the search
+    bool exact;       // False if the search was cut short by setMaxVisits()
+
+} sfe_opt4048_palette_match_t;
+
+class QwOpt4048Palette
+{
+  public:
+    /// @brief Creates a palette in an array of entries provided by the caller.
+    /// @param entries The memory for the entries.
+    /// @param capacity Number of entries the array holds.
+    QwOpt4048Palette(sfe_opt4048_palette_entry_t *entries, uint16_t capacity)
+        : _entries(entries), _capacity(capacity), _count(0), _maxVisits(0), _built(false) {};
+
+    /// @brief Adds an entry given in CIELAB.
+    /// @param lab Pointer to the color.
+    /// @param id Tag returned when a sample matches the entry.
+    /// @return True on success, false if the palette is full.
+    bool addEntry(const sfe_opt4048_lab_t *lab, uint16_t id);
+
+    /// @brief Adds an entry given as gamma encoded sRGB, e.g. from a web color. The conversion to
+    ///        CIELAB takes place once, here.
+    /// @param red Red, 0 to 255.
+    /// @param green Green, 0 to 255.
+    /// @param blue Blue, 0 to 255.
+    /// @param id Tag returned when a sample matches the entry.
+    /// @return True on success, false if the palette is full.
+    bool addEntry(uint8_t red, uint8_t green, uint8_t blue, uint16_t id);
+
+    /// @brief Adds an entry from a sample of the color, e.g. a reference part measured on the line.
+    /// @param color Pointer to the sample.
+    /// @param white Pointer to a sample of the reference white, or nullptr. See opt4048CalculateXYZ().
+    /// @param id Tag returned when a sample matches the entry.
+    /// @return True on success, false if the palette is full.
+    bool addEntry(const sfe_color_t *color, const sfe_color_t *white, uint16_t id);
+
+    /// @brief Arranges the entries into a k-d tree. Call once after the last entry is added; adding an
+    ///        entry afterwards requires another build().
+    void build();
+
+    /// @brief Limits the number of entries compared per search. The search visits the most likely
+    ///        entries first, so a capped search still returns a close match.
+    /// @param maxVisits Maximum entries compared, or 0 for no limit.
+    void setMaxVisits(uint16_t maxVisits);
+
+    /// @brief Finds the entry nearest to a color.
+    /// @param lab Pointer to the color.
+    /// @param match Pointer to the struct to be populated.
+    /// @return True on success, false if the palette is empty or not built.
+    bool classify(const sfe_opt4048_lab_t *lab, sfe_opt4048_palette_match_t *match);
+
+    /// @brief Finds the entry nearest to a sample.
+    /// @param color Pointer to the sample.
+    /// @param white Pointer to a sample of the reference white, or nullptr. Use the same white as for
+    ///        entries added from samples.
+    /// @param match Pointer to the struct to be populated.
+    /// @return True on success, false if the palette is empty or not built.
+    bool classify(const sfe_color_t *color, const sfe_color_t *white, sfe_opt4048_palette_match_t *match);
+
+    /// @brief Retrieves the number of entries.
+    uint16_t getCount();
+
+  private:
+    void buildRange(uint16_t low, uint16_t high);
+    void search(uint16_t low, uint16_t high);
+
+    sfe_opt4048_palette_entry_t *_entries;
+    uint16_t _capacity;
+    uint16_t _count;
+    uint16_t _maxVisits;
+    bool _built;
+
+    // State of the search in progress.
+    const sfe_opt4048_lab_t *_query;
+    int64_t _bestDistance;
+    uint16_t _bestIndex;
+    uint16_t _visited;
+};
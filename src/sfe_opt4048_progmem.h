@@ -0,0 +1,65 @@
+/*
+sfe_opt4048_progmem.h
+
+SparkFun Tristimulus Color Sensor - OPT4048
+
+Qwiic 1x1
+* https://www.sparkfun.com/products/
+Qwiic Mini
+* https://www.sparkfun.com/products/
+
+Repository:
+* https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+The MIT License (MIT)
+
+Copyright (c) 2022 SparkFun Electronics
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions: The
+above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED
+"AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+License(http://opensource.org/licenses/MIT).
+
+The following helpers place constant tables in flash on targets where const
+data would otherwise be copied to RAM (AVR, ESP8266), and read them back.
+On every other target, including host builds, they reduce to plain const
+data and ordinary loads.
+
+*/
+#pragma once
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__AVR__)
+#include <avr/pgmspace.h>
+#define OPT4048_PROGMEM PROGMEM
+#define OPT4048_MEMCPY_P memcpy_P
+#elif defined(ESP8266)
+#include <pgmspace.h>
+#define OPT4048_PROGMEM PROGMEM
+#define OPT4048_MEMCPY_P memcpy_P
+#else
+#define OPT4048_PROGMEM
+#define OPT4048_MEMCPY_P memcpy
+#endif
+
+/// @brief Reads one entry of a table declared with OPT4048_PROGMEM.
+/// @param addr Address of the entry.
+/// @return The value of the entry.
+template <class T> static inline T opt4048ReadProgmem(const T *addr)
+{
+    T value;
+    OPT4048_MEMCPY_P(&value, addr, sizeof(T));
+    return value;
+}
@@ -0,0 +1,233 @@
+/*
+sfe_opt4048_recovery.cpp
+
+SparkFun Tristimulus Color Sensor - OPT4048
+
+Qwiic 1x1
+* https://www.sparkfun.com/products/
+Qwiic Mini
+* https://www.sparkfun.com/products/
+
+Repository:
+* https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+The MIT License (MIT)
+
+Copyright (c) 2022 SparkFun Electronics
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions: The
+above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED
+"AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+License(http://opensource.org/licenses/MIT).
+
+The following functions implement the bus recovery declared in
+sfe_opt4048_recovery.h.
+
+*/
+#include "sfe_opt4048_recovery.h"
+
+// Half period of the recovery clock, about 100kHz.
+#define kRecoveryHalfClockUs 5
+
+// Wire timeout where the core supports it, well above the longest OPT4048 transfer.
+#define kWireTimeoutUs 25000
+
+void QwOpt4048Recovery::begin(QwOpt4048 &sensor, sfe_OPT4048::QwDeviceBus &bus, TwoWire &wirePort,
+                              uint8_t sdaPin, uint8_t sclPin, uint32_t clockHz)
+{
+    _sensor = &sensor;
+    _bus = &bus;
+    _wirePort = &wirePort;
+    _sdaPin = sdaPin;
+    _sclPin = sclPin;
+    _clockHz = clockHz;
+
+#ifdef WIRE_HAS_TIMEOUT
+    _wirePort->setWireTimeout(kWireTimeoutUs, true);
+#endif
+
+    _sensor->setCommunicationBus(*this);
+}
+
+bool QwOpt4048Recovery::saveConfiguration()
+{
+    return _sensor->saveConfiguration(&_config);
+}
+
+void QwOpt4048Recovery::setTimeBudget(uint32_t budgetUs)
+{
+    _timeBudgetUs = budgetUs;
+}
+
+void QwOpt4048Recovery::setErrorThreshold(uint8_t errors)
+{
+    _errorThreshold = errors;
+}
+
+bool QwOpt4048Recovery::ping(uint8_t address)
+{
+    bool success = _bus->ping(address);
+
+    countResult(success);
+
+    return success;
+}
+
+int QwOpt4048Recovery::writeRegisterRegion(uint8_t address, uint8_t offset, uint8_t *data, uint16_t length)
+{
+    int retVal = _bus->writeRegisterRegion(address, offset, data, length);
+
+    countResult(retVal == 0);
+
+    return retVal;
+}
+
+int QwOpt4048Recovery::readRegisterRegion(uint8_t addr, uint8_t reg, uint8_t *data, uint16_t numBytes)
+{
+    int retVal = _bus->readRegisterRegion(addr, reg, data, numBytes);
+
+    countResult(retVal == 0);
+
+    return retVal;
+}
+
+int QwOpt4048Recovery::alertResponse(uint8_t *response)
+{
+    // No answer only means ALERT is not asserted, so it is not counted as a failed transfer.
+    return _bus->alertResponse(response);
+}
+
+void QwOpt4048Recovery::countResult(bool success)
+{
+    if (success)
+    {
+        _consecutiveErrors = 0;
+        return;
+    }
+
+    _busErrors++;
+
+    if (_consecutiveErrors < 0xFF)
+        _consecutiveErrors++;
+}
+
+bool QwOpt4048Recovery::service()
+{
+    if (_sensor == nullptr)
+        return false;
+
+    if (_consecutiveErrors < _errorThreshold && digitalRead(_sdaPin) == HIGH)
+        return true;
+
+    return recover();
+}
+
+void QwOpt4048Recovery::clearBus()
+{
+    _wirePort->end();
+
+    // Open drain by hand: drive low as an output, release as an input with pull-up.
+    pinMode(_sdaPin, INPUT_PULLUP);
+    pinMode(_sclPin, INPUT_PULLUP);
+    delayMicroseconds(kRecoveryHalfClockUs);
+
+    // A slave stuck mid-byte releases SDA after at most nine clocks.
+    for (uint8_t i = 0; i < 9 && digitalRead(_sdaPin) == LOW; i++)
+    {
+        digitalWrite(_sclPin, LOW);
+        pinMode(_sclPin, OUTPUT);
+        delayMicroseconds(kRecoveryHalfClockUs);
+        pinMode(_sclPin, INPUT_PULLUP);
+        delayMicroseconds(kRecoveryHalfClockUs);
+    }
+
+    // STOP: SDA rises while SCL is high.
+    digitalWrite(_sdaPin, LOW);
+    pinMode(_sdaPin, OUTPUT);
+    delayMicroseconds(kRecoveryHalfClockUs);
+    pinMode(_sdaPin, INPUT_PULLUP);
+    delayMicroseconds(kRecoveryHalfClockUs);
+
+    _wirePort->begin();
+    _wirePort->setClock(_clockHz);
+    sfe_OPT4048::QwI2CDirect::invalidateClock();
+
+#ifdef WIRE_HAS_TIMEOUT
+    _wirePort->setWireTimeout(kWireTimeoutUs, true);
+#endif
+}
+
+bool QwOpt4048Recovery::recover()
+{
+    uint32_t start;
+    bool success = false;
+
+    if (_sensor == nullptr)
+        return false;
+
+    start = micros();
+    _recoveryAttempts++;
+
+    clearBus();
+
+    while (micros() - start < _timeBudgetUs)
+    {
+        if (_sensor->getDeviceID() == OPT4048_DEVICE_ID)
+        {
+            success = true;
+            break;
+        }
+    }
+
+    // Without a saved image the device keeps its current configuration.
+    if (success && _config.magic == OPT4048_CONFIG_MAGIC)
+        success = _sensor->restoreConfiguration(&_config) && micros() - start < _timeBudgetUs;
+
+    _lastRecoveryUs = micros() - start;
+    if (_lastRecoveryUs > _maxRecoveryUs)
+        _maxRecoveryUs = _lastRecoveryUs;
+
+    if (success)
+    {
+        _recoverySuccesses++;
+        _consecutiveErrors = 0;
+    }
+
+    return success;
+}
+
+uint32_t QwOpt4048Recovery::getBusErrors()
+{
+    return _busErrors;
+}
+
+uint32_t QwOpt4048Recovery::getRecoveryAttempts()
+{
+    return _recoveryAttempts;
+}
+
+uint32_t QwOpt4048Recovery::getRecoverySuccesses()
+{
+    return _recoverySuccesses;
+}
+
+uint32_t QwOpt4048Recovery::getLastRecoveryUs()
+{
+    return _lastRecoveryUs;
+}
+
+uint32_t QwOpt4048Recovery::getMaxRecoveryUs()
+{
+    return _maxRecoveryUs;
+}
@@ -0,0 +1,140 @@
+/*
+sfe_opt4048_recovery.h
+
+SparkFun Tristimulus Color Sensor - OPT4048
+
+Qwiic 1x1
+* https://www.sparkfun.com/products/
+Qwiic Mini
+* https://www.sparkfun.com/products/
+
+Repository:
+* https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+The MIT License (MIT)
+
+Copyright (c) 2022 SparkFun Electronics
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions: The
+above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED
+"AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+License(http://opensource.org/licenses/MIT).
+
+The following class recovers the OPT4048 from a hung I2C bus. It sits between
+the sensor and its bus as a QwDeviceBus, forwards every transfer, and counts
+failed transfers. When
+a number of transfers fail in a row, or SDA is held low, service() clears the
+bus with the standard nine SCL clocks and a STOP, re-probes the device ID, and
+restores the saved configuration, all within a time budget. Recovery attempts,
+successes, and durations are counted so they can be monitored.
+
+*/
+#pragma once
+#include "sfe_bus.h"
+#include "sfe_opt4048.h"
+#include <stdint.h>
+
+class QwOpt4048Recovery : public sfe_OPT4048::QwDeviceBus
+{
+  public:
+    QwOpt4048Recovery()
+        : _sensor(nullptr), _bus(nullptr), _wirePort(nullptr), _sdaPin(0), _sclPin(0), _clockHz(100000),
+          _timeBudgetUs(10000), _errorThreshold(3), _consecutiveErrors(0), _busErrors(0), _recoveryAttempts(0),
+          _recoverySuccesses(0), _lastRecoveryUs(0), _maxRecoveryUs(0)
+    {
+        _config.magic = 0;
+    };
+
+    /// @brief Inserts the recovery layer between the sensor and its bus. Call after the sensor's begin();
+    ///        the sensor's I2C address is kept, and so are the bus settings, e.g. a per-device clock or
+    ///        Hs-mode. Where the core supports it, a Wire timeout is set so that a stuck transfer returns
+    ///        an error instead of blocking.
+    /// @param sensor The sensor to protect.
+    /// @param bus The bus the sensor uses, e.g. *sensor.getCommunicationBus(). Every transfer goes to it.
+    /// @param wirePort The Wire port behind the bus, restarted by a recovery.
+    /// @param sdaPin The SDA pin of the Wire port, e.g. SDA.
+    /// @param sclPin The SCL pin of the Wire port, e.g. SCL.
+    /// @param clockHz The port clock to set again after the port is restarted. Devices with their own
+    ///        clock, see setBusClock(), get theirs back with their next transfer.
+    void begin(QwOpt4048 &sensor, sfe_OPT4048::QwDeviceBus &bus, TwoWire &wirePort, uint8_t sdaPin,
+               uint8_t sclPin, uint32_t clockHz = 100000);
+
+    /// @brief Captures the sensor configuration that is restored after a recovery. Call again whenever
+    ///        the configuration changes.
+    /// @return True on successful execution.
+    bool saveConfiguration();
+
+    /// @brief Sets the longest time a recovery may take.
+    /// @param budgetUs The budget in microseconds.
+    void setTimeBudget(uint32_t budgetUs);
+
+    /// @brief Sets how many transfers must fail in a row before the bus is recovered.
+    /// @param errors Number of consecutive failed transfers.
+    void setErrorThreshold(uint8_t errors);
+
+    /// @brief Recovers the bus if transfers keep failing or SDA is held low. Call this from loop(), not
+    ///        from inside a transfer.
+    /// @return True if the bus is healthy or was recovered, false if recovery failed.
+    bool service();
+
+    /// @brief Recovers unconditionally: clears the bus, restarts the Wire port, re-probes the device ID
+    ///        until it answers or the budget runs out, and restores the saved configuration.
+    /// @return True if the device answered and the configuration was restored in time.
+    bool recover();
+
+    /// @brief Retrieves the number of failed transfers since begin().
+    uint32_t getBusErrors();
+
+    /// @brief Retrieves the number of recoveries that were attempted.
+    uint32_t getRecoveryAttempts();
+
+    /// @brief Retrieves the number of recoveries that succeeded.
+    uint32_t getRecoverySuccesses();
+
+    /// @brief Retrieves the duration of the last recovery in microseconds.
+    uint32_t getLastRecoveryUs();
+
+    /// @brief Retrieves the duration of the longest recovery in microseconds.
+    uint32_t getMaxRecoveryUs();
+
+    bool ping(uint8_t address);
+
+    int writeRegisterRegion(uint8_t address, uint8_t offset, uint8_t *data, uint16_t length);
+
+    int readRegisterRegion(uint8_t addr, uint8_t reg, uint8_t *data, uint16_t numBytes);
+
+    int alertResponse(uint8_t *response);
+
+  private:
+    void countResult(bool success);
+    void clearBus();
+
+    QwOpt4048 *_sensor;
+    sfe_OPT4048::QwDeviceBus *_bus;
+    TwoWire *_wirePort;
+    sfe_opt4048_config_t _config;
+
+    uint8_t _sdaPin;
+    uint8_t _sclPin;
+    uint32_t _clockHz;
+    uint32_t _timeBudgetUs;
+    uint8_t _errorThreshold;
+    uint8_t _consecutiveErrors;
+
+    uint32_t _busErrors;
+    uint32_t _recoveryAttempts;
+    uint32_t _recoverySuccesses;
+    uint32_t _lastRecoveryUs;
+    uint32_t _maxRecoveryUs;
+};
@@ -0,0 +1,134 @@
+/*
+sfe_opt4048_static.h
+
+SparkFun Tristimulus Color Sensor - OPT4048
+
+Qwiic 1x1
+* https://www.sparkfun.com/products/
+Qwiic Mini
+* https://www.sparkfun.com/products/
+
+Repository:
+* https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+The MIT License (MIT)
+
+Copyright (c) 2022 SparkFun Electronics
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions: The
+above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED
+"AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+License(http://opensource.org/licenses/MIT).
+
+The following class template fixes the OPT4048 configuration at compile time.
+The CONTROL and INT_CONTROL register images and the derived timing and scaling
+constants are constant-folded by the compiler, and init() writes both registers
+in a single burst. None of the runtime setters are referenced, so the linker
+drops them from the binary unless the sketch calls them itself.
+
+*/
+#pragma once
+#include "sfe_opt4048.h"
+#include <stdint.h>
+
+template <opt4048_range_t Range, opt4048_conversion_time_t ConversionTime, opt4048_operation_mode_t Mode,
+          opt4048_int_cfg_t IntMechanism = INT_DR_ALL_CHANNELS, opt4048_threshold_channel_t ThresholdChannel =
+                                                                  THRESH_CHANNEL_CH0,
+          opt4048_fault_count_t FaultCount = FAULT_COUNT_1, bool IntLatch = true, bool IntActiveHigh = false,
+          bool IntInput = false, bool Qwake = false>
+class QwOpt4048Static : public QwOpt4048
+{
+    static_assert(Range <= RANGE_144LUX || Range == RANGE_AUTO, "Invalid range");
+    static_assert(ConversionTime <= CONVERSION_TIME_800MS, "Invalid conversion time");
+
+    // Compile-time copies of the flash tables in sfe_opt4048_decode.cpp, which can't be read in a
+    // constant expression.
+    static constexpr uint32_t conversionTimeUs(opt4048_conversion_time_t time)
+    {
+        return time == CONVERSION_TIME_600US    ? 600
+               : time == CONVERSION_TIME_1MS    ? 1000
+               : time == CONVERSION_TIME_1MS8   ? 1800
+               : time == CONVERSION_TIME_3MS4   ? 3400
+               : time == CONVERSION_TIME_6MS5   ? 6500
+               : time == CONVERSION_TIME_12MS7  ? 12700
+               : time == CONVERSION_TIME_25MS   ? 25000
+               : time == CONVERSION_TIME_50MS   ? 50000
+               : time == CONVERSION_TIME_100MS  ? 100000
+               : time == CONVERSION_TIME_200MS  ? 200000
+               : time == CONVERSION_TIME_400MS  ? 400000
+                                                : 800000;
+    }
+
+    static constexpr uint32_t fullScaleLux(opt4048_range_t range)
+    {
+        return range == RANGE_2KLUX2   ? 2254
+               : range == RANGE_4KLUX5 ? 4509
+               : range == RANGE_9LUX   ? 9018
+               : range == RANGE_18LUX  ? 18036
+               : range == RANGE_36LUX  ? 36071
+               : range == RANGE_72LUX  ? 72142
+                                       : 144284;
+    }
+
+  public:
+    /// @brief CONTROL register (0x0A) image.
+    static constexpr uint16_t kControl = ((uint16_t)Qwake << 15) | ((uint16_t)Range << 10) |
+                                         ((uint16_t)ConversionTime << 6) | ((uint16_t)Mode << 4) |
+                                         ((uint16_t)IntLatch << 3) | ((uint16_t)IntActiveHigh << 2) |
+                                         (uint16_t)FaultCount;
+
+    /// @brief INT_CONTROL register (0x0B) image. Bits 15:7 must be written as 0x100, and I2C burst
+    ///        stays enabled so registers can be read and written in one transaction. INT_DIR is set
+    ///        for an output, so it is the inverse of IntInput.
+    static constexpr uint16_t kIntControl = 0x8000 | ((uint16_t)ThresholdChannel << 5) |
+                                            ((uint16_t)!IntInput << 4) | ((uint16_t)IntMechanism << 2) | 0x0001;
+
+    /// @brief Conversion time of a single channel in microseconds.
+    static constexpr uint32_t kConversionTimeUs = conversionTimeUs(ConversionTime);
+
+    /// @brief Time for a full Red, Green, Blue, and White sample in microseconds.
+    static constexpr uint32_t kSamplePeriodUs = 4 * kConversionTimeUs;
+
+    /// @brief Full scale of Channel One in lux. Auto range reports the largest range.
+    static constexpr uint32_t kFullScaleLux = fullScaleLux(Range);
+
+    /// @brief Lux per Channel One ADC code; codes are range independent.
+    static constexpr double kLuxPerCode = 0.00215;
+
+    /// @brief Writes the compile-time configuration with one burst write of CONTROL and INT_CONTROL,
+    ///        the only transaction. The CONTROL shadow is seeded from the written image rather than
+    ///        read back, and a missing device fails the write. The bus must already be set with
+    ///        setCommunicationBus().
+    /// @return True on successful execution.
+    bool init()
+    {
+        return applyConfiguration();
+    }
+
+    /// @brief Writes the compile-time configuration without checking the device, e.g. to restore it
+    ///        after a brown-out.
+    /// @return True on successful execution.
+    bool applyConfiguration()
+    {
+        return fastStart(kControl, kIntControl);
+    }
+
+    /// @brief Calculates lux from a Channel One ADC code with the constant scale factor.
+    /// @param green The Channel One ADC code.
+    /// @return The illuminance in lux.
+    static double codeToLux(uint32_t green)
+    {
+        return green * kLuxPerCode;
+    }
+};
@@ -0,0 +1,200 @@
+/*
+sfe_opt4048_stats.cpp
+
+SparkFun Tristimulus Color Sensor - OPT4048
+
+Qwiic 1x1
+* https://www.sparkfun.com/products/
+Qwiic Mini
+* https://www.sparkfun.com/products/
+
+Repository:
+* https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+The MIT License (MIT)
+
+Copyright (c) 2022 SparkFun Electronics
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions: The
+above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED
+"AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+License(http://opensource.org/licenses/MIT).
+
+The following functions implement the statistics accumulator declared in
+sfe_opt4048_stats.h.
+
+*/
+#include "sfe_opt4048_stats.h"
+#include <math.h>
+
+void QwOpt4048Stats::reset()
+{
+    _count = 0;
+
+    for (uint8_t i = 0; i < kNumCodes; i++)
+        _codeShift[i] = 0;
+
+    for (uint8_t i = 0; i < kNumStats - kNumCodes; i++)
+        _valueShift[i] = 0;
+
+    for (uint8_t i = 0; i < kNumStats; i++)
+    {
+        _mean[i] = 0;
+        _m2[i] = 0;
+        _min[i] = 0;
+        _max[i] = 0;
+    }
+}
+
+double QwOpt4048Stats::getShift(uint8_t stat) const
+{
+    if (stat < kNumCodes)
+        return _codeShift[stat];
+
+    return _valueShift[stat - kNumCodes];
+}
+
+double QwOpt4048Stats::getShiftDifference(uint8_t stat, const QwOpt4048Stats &other) const
+{
+    // Codes are subtracted as integers, a float double could not hold them exactly.
+    if (stat < kNumCodes)
+        return (int32_t)(other._codeShift[stat] - _codeShift[stat]);
+
+    return other._valueShift[stat - kNumCodes] - _valueShift[stat - kNumCodes];
+}
+
+void QwOpt4048Stats::add(const sfe_color_t *color)
+{
+    sfe_cie_t cie;
+
+    opt4048CalculateCIE(color, &cie);
+
+    add(color, &cie);
+}
+
+void QwOpt4048Stats::add(const sfe_color_t *color, const sfe_cie_t *cie)
+{
+    uint32_t codes[kNumCodes] = {color->red, color->green, color->blue, color->white};
+    double values[kNumStats - kNumCodes] = {cie->lux, cie->CIEx, cie->CIEy};
+
+    _count++;
+
+    // The first sample becomes the shift, so the accumulators only hold the spread of the samples.
+    if (_count == 1)
+    {
+        for (uint8_t i = 0; i < kNumCodes; i++)
+            _codeShift[i] = codes[i];
+
+        for (uint8_t i = 0; i < kNumStats - kNumCodes; i++)
+            _valueShift[i] = values[i];
+    }
+
+    for (uint8_t i = 0; i < kNumCodes; i++)
+        addValue(i, (int32_t)(codes[i] - _codeShift[i]));
+
+    for (uint8_t i = 0; i < kNumStats - kNumCodes; i++)
+        addValue(kNumCodes + i, values[i] - _valueShift[i]);
+}
+
+void QwOpt4048Stats::addValue(uint8_t stat, double value)
+{
+    // Welford: the mean moves by a share of the difference, and M2 grows by the product of the
+    // differences to the old and the new mean. _count already includes this sample.
+    double delta = value - _mean[stat];
+
+    _mean[stat] += delta / _count;
+    _m2[stat] += delta * (value - _mean[stat]);
+
+    if (_count == 1 || value < _min[stat])
+        _min[stat] = value;
+
+    if (_count == 1 || value > _max[stat])
+        _max[stat] = value;
+}
+
+void QwOpt4048Stats::merge(const QwOpt4048Stats &other)
+{
+    if (other._count == 0)
+        return;
+
+    if (_count == 0)
+    {
+        *this = other;
+        return;
+    }
+
+    // Chan et al.: the combined M2 is the sum of both plus a term for the distance between the means.
+    double n = (double)_count + other._count;
+    double weight = (double)_count * other._count / n;
+
+    for (uint8_t i = 0; i < kNumStats; i++)
+    {
+        // The other accumulator's values, moved to this one's shift. M2 does not depend on the shift.
+        double shift = getShiftDifference(i, other);
+        double delta = other._mean[i] + shift - _mean[i];
+
+        _mean[i] += delta * other._count / n;
+        _m2[i] += other._m2[i] + delta * delta * weight;
+
+        if (other._min[i] + shift < _min[i])
+            _min[i] = other._min[i] + shift;
+
+        if (other._max[i] + shift > _max[i])
+            _max[i] = other._max[i] + shift;
+    }
+
+    _count += other._count;
+}
+
+uint32_t QwOpt4048Stats::getCount()
+{
+    return _count;
+}
+
+double QwOpt4048Stats::getMean(opt4048_stat_t stat)
+{
+    if (_count == 0)
+        return 0;
+
+    return getShift(stat) + _mean[stat];
+}
+
+double QwOpt4048Stats::getVariance(opt4048_stat_t stat)
+{
+    if (_count < 2)
+        return 0;
+
+    return _m2[stat] / (_count - 1);
+}
+
+double QwOpt4048Stats::getStdDev(opt4048_stat_t stat)
+{
+    return sqrt(getVariance(stat));
+}
+
+double QwOpt4048Stats::getMin(opt4048_stat_t stat)
+{
+    if (_count == 0)
+        return 0;
+
+    return getShift(stat) + _min[stat];
+}
+
+double QwOpt4048Stats::getMax(opt4048_stat_t stat)
+{
+    if (_count == 0)
+        return 0;
+
+    return getShift(stat) + _max[stat];
+}
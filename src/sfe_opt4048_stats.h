@@ -0,0 +1,133 @@
+/*
+sfe_opt4048_stats.h
+
+SparkFun Tristimulus Color Sensor - OPT4048
+
+Qwiic 1x1
+* https://www.sparkfun.com/products/
+Qwiic Mini
+* https://www.sparkfun.com/products/
+
+Repository:
+* https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+The MIT License (MIT)
+
+Copyright (c) 2022 SparkFun Electronics
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions: The
+above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED
+"AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+License(http://opensource.org/licenses/MIT).
+
+The following class accumulates per-channel statistics of a sample stream in
+constant memory: count, mean, variance, minimum, and maximum of the Red,
+Green, Blue, and White codes, lux, and CIE x and y. Mean and variance are
+updated with Welford's algorithm, which stays accurate over long runs where
+a sum of squares would lose its precision. Values are accumulated relative to
+the first sample, so only their spread has to fit the precision of double; on
+AVR double is a 32 bit float with 24 significant bits, which keeps the mean and
+variance of codes exact to a fraction of a code while the codes of a channel
+stay within about 16 million of each other. Accumulators can be merged, so
+results of several sensors or windows can be combined without the samples.
+
+*/
+#pragma once
+#include "sfe_opt4048_decode.h"
+#include <stdint.h>
+
+/// @brief Quantities tracked by QwOpt4048Stats.
+typedef enum
+{
+    STAT_RED = 0x00,
+    STAT_GREEN,
+    STAT_BLUE,
+    STAT_WHITE,
+    STAT_LUX,
+    STAT_CIEX,
+    STAT_CIEY
+} opt4048_stat_t;
+
+class QwOpt4048Stats
+{
+  public:
+    QwOpt4048Stats()
+    {
+        reset();
+    };
+
+    /// @brief Discards all samples.
+    void reset();
+
+    /// @brief Adds a sample. Lux and CIE x and y are calculated from it.
+    /// @param color Pointer to the sample.
+    void add(const sfe_color_t *color);
+
+    /// @brief Adds a sample whose CIE values were already calculated, e.g. with calculateCIE().
+    /// @param color Pointer to the sample.
+    /// @param cie Pointer to the CIE values of the sample.
+    void add(const sfe_color_t *color, const sfe_cie_t *cie);
+
+    /// @brief Combines the samples of another accumulator into this one, as if they had all been added
+    ///        here. Used to combine sensors, or windows accumulated separately.
+    /// @param other The accumulator to merge in. It is left unchanged.
+    void merge(const QwOpt4048Stats &other);
+
+    /// @brief Retrieves the number of samples added.
+    uint32_t getCount();
+
+    /// @brief Retrieves the mean of a quantity.
+    /// @param stat The quantity.
+    /// @return The mean, 0 if no samples were added.
+    double getMean(opt4048_stat_t stat);
+
+    /// @brief Retrieves the sample variance (divided by count - 1) of a quantity.
+    /// @param stat The quantity.
+    /// @return The variance, 0 with fewer than two samples.
+    double getVariance(opt4048_stat_t stat);
+
+    /// @brief Retrieves the sample standard deviation of a quantity, the noise of a steady light.
+    /// @param stat The quantity.
+    /// @return The standard deviation, 0 with fewer than two samples.
+    double getStdDev(opt4048_stat_t stat);
+
+    /// @brief Retrieves the smallest value of a quantity.
+    /// @param stat The quantity.
+    /// @return The minimum, 0 if no samples were added.
+    double getMin(opt4048_stat_t stat);
+
+    /// @brief Retrieves the largest value of a quantity.
+    /// @param stat The quantity.
+    /// @return The maximum, 0 if no samples were added.
+    double getMax(opt4048_stat_t stat);
+
+    /// @brief Number of quantities tracked.
+    static constexpr uint8_t kNumStats = STAT_CIEY + 1;
+
+  private:
+    // Red, Green, Blue, and White come first and are integer codes.
+    static constexpr uint8_t kNumCodes = STAT_WHITE + 1;
+
+    void addValue(uint8_t stat, double value);
+    double getShift(uint8_t stat) const;
+    double getShiftDifference(uint8_t stat, const QwOpt4048Stats &other) const;
+
+    uint32_t _count;
+    uint32_t _codeShift[kNumCodes];            // First code of each channel
+    double _valueShift[kNumStats - kNumCodes]; // First lux, CIE x, and CIE y
+    double _mean[kNumStats];                   // Relative to the shift
+    double _m2[kNumStats];                     // Sum of squared differences from the mean
+    double _min[kNumStats];                    // Relative to the shift
+    double _max[kNumStats];                    // Relative to the shift
+};
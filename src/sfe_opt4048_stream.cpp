@@ -0,0 +1,202 @@
+/*
+sfe_opt4048_stream.cpp
+
+SparkFun Tristimulus Color Sensor - OPT4048
+
+Qwiic 1x1
+* https://www.sparkfun.com/products/
+Qwiic Mini
+* https://www.sparkfun.com/products/
+
+Repository:
+* https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+The MIT License (MIT)
+
+Copyright (c) 2022 SparkFun Electronics
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions: The
+above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED
+"AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+License(http://opensource.org/licenses/MIT).
+
+The following functions implement the per-channel streaming declared in
+sfe_opt4048_stream.h.
+
+*/
+#include "sfe_opt4048_stream.h"
+
+bool QwOpt4048Stream::begin(QwOpt4048 &sensor)
+{
+    _sensor = &sensor;
+    _synced = false;
+    _available = false;
+    _pending = false;
+    _missedSets = 0;
+    _syncErrors = 0;
+
+    // No set delivered yet; counters are only 4 bits wide.
+    _sample.counterR = 0xFF;
+
+    if (!_sensor->setIntMechanism(INT_DR_NEXT_CHANNEL))
+        return false;
+
+    return _sensor->setOperationMode(OPERATION_MODE_CONTINUOUS);
+}
+
+void QwOpt4048Stream::notify()
+{
+    _pending = true;
+}
+
+bool QwOpt4048Stream::service()
+{
+    if (!_pending)
+        return false;
+
+    _pending = false;
+
+    return update();
+}
+
+bool QwOpt4048Stream::update()
+{
+    uint8_t buff[4];
+    uint8_t channel;
+    uint32_t mantissa;
+    uint8_t exponent;
+    uint8_t counter;
+    uint8_t crc;
+
+    if (_sensor == nullptr)
+        return false;
+
+    if (!_synced)
+        return resync();
+
+    channel = _nextChannel;
+
+    if (_sensor->readRegisterRegion(SFE_OPT4048_REGISTER_EXP_RES_CH0 + (channel * 2), buff, 4) != 0)
+        return false;
+
+    opt4048DecodeChannel(buff, &mantissa, &exponent, &counter, &crc);
+
+    if (channel == 0)
+    {
+        // Channel Zero opens a new set, one count after the last one.
+        if (counter == _setCounter)
+        {
+            _syncErrors++;
+            return resync();
+        }
+
+        _missedSets += (counter - _setCounter - 1) & 0x0F;
+        _setCounter = counter;
+    }
+    else if (counter != _setCounter)
+    {
+        // A channel interrupt was missed, or the read came before the channel finished.
+        _syncErrors++;
+        return resync();
+    }
+
+    storeChannel(channel, _sensor->applyDarkOffset(channel, mantissa, exponent), counter, crc);
+
+    _nextChannel = (channel + 1) & 0x03;
+
+    if (channel != 3)
+        return false;
+
+    _sample = _assembly;
+    _available = true;
+
+    return true;
+}
+
+bool QwOpt4048Stream::resync()
+{
+    sfe_color_t color;
+
+    if (!_sensor->getAllChannelData(&color))
+        return false;
+
+    // Channels before the converting one belong to the set in progress; keep them.
+    _assembly = color;
+    _nextChannel = opt4048ConvertingChannel(&color);
+    _setCounter = color.counterR;
+    _synced = true;
+
+    // Channel Zero converting means all four hold the same, complete set. Don't deliver it twice.
+    bool complete = _nextChannel == 0 && color.counterR != _sample.counterR;
+
+    // Sets between the last one delivered and the one found now are lost.
+    if (_sample.counterR <= 0x0F && (complete || _nextChannel != 0))
+        _missedSets += (color.counterR - _sample.counterR - 1) & 0x0F;
+
+    if (!complete)
+        return false;
+
+    _sample = _assembly;
+    _available = true;
+
+    return true;
+}
+
+void QwOpt4048Stream::storeChannel(uint8_t channel, uint32_t code, uint8_t counter, uint8_t crc)
+{
+    switch (channel)
+    {
+    case 0:
+        _assembly.red = code;
+        _assembly.counterR = counter;
+        _assembly.CRCR = crc;
+        break;
+    case 1:
+        _assembly.green = code;
+        _assembly.counterG = counter;
+        _assembly.CRCG = crc;
+        break;
+    case 2:
+        _assembly.blue = code;
+        _assembly.counterB = counter;
+        _assembly.CRCB = crc;
+        break;
+    default:
+        _assembly.white = code;
+        _assembly.counterW = counter;
+        _assembly.CRCW = crc;
+        break;
+    }
+}
+
+bool QwOpt4048Stream::available()
+{
+    return _available;
+}
+
+void QwOpt4048Stream::getSample(sfe_color_t *color)
+{
+    *color = _sample;
+    _available = false;
+}
+
+uint32_t QwOpt4048Stream::getMissedSets()
+{
+    return _missedSets;
+}
+
+uint32_t QwOpt4048Stream::getSyncErrors()
+{
+    return _syncErrors;
+}
@@ -0,0 +1,104 @@
+/*
+sfe_opt4048_stream.h
+
+SparkFun Tristimulus Color Sensor - OPT4048
+
+Qwiic 1x1
+* https://www.sparkfun.com/products/
+Qwiic Mini
+* https://www.sparkfun.com/products/
+
+Repository:
+* https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+The MIT License (MIT)
+
+Copyright (c) 2022 SparkFun Electronics
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions: The
+above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED
+"AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+License(http://opensource.org/licenses/MIT).
+
+The following class streams OPT4048 data one channel at a time. With the
+INT_DR_NEXT_CHANNEL interrupt mechanism the INT pin asserts as each channel
+finishes, and every interrupt reads only the 4 bytes of that channel instead
+of all 16. Complete Red, Green, Blue, and White sets are assembled from the
+channel reads, and the sample counters check that no channel was skipped.
+
+*/
+#pragma once
+#include "sfe_opt4048.h"
+#include <stdint.h>
+
+class QwOpt4048Stream
+{
+  public:
+    QwOpt4048Stream()
+        : _sensor(nullptr), _nextChannel(0), _setCounter(0), _synced(false), _available(false), _pending(false),
+          _missedSets(0), _syncErrors(0) {};
+
+    /// @brief Attaches the sensor, selects the INT_DR_NEXT_CHANNEL interrupt mechanism, and starts
+    ///        continuous conversions. The conversion time and range are left as is.
+    /// @param sensor The sensor to stream from.
+    /// @return True on successful execution.
+    bool begin(QwOpt4048 &sensor);
+
+    /// @brief Marks a channel interrupt as pending. Safe to call from an ISR attached to the INT pin.
+    void notify();
+
+    /// @brief Services a pending interrupt marked with notify(). Call this from loop().
+    /// @return True when a complete set is available.
+    bool service();
+
+    /// @brief Reads the channel that is due next with one 4 byte read and adds it to the set being
+    ///        assembled. If the counters show that a channel was skipped, all channels are read once
+    ///        to find the converting channel again.
+    /// @return True when a complete set is available.
+    bool update();
+
+    /// @brief Checks if a complete set is available. Cleared by getSample().
+    /// @return True if a set was completed since the last call to getSample().
+    bool available();
+
+    /// @brief Retrieves the last complete set. All four channels carry the same counter.
+    /// @param color Pointer to the struct to be populated.
+    void getSample(sfe_color_t *color);
+
+    /// @brief Retrieves the number of whole sets that were skipped between two channel zero reads.
+    ///        Gaps of 16 sets or more can't be detected by the 4 bit counter.
+    /// @return Number of missed sets since begin().
+    uint32_t getMissedSets();
+
+    /// @brief Retrieves the number of times the stream lost track of the converting channel.
+    /// @return Number of resynchronizations since begin().
+    uint32_t getSyncErrors();
+
+  private:
+    bool resync();
+    void storeChannel(uint8_t channel, uint32_t code, uint8_t counter, uint8_t crc);
+
+    QwOpt4048 *_sensor;
+
+    sfe_color_t _assembly;
+    sfe_color_t _sample;
+    uint8_t _nextChannel;
+    uint8_t _setCounter;
+    bool _synced;
+    bool _available;
+    volatile bool _pending;
+
+    uint32_t _missedSets;
+    uint32_t _syncErrors;
+};
@@ -0,0 +1,160 @@
+/*
+sfe_opt4048_sync.cpp
+
+SparkFun Tristimulus Color Sensor - OPT4048
+
+Qwiic 1x1
+* https://www.sparkfun.com/products/
+Qwiic Mini
+* https://www.sparkfun.com/products/
+
+Repository:
+* https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+The MIT License (MIT)
+
+Copyright (c) 2022 SparkFun Electronics
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions: The
+above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED
+"AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+License(http://opensource.org/licenses/MIT).
+
+The following functions implement the synchronized capture declared in
+sfe_opt4048_sync.h.
+
+*/
+#include "sfe_opt4048_sync.h"
+
+// Width of the trigger pulse on the shared INT line.
+#define kTriggerPulseUs 10
+
+// Channel data (0x00 - 0x07) through FLAGS (0x0C): 13 registers.
+#define kSyncReadBytes ((SFE_OPT4048_REGISTER_FLAGS + 1) * 2)
+
+bool QwOpt4048SyncGroup::addSensor(QwOpt4048 &sensor)
+{
+    if (_numSensors >= kMaxSensors)
+        return false;
+
+    _sensors[_numSensors++] = &sensor;
+
+    return true;
+}
+
+bool QwOpt4048SyncGroup::begin(uint8_t triggerPin, bool activeHigh)
+{
+    _triggerPin = triggerPin;
+    _activeHigh = activeHigh;
+
+    // Every INT pin is an output until switched, so the GPIO may only drive the line once all are inputs.
+    // No sensor is armed yet, so an edge while the line floats starts nothing.
+    for (uint8_t i = 0; i < _numSensors; i++)
+    {
+        if (!_sensors[i]->setIntInput(true))
+            return false;
+    }
+
+    digitalWrite(_triggerPin, _activeHigh ? LOW : HIGH);
+    pinMode(_triggerPin, OUTPUT);
+
+    return true;
+}
+
+bool QwOpt4048SyncGroup::arm()
+{
+    bool success = true;
+
+    for (uint8_t i = 0; i < _numSensors; i++)
+    {
+        if (!_sensors[i]->setOperationMode(OPERATION_MODE_ONE_SHOT))
+            success = false;
+    }
+
+    return success;
+}
+
+void QwOpt4048SyncGroup::trigger()
+{
+    digitalWrite(_triggerPin, _activeHigh ? HIGH : LOW);
+    _triggerMicros = micros();
+    delayMicroseconds(kTriggerPulseUs);
+    digitalWrite(_triggerPin, _activeHigh ? LOW : HIGH);
+}
+
+uint8_t QwOpt4048SyncGroup::read(sfe_opt4048_sync_sample_t *samples)
+{
+    uint8_t buff[kSyncReadBytes];
+    uint32_t period = 0;
+    uint8_t numValid = 0;
+    int32_t remaining;
+    opt4048_reg_flags_t flagReg;
+
+    // The slowest sensor sets the wait, with 1/32 of its period for oscillator tolerance.
+    for (uint8_t i = 0; i < _numSensors; i++)
+    {
+        if (_sensors[i]->getSamplePeriodUs() > period)
+            period = _sensors[i]->getSamplePeriodUs();
+    }
+
+    remaining = (int32_t)(_triggerMicros + period + (period >> 5) - micros());
+
+    if (remaining > 0)
+    {
+        if (remaining >= 1000)
+            delay(remaining / 1000);
+
+        delayMicroseconds(remaining % 1000);
+    }
+
+    for (uint8_t i = 0; i < _numSensors; i++)
+    {
+        samples[i].triggerMicros = _triggerMicros;
+        samples[i].valid = false;
+
+        if (_sensors[i]->readRegisterRegion(SFE_OPT4048_REGISTER_EXP_RES_CH0, buff, kSyncReadBytes) != 0)
+            continue;
+
+        _sensors[i]->decodeImage(buff, &samples[i].color);
+
+        flagReg.word = buff[SFE_OPT4048_REGISTER_FLAGS * 2] << 8;
+        flagReg.word |= buff[SFE_OPT4048_REGISTER_FLAGS * 2 + 1];
+
+        if (flagReg.conv_ready_flag)
+        {
+            samples[i].valid = true;
+            numValid++;
+        }
+    }
+
+    return numValid;
+}
+
+uint8_t QwOpt4048SyncGroup::capture(sfe_opt4048_sync_sample_t *samples)
+{
+    arm();
+    trigger();
+
+    return read(samples);
+}
+
+uint32_t QwOpt4048SyncGroup::getTriggerMicros()
+{
+    return _triggerMicros;
+}
+
+uint8_t QwOpt4048SyncGroup::getNumSensors()
+{
+    return _numSensors;
+}
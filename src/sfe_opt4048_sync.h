@@ -0,0 +1,105 @@
+/*
+sfe_opt4048_sync.h
+
+SparkFun Tristimulus Color Sensor - OPT4048
+
+Qwiic 1x1
+* https://www.sparkfun.com/products/
+Qwiic Mini
+* https://www.sparkfun.com/products/
+
+Repository:
+* https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+The MIT License (MIT)
+
+Copyright (c) 2022 SparkFun Electronics
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions: The
+above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED
+"AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+License(http://opensource.org/licenses/MIT).
+
+The following class captures one sample from several OPT4048 sensors at the
+same instant. The INT pins of all sensors are wired to one GPIO and configured
+as trigger inputs, so a single edge starts a one-shot conversion on every
+sensor at once instead of one I2C transaction after the other. The sensors can
+share a bus (up to four addresses) or sit on different buses.
+
+*/
+#pragma once
+#include "sfe_opt4048.h"
+#include <stdint.h>
+
+/// @brief One sensor's result of a synchronized capture.
+typedef struct
+{
+    sfe_color_t color;
+    uint32_t triggerMicros; // micros() at the shared trigger edge, identical for every sensor.
+    bool valid;             // False if the sensor did not respond or its conversion was not ready.
+} sfe_opt4048_sync_sample_t;
+
+class QwOpt4048SyncGroup
+{
+  public:
+    QwOpt4048SyncGroup() : _numSensors(0), _triggerPin(0), _activeHigh(false), _triggerMicros(0) {};
+
+    /// @brief Adds a sensor to the group. The sensor must already be started with begin().
+    /// @param sensor The sensor to add. It must outlive the group.
+    /// @return True on success, false if the group is full.
+    bool addSensor(QwOpt4048 &sensor);
+
+    /// @brief Switches the INT pin of every sensor to a trigger input, then drives the trigger GPIO.
+    /// @param triggerPin The GPIO wired to the INT pins of all sensors.
+    /// @param activeHigh Drive a rising edge to trigger instead of a falling one.
+    /// @return True if every sensor was configured. On failure the GPIO is left an input, as a sensor
+    ///         may still drive the line.
+    bool begin(uint8_t triggerPin, bool activeHigh = false);
+
+    /// @brief Puts every sensor into one-shot mode so that it waits for the trigger edge. A one-shot
+    ///        returns the sensor to power down, so this is needed before each capture.
+    /// @return True if every sensor was armed.
+    bool arm();
+
+    /// @brief Fires the shared trigger edge and records its timestamp.
+    void trigger();
+
+    /// @brief Waits the predicted conversion time after the trigger, then reads every sensor with one
+    ///        burst of its channel data and flags.
+    /// @param samples Array of getNumSensors() results, in the order the sensors were added.
+    /// @return The number of sensors with a valid sample.
+    uint8_t read(sfe_opt4048_sync_sample_t *samples);
+
+    /// @brief Arms, triggers, and reads all sensors.
+    /// @param samples Array of getNumSensors() results, in the order the sensors were added.
+    /// @return The number of sensors with a valid sample.
+    uint8_t capture(sfe_opt4048_sync_sample_t *samples);
+
+    /// @brief Retrieves the time of the last trigger edge.
+    /// @return The trigger time in micros().
+    uint32_t getTriggerMicros();
+
+    /// @brief Retrieves the number of sensors in the group.
+    uint8_t getNumSensors();
+
+    /// @brief Maximum number of sensors in a group.
+    static constexpr uint8_t kMaxSensors = 8;
+
+  private:
+    QwOpt4048 *_sensors[kMaxSensors];
+    uint8_t _numSensors;
+    uint8_t _triggerPin;
+    bool _activeHigh;
+    uint32_t _triggerMicros;
+};
@@ -0,0 +1,164 @@
+/*
+sfe_opt4048_trace.cpp
+
+SparkFun Tristimulus Color Sensor - OPT4048
+
+Qwiic 1x1
+* https://www.sparkfun.com/products/
+Qwiic Mini
+* https://www.sparkfun.com/products/
+
+Repository:
+* https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+The MIT License (MIT)
+
+Copyright (c) 2022 SparkFun Electronics
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions: The
+above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED
+"AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+License(http://opensource.org/licenses/MIT).
+
+The following functions implement the bus trace recorder declared in
+sfe_opt4048_trace.h.
+
+*/
+#include "sfe_opt4048_trace.h"
+#include <string.h>
+
+// The SMBus Alert Response Address, recorded as the address of alert responses.
+#define kTraceAlertAddress 0x0C
+
+bool QwOpt4048TraceRecorder::begin(QwOpt4048 &sensor, sfe_OPT4048::QwDeviceBus &bus, Print &output)
+{
+    sfe_opt4048_trace_header_t header;
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, OPT4048_TRACE_MAGIC, sizeof(header.magic));
+    header.version = OPT4048_TRACE_VERSION;
+    header.recordSize = OPT4048_TRACE_RECORD_SIZE;
+    header.startMicros = micros();
+    header.i2cAddress = sensor.getI2CAddress();
+
+    _bus = &bus;
+    _transactions = 0;
+    _writeErrors = 0;
+    _bytesWritten = output.write((const uint8_t *)&header, sizeof(header));
+
+    sensor.setCommunicationBus(*this);
+
+    if (_bytesWritten != sizeof(header))
+        return false;
+
+    _output = &output;
+
+    return true;
+}
+
+void QwOpt4048TraceRecorder::end()
+{
+    _output = nullptr;
+}
+
+void QwOpt4048TraceRecorder::record(uint8_t type, int result, uint8_t address, uint8_t reg, const uint8_t *data,
+                                    uint16_t length, uint32_t startUs)
+{
+    sfe_opt4048_trace_record_t record;
+    uint32_t durationUs = micros() - startUs;
+    size_t expected = sizeof(record);
+    size_t written;
+
+    // Written after the transaction completed, so the output's own time isn't part of the duration.
+    record.timestampUs = startUs;
+    record.durationUs = durationUs > 0xFFFF ? 0xFFFF : durationUs;
+    record.type = type;
+    record.result = result;
+    record.address = address;
+    record.reg = reg;
+    record.length = length;
+
+    written = _output->write((const uint8_t *)&record, sizeof(record));
+
+    if (opt4048TraceHasData(&record))
+    {
+        expected += length;
+        written += _output->write(data, length);
+    }
+
+    _transactions++;
+    _bytesWritten += written;
+
+    if (written != expected)
+        _writeErrors++;
+}
+
+bool QwOpt4048TraceRecorder::ping(uint8_t address)
+{
+    uint32_t startUs = micros();
+    bool result = _bus->ping(address);
+
+    if (_output != nullptr)
+        record(OPT4048_TRACE_PING, result, address, 0, nullptr, 0, startUs);
+
+    return result;
+}
+
+int QwOpt4048TraceRecorder::writeRegisterRegion(uint8_t address, uint8_t offset, uint8_t *data, uint16_t length)
+{
+    uint32_t startUs = micros();
+    int result = _bus->writeRegisterRegion(address, offset, data, length);
+
+    if (_output != nullptr)
+        record(OPT4048_TRACE_WRITE, result, address, offset, data, length, startUs);
+
+    return result;
+}
+
+int QwOpt4048TraceRecorder::readRegisterRegion(uint8_t addr, uint8_t reg, uint8_t *data, uint16_t numBytes)
+{
+    uint32_t startUs = micros();
+    int result = _bus->readRegisterRegion(addr, reg, data, numBytes);
+
+    if (_output != nullptr)
+        record(OPT4048_TRACE_READ, result, addr, reg, data, numBytes, startUs);
+
+    return result;
+}
+
+int QwOpt4048TraceRecorder::alertResponse(uint8_t *response)
+{
+    uint32_t startUs = micros();
+    int result = _bus->alertResponse(response);
+
+    if (_output != nullptr)
+        record(OPT4048_TRACE_ALERT, result, kTraceAlertAddress, 0, response, 1, startUs);
+
+    return result;
+}
+
+uint32_t QwOpt4048TraceRecorder::getTransactions()
+{
+    return _transactions;
+}
+
+uint32_t QwOpt4048TraceRecorder::getBytesWritten()
+{
+    return _bytesWritten;
+}
+
+uint32_t QwOpt4048TraceRecorder::getWriteErrors()
+{
+    return _writeErrors;
+}
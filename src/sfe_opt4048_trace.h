@@ -0,0 +1,92 @@
+/*
+sfe_opt4048_trace.h
+
+SparkFun Tristimulus Color Sensor - OPT4048
+
+Qwiic 1x1
+* https://www.sparkfun.com/products/
+Qwiic Mini
+* https://www.sparkfun.com/products/
+
+Repository:
+* https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+The MIT License (MIT)
+
+Copyright (c) 2022 SparkFun Electronics
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions: The
+above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED
+"AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+License(http://opensource.org/licenses/MIT).
+
+The following class records the I2C traffic of an OPT4048. It sits between
+the sensor and its bus as a QwDeviceBus, forwards every transaction, and
+writes it to a Print (an SD card File, or Serial) in the binary format defined
+in sfe_opt4048_trace_format.h: address, register, bytes, result, timestamp,
+and duration. The trace can be replayed into the driver on a host with the
+tool in extras/opt4048_replay.
+
+*/
+#pragma once
+#include "sfe_bus.h"
+#include "sfe_opt4048.h"
+#include "sfe_opt4048_trace_format.h"
+#include <Arduino.h>
+#include <stdint.h>
+
+class QwOpt4048TraceRecorder : public sfe_OPT4048::QwDeviceBus
+{
+  public:
+    QwOpt4048TraceRecorder()
+        : _bus(nullptr), _output(nullptr), _transactions(0), _bytesWritten(0), _writeErrors(0) {};
+
+    /// @brief Writes the trace header and inserts the recorder between the sensor and its bus. The
+    ///        sensor's I2C address is kept.
+    /// @param sensor The sensor to record.
+    /// @param bus The bus the sensor uses, e.g. a QwI2C or a QwOpt4048Recovery.
+    /// @param output Where the trace is written.
+    /// @return True on successful execution.
+    bool begin(QwOpt4048 &sensor, sfe_OPT4048::QwDeviceBus &bus, Print &output);
+
+    /// @brief Stops recording. Transactions are still forwarded to the bus.
+    void end();
+
+    /// @brief Retrieves the number of transactions recorded.
+    uint32_t getTransactions();
+
+    /// @brief Retrieves the number of trace bytes written, including the header.
+    uint32_t getBytesWritten();
+
+    /// @brief Retrieves the number of records the output did not accept completely.
+    uint32_t getWriteErrors();
+
+    bool ping(uint8_t address);
+
+    int writeRegisterRegion(uint8_t address, uint8_t offset, uint8_t *data, uint16_t length);
+
+    int readRegisterRegion(uint8_t addr, uint8_t reg, uint8_t *data, uint16_t numBytes);
+
+    int alertResponse(uint8_t *response);
+
+  private:
+    void record(uint8_t type, int result, uint8_t address, uint8_t reg, const uint8_t *data, uint16_t length,
+                uint32_t startUs);
+
+    sfe_OPT4048::QwDeviceBus *_bus;
+    Print *_output;
+    uint32_t _transactions;
+    uint32_t _bytesWritten;
+    uint32_t _writeErrors;
+};
@@ -0,0 +1,94 @@
+/*
+sfe_opt4048_trace_format.h
+
+SparkFun Tristimulus Color Sensor - OPT4048
+
+Qwiic 1x1
+* https://www.sparkfun.com/products/
+Qwiic Mini
+* https://www.sparkfun.com/products/
+
+Repository:
+* https://github.com/sparkfun/SparkFun_OPT4048_Arduino_Library
+
+The MIT License (MIT)
+
+Copyright (c) 2022 SparkFun Electronics
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions: The
+above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED
+"AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+License(http://opensource.org/licenses/MIT).
+
+The following file defines the binary bus trace format written by
+QwOpt4048TraceRecorder. It has no Arduino dependencies so that host side tools
+can include it directly.
+
+A trace starts with a 20 byte header followed by one record per bus
+transaction. Each record is a 12 byte record header followed by its data:
+the bytes written for OPT4048_TRACE_WRITE, and the bytes read for
+OPT4048_TRACE_READ and OPT4048_TRACE_ALERT if the transaction succeeded.
+Multi-byte fields are little-endian.
+
+*/
+#pragma once
+#include <stdint.h>
+
+#define OPT4048_TRACE_MAGIC "OPT4048T"
+#define OPT4048_TRACE_VERSION 1
+#define OPT4048_TRACE_HEADER_SIZE 20
+#define OPT4048_TRACE_RECORD_SIZE 12
+
+/// @brief Transaction types of a record.
+#define OPT4048_TRACE_PING 0
+#define OPT4048_TRACE_WRITE 1
+#define OPT4048_TRACE_READ 2
+#define OPT4048_TRACE_ALERT 3
+
+/// @brief Header at the start of every trace.
+typedef struct
+{
+    char magic[8];        // OPT4048_TRACE_MAGIC, not null terminated
+    uint16_t version;     // OPT4048_TRACE_VERSION
+    uint16_t recordSize;  // OPT4048_TRACE_RECORD_SIZE
+    uint32_t startMicros; // micros() when the header was written
+    uint8_t i2cAddress;   // I2C address of the sensor
+    uint8_t reserved[3];
+
+} sfe_opt4048_trace_header_t;
+
+/// @brief One bus transaction.
+typedef struct
+{
+    uint32_t timestampUs; // micros() at the start of the transaction
+    uint16_t durationUs;  // Duration of the transaction, 65535 if longer
+    uint8_t type;         // OPT4048_TRACE_*
+    int8_t result;        // Return value of the bus call; for a ping 1 if the device answered
+    uint8_t address;      // I2C address
+    uint8_t reg;          // Register offset, 0 for pings and alerts
+    uint16_t length;      // Bytes written or requested. Data follows unless a read or alert failed
+
+} sfe_opt4048_trace_record_t;
+
+static_assert(sizeof(sfe_opt4048_trace_header_t) == OPT4048_TRACE_HEADER_SIZE, "Unexpected trace header size");
+static_assert(sizeof(sfe_opt4048_trace_record_t) == OPT4048_TRACE_RECORD_SIZE, "Unexpected trace record size");
+
+/// @brief Checks whether the data of a record follows it in the trace.
+/// @param record The record.
+/// @return True if length bytes of data follow the record.
+static inline bool opt4048TraceHasData(const sfe_opt4048_trace_record_t *record)
+{
+    return record->type == OPT4048_TRACE_WRITE ||
+           ((record->type == OPT4048_TRACE_READ || record->type == OPT4048_TRACE_ALERT) && record->result == 0);
+}